@@ -0,0 +1,294 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include <donerserializer/DonerSerializerConfig.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#ifdef DONER_SERIALIZER_HAS_SSSE3
+#include <tmmintrin.h>
+#if !defined(__GNUC__) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+namespace DonerSerializer
+{
+	// Standard base64 (RFC 4648) with padding. Blocks of 12 input bytes are encoded, and of
+	// 16 input characters decoded, with SSSE3 when the CPU has it, and the tail with lookup tables.
+	class CBase64
+	{
+	public:
+		static std::size_t GetEncodedSize(std::size_t size) { return (size + 2) / 3 * 4; }
+
+		// Upper bound, padding makes the actual size up to 2 bytes smaller
+		static std::size_t GetMaxDecodedSize(std::size_t length) { return (length + 3) / 4 * 3; }
+
+		// output needs GetEncodedSize(size) characters
+		static void Encode(const std::uint8_t* data, std::size_t size, char* output)
+		{
+			Encode(data, size, output, true);
+		}
+
+		// output needs GetMaxDecodedSize(length) bytes, and size gets the actual decoded size.
+		// Returns false on characters out of the alphabet or misplaced padding. Missing padding is accepted.
+		static bool Decode(const char* text, std::size_t length, std::uint8_t* output, std::size_t& size)
+		{
+			return Decode(text, length, output, size, true);
+		}
+
+		// Same as Encode and Decode with the lookup tables only, as a reference for the SSSE3 paths
+		static void EncodeScalar(const std::uint8_t* data, std::size_t size, char* output)
+		{
+			Encode(data, size, output, false);
+		}
+
+		static bool DecodeScalar(const char* text, std::size_t length, std::uint8_t* output, std::size_t& size)
+		{
+			return Decode(text, length, output, size, false);
+		}
+
+	private:
+		static const std::uint8_t INVALID = 0xff;
+
+		static void Encode(const std::uint8_t* data, std::size_t size, char* output, bool useSimd)
+		{
+			std::size_t index = 0;
+#ifdef DONER_SERIALIZER_HAS_SSSE3
+			if (useSimd && HasSsse3())
+			{
+				EncodeBlocks(data, size, output, index);
+			}
+#endif
+			const char* alphabet = GetAlphabet();
+			for (; index + 3 <= size; index += 3)
+			{
+				const std::uint32_t triple = (static_cast<std::uint32_t>(data[index]) << 16) | (static_cast<std::uint32_t>(data[index + 1]) << 8) | data[index + 2];
+				*output++ = alphabet[(triple >> 18) & 0x3f];
+				*output++ = alphabet[(triple >> 12) & 0x3f];
+				*output++ = alphabet[(triple >> 6) & 0x3f];
+				*output++ = alphabet[triple & 0x3f];
+			}
+
+			const std::size_t remaining = size - index;
+			if (remaining > 0)
+			{
+				const std::uint32_t triple = (static_cast<std::uint32_t>(data[index]) << 16) | (remaining == 2 ? static_cast<std::uint32_t>(data[index + 1]) << 8 : 0);
+				*output++ = alphabet[(triple >> 18) & 0x3f];
+				*output++ = alphabet[(triple >> 12) & 0x3f];
+				*output++ = (remaining == 2) ? alphabet[(triple >> 6) & 0x3f] : '=';
+				*output++ = '=';
+			}
+		}
+
+		static bool Decode(const char* text, std::size_t length, std::uint8_t* output, std::size_t& size, bool useSimd)
+		{
+			if (length > 0 && text[length - 1] == '=')
+			{
+				--length;
+				if (length > 0 && text[length - 1] == '=')
+				{
+					--length;
+				}
+			}
+			if (length % 4 == 1)
+			{
+				return false;
+			}
+
+			std::uint8_t* const begin = output;
+			std::size_t index = 0;
+#ifdef DONER_SERIALIZER_HAS_SSSE3
+			if (useSimd && HasSsse3() && !DecodeBlocks(text, length, output, index))
+			{
+				return false;
+			}
+#endif
+			const std::uint8_t* table = GetDecodeTable();
+			std::uint32_t quad = 0;
+			std::size_t pending = 0;
+			for (; index < length; ++index)
+			{
+				const std::uint8_t value = table[static_cast<std::uint8_t>(text[index])];
+				if (value == INVALID)
+				{
+					return false;
+				}
+				quad = (quad << 6) | value;
+				if (++pending == 4)
+				{
+					*output++ = static_cast<std::uint8_t>(quad >> 16);
+					*output++ = static_cast<std::uint8_t>(quad >> 8);
+					*output++ = static_cast<std::uint8_t>(quad);
+					pending = 0;
+				}
+			}
+
+			if (pending == 2)
+			{
+				*output++ = static_cast<std::uint8_t>(quad >> 4);
+			}
+			else if (pending == 3)
+			{
+				*output++ = static_cast<std::uint8_t>(quad >> 10);
+				*output++ = static_cast<std::uint8_t>(quad >> 2);
+			}
+			size = static_cast<std::size_t>(output - begin);
+			return true;
+		}
+
+		static const char* GetAlphabet() { return "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"; }
+
+		static const std::uint8_t* GetDecodeTable()
+		{
+			struct STable
+			{
+				STable()
+				{
+					std::memset(m_values, INVALID, sizeof(m_values));
+					const char* alphabet = GetAlphabet();
+					for (std::uint8_t index = 0; index < 64; ++index)
+					{
+						m_values[static_cast<std::uint8_t>(alphabet[index])] = index;
+					}
+				}
+
+				std::uint8_t m_values[256];
+			};
+			static const STable table;
+			return table.m_values;
+		}
+
+#ifdef DONER_SERIALIZER_HAS_SSSE3
+		static bool HasSsse3()
+		{
+			static const bool hasSsse3 = DetectSsse3();
+			return hasSsse3;
+		}
+
+		static bool DetectSsse3()
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("ssse3") != 0;
+#else
+			int info[4];
+			__cpuid(info, 1);
+			return (info[2] & (1 << 9)) != 0;
+#endif
+		}
+
+		// 16 bytes are loaded for every 12 encoded, so it stops when fewer are left
+		static DONER_SERIALIZER_TARGET_SSSE3 void EncodeBlocks(const std::uint8_t* data, std::size_t size, char*& output, std::size_t& index)
+		{
+			for (; index + 16 <= size; index += 12, output += 16)
+			{
+				EncodeBlock(data + index, output);
+			}
+		}
+
+		static DONER_SERIALIZER_TARGET_SSSE3 bool DecodeBlocks(const char* text, std::size_t length, std::uint8_t*& output, std::size_t& index)
+		{
+			for (; index + 16 <= length; index += 16, output += 12)
+			{
+				if (!DecodeBlock(text + index, output))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		// 12 bytes, out of the 16 loaded, into 16 characters
+		static DONER_SERIALIZER_TARGET_SSSE3 void EncodeBlock(const std::uint8_t* data, char* output)
+		{
+			__m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+			// Each 32 bits lane gets 3 input bytes, arranged so the multiplications below
+			// move each sextet to its own byte
+			input = _mm_shuffle_epi8(input, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+			const __m128i t0 = _mm_and_si128(input, _mm_set1_epi32(0x0fc0fc00));
+			const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+			const __m128i t2 = _mm_and_si128(input, _mm_set1_epi32(0x003f03f0));
+			const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+			const __m128i indices = _mm_or_si128(t1, t3);
+
+			// Offset from each sextet to its character: 0..25 use index 13, 26..51 index 0,
+			// 52..61 indices 1..10, 62 index 11 and 63 index 12
+			__m128i offsetIndices = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+			const __m128i isUpper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+			offsetIndices = _mm_or_si128(offsetIndices, _mm_and_si128(isUpper, _mm_set1_epi8(13)));
+			const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+			const __m128i characters = _mm_add_epi8(_mm_shuffle_epi8(offsets, offsetIndices), indices);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(output), characters);
+		}
+
+		static DONER_SERIALIZER_TARGET_SSSE3 __m128i InRange(__m128i input, char first, char last)
+		{
+			return _mm_and_si128(_mm_cmpgt_epi8(input, _mm_set1_epi8(static_cast<char>(first - 1))), _mm_cmplt_epi8(input, _mm_set1_epi8(static_cast<char>(last + 1))));
+		}
+
+		// 16 characters into 12 bytes. Returns false if any character is out of the alphabet.
+		static DONER_SERIALIZER_TARGET_SSSE3 bool DecodeBlock(const char* text, std::uint8_t* output)
+		{
+			const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text));
+			const __m128i upper = InRange(input, 'A', 'Z');
+			const __m128i lower = InRange(input, 'a', 'z');
+			const __m128i digit = InRange(input, '0', '9');
+			const __m128i plus = _mm_cmpeq_epi8(input, _mm_set1_epi8('+'));
+			const __m128i slash = _mm_cmpeq_epi8(input, _mm_set1_epi8('/'));
+
+			const __m128i valid = _mm_or_si128(_mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, plus)), slash);
+			if (_mm_movemask_epi8(valid) != 0xffff)
+			{
+				return false;
+			}
+
+			__m128i offsets = _mm_and_si128(upper, _mm_set1_epi8(-'A'));
+			offsets = _mm_or_si128(offsets, _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+			offsets = _mm_or_si128(offsets, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+			offsets = _mm_or_si128(offsets, _mm_and_si128(plus, _mm_set1_epi8(62 - '+')));
+			offsets = _mm_or_si128(offsets, _mm_and_si128(slash, _mm_set1_epi8(63 - '/')));
+			const __m128i sextets = _mm_add_epi8(input, offsets);
+
+			// Merges pairs of sextets into 12 bits, then pairs of those into 24 bits per lane
+			const __m128i pairs = _mm_maddubs_epi16(sextets, _mm_set1_epi32(0x01400140));
+			const __m128i triples = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+			const __m128i bytes = _mm_shuffle_epi8(triples, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+			std::uint8_t block[16];
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(block), bytes);
+			std::memcpy(output, block, 12);
+			return true;
+		}
+#endif
+	};
+}
@@ -0,0 +1,151 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <ostream>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace DonerSerializer
+{
+	// rapidjson output stream that fills a caller provided buffer and hands it to Sink
+	// every time it's full. Sink is a functor bool(const char* data, std::size_t size);
+	// once it fails the remaining output is dropped and HasFailed() returns true.
+	template<class Sink>
+	class CBufferedWriteStream
+	{
+	public:
+		typedef char Ch;
+
+		CBufferedWriteStream(Sink sink, char* buffer, std::size_t bufferSize)
+			: m_sink(sink)
+			, m_begin(buffer)
+			, m_end(buffer + bufferSize)
+			, m_current(buffer)
+			, m_failed(false)
+		{}
+
+		void Put(char c)
+		{
+			if (m_current >= m_end)
+			{
+				Flush();
+			}
+			*m_current++ = c;
+		}
+
+		void Flush()
+		{
+			if (m_current != m_begin)
+			{
+				if (!m_failed && !m_sink(m_begin, static_cast<std::size_t>(m_current - m_begin)))
+				{
+					m_failed = true;
+				}
+				m_current = m_begin;
+			}
+		}
+
+		bool HasFailed() const { return m_failed; }
+
+	private:
+		Sink m_sink;
+		char* m_begin;
+		char* m_end;
+		char* m_current;
+		bool m_failed;
+	};
+
+	class CFileSink
+	{
+	public:
+		explicit CFileSink(std::FILE* file) : m_file(file) {}
+
+		bool operator()(const char* data, std::size_t size) const
+		{
+			return std::fwrite(data, 1, size, m_file) == size;
+		}
+
+	private:
+		std::FILE* m_file;
+	};
+
+	class CFileDescriptorSink
+	{
+	public:
+		explicit CFileDescriptorSink(int fileDescriptor) : m_fileDescriptor(fileDescriptor) {}
+
+		bool operator()(const char* data, std::size_t size) const
+		{
+			while (size > 0)
+			{
+#ifdef _WIN32
+				const int written = _write(m_fileDescriptor, data, static_cast<unsigned int>(size));
+#else
+				const ssize_t written = write(m_fileDescriptor, data, size);
+#endif
+				if (written < 0)
+				{
+					if (errno == EINTR)
+					{
+						continue;
+					}
+					return false;
+				}
+				data += written;
+				size -= static_cast<std::size_t>(written);
+			}
+			return true;
+		}
+
+	private:
+		int m_fileDescriptor;
+	};
+
+	class COStreamSink
+	{
+	public:
+		explicit COStreamSink(std::ostream& stream) : m_stream(&stream) {}
+
+		bool operator()(const char* data, std::size_t size) const
+		{
+			return static_cast<bool>(m_stream->write(data, static_cast<std::streamsize>(size)));
+		}
+
+	private:
+		std::ostream* m_stream;
+	};
+}
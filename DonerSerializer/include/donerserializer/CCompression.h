@@ -0,0 +1,225 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace DonerSerializer
+{
+	// Compression stages are duck typed, like sinks:
+	// - Compressors have template<class Sink> bool Compress(const char* data, std::size_t size, Sink& sink),
+	//   which may keep data buffered, and template<class Sink> bool Finish(Sink& sink), which writes the
+	//   rest and leaves the compressor ready for a new stream.
+	// - Decompressors have template<class Source> bool Decompress(Source& source, char* output, std::size_t capacity, std::size_t& size),
+	//   which sets size to 0 once the stream ends and returns false on corrupt or truncated input, and
+	//   void Reset(), which drops the rest of the current stream.
+	// Sources are functors std::size_t(char* buffer, std::size_t size) returning how many bytes they read, 0 at the end.
+	class CCompression
+	{
+	public:
+		static const std::size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+		// Compresses a whole buffer, like a saved CBinaryArchive, into sink
+		template<class Compressor, class Sink>
+		static bool Compress(Compressor& compressor, const void* data, std::size_t size, Sink sink)
+		{
+			const bool success = compressor.Compress(static_cast<const char*>(data), size, sink);
+			return compressor.Finish(sink) && success;
+		}
+
+		// Decompresses a whole stream into output, replacing its contents
+		template<class Decompressor, class Source, class T>
+		static bool Decompress(Decompressor& decompressor, Source source, std::vector<T>& output)
+		{
+			static_assert(sizeof(T) == 1, "Decompress needs a byte vector");
+			decompressor.Reset();
+			output.clear();
+			std::size_t size = 0;
+			do
+			{
+				const std::size_t first = output.size();
+				output.resize(first + DEFAULT_BUFFER_SIZE);
+				if (!decompressor.Decompress(source, reinterpret_cast<char*>(output.data() + first), DEFAULT_BUFFER_SIZE, size))
+				{
+					output.clear();
+					return false;
+				}
+				output.resize(first + size);
+			} while (size > 0);
+			return true;
+		}
+	};
+
+	// Sink adapter, for CBufferedWriteStream and the like, that compresses what it receives before
+	// handing it to Sink. Finish() has to be called once the output is complete.
+	template<class Compressor, class Sink>
+	class CCompressingSink
+	{
+	public:
+		CCompressingSink(Compressor& compressor, Sink& sink)
+			: m_compressor(&compressor)
+			, m_sink(&sink)
+		{}
+
+		bool operator()(const char* data, std::size_t size) const
+		{
+			return m_compressor->Compress(data, size, *m_sink);
+		}
+
+		bool Finish() const
+		{
+			return m_compressor->Finish(*m_sink);
+		}
+
+	private:
+		Compressor* m_compressor;
+		Sink* m_sink;
+	};
+
+	class CMemorySource
+	{
+	public:
+		CMemorySource(const char* data, std::size_t size)
+			: m_current(data)
+			, m_remaining(size)
+		{}
+
+		std::size_t operator()(char* buffer, std::size_t size)
+		{
+			size = (size < m_remaining) ? size : m_remaining;
+			if (size > 0)
+			{
+				std::memcpy(buffer, m_current, size);
+				m_current += size;
+				m_remaining -= size;
+			}
+			return size;
+		}
+
+	private:
+		const char* m_current;
+		std::size_t m_remaining;
+	};
+
+	class CFileSource
+	{
+	public:
+		explicit CFileSource(std::FILE* file) : m_file(file) {}
+
+		std::size_t operator()(char* buffer, std::size_t size) const
+		{
+			return std::fread(buffer, 1, size, m_file);
+		}
+
+	private:
+		std::FILE* m_file;
+	};
+
+	// rapidjson input stream that decompresses Source a bufferSize chunk at a time, so the
+	// uncompressed text is never held in memory as a whole. Decompression errors end the
+	// stream early and make HasFailed() return true.
+	template<class Decompressor, class Source>
+	class CDecompressingReadStream
+	{
+	public:
+		typedef char Ch;
+
+		CDecompressingReadStream(Decompressor& decompressor, Source source, std::size_t bufferSize = CCompression::DEFAULT_BUFFER_SIZE)
+			: m_decompressor(decompressor)
+			, m_source(source)
+			, m_buffer(bufferSize > 0 ? bufferSize : 1)
+			, m_current(m_buffer.data())
+			, m_end(m_buffer.data())
+			, m_consumed(0)
+			, m_ended(false)
+			, m_failed(false)
+		{
+			m_decompressor.Reset();
+			Refill();
+		}
+
+		Ch Peek() const { return (m_current != m_end) ? *m_current : '\0'; }
+
+		Ch Take()
+		{
+			if (m_current == m_end)
+			{
+				return '\0';
+			}
+			const Ch c = *m_current++;
+			if (m_current == m_end)
+			{
+				Refill();
+			}
+			return c;
+		}
+
+		std::size_t Tell() const { return m_consumed + static_cast<std::size_t>(m_current - m_buffer.data()); }
+
+		bool HasFailed() const { return m_failed; }
+
+		// Not used by rapidjson::Reader for non in-situ parsing
+		Ch* PutBegin() { return nullptr; }
+		void Put(Ch) {}
+		void Flush() {}
+		std::size_t PutEnd(Ch*) { return 0; }
+
+	private:
+		void Refill()
+		{
+			m_consumed += static_cast<std::size_t>(m_end - m_buffer.data());
+			m_current = m_end = m_buffer.data();
+			if (m_ended)
+			{
+				return;
+			}
+
+			std::size_t size = 0;
+			if (!m_decompressor.Decompress(m_source, m_buffer.data(), m_buffer.size(), size))
+			{
+				m_failed = true;
+				size = 0;
+			}
+			m_ended = (size == 0);
+			m_end = m_buffer.data() + size;
+		}
+
+		Decompressor& m_decompressor;
+		Source m_source;
+		std::vector<char> m_buffer;
+		char* m_current;
+		char* m_end;
+		std::size_t m_consumed;
+		bool m_ended;
+		bool m_failed;
+	};
+}
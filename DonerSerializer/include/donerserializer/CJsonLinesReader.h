@@ -0,0 +1,207 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include <donerserializer/DonerSerializerConfig.h>
+#include <donerserializer/CPooledJsonDocument.h>
+#include <donerserializer/DonerDeserialize.h>
+#include <donerserializer/ISerializable.h>
+
+#include <donerreflection/DonerReflection.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace DonerSerializer
+{
+	// Resets the reflected members of a record so it can be deserialized again. Strings and
+	// containers are cleared, keeping their capacity, nested ISerializable objects are reset
+	// member by member and everything else is assigned a value initialized instance.
+	class CRecordResetter
+	{
+	public:
+		template<class T>
+		static void Reset(T& object)
+		{
+			// The macro needs at least one parameter for the resolver
+			APPLY_RESOLVER_WITH_PARAMS_TO_OBJECT(object, CRecordResetter, 0)
+		}
+
+		template<typename MainClassType, typename MemberType>
+		static void Apply(const DonerReflection::SProperty<MainClassType, MemberType>& property, MainClassType& object, int)
+		{
+			ResetMember(object.*(property.m_member), 0);
+		}
+
+	private:
+		template<class T>
+		static auto ResetMember(T& value, int) -> decltype(value.clear(), void())
+		{
+			value.clear();
+		}
+
+		template<class T>
+		static void ResetMember(T& value, long)
+		{
+			ResetValue(value, std::is_base_of<ISerializable, T>());
+		}
+
+		template<class T>
+		static void ResetValue(T& value, std::true_type)
+		{
+			Reset(value);
+		}
+
+		template<class T>
+		static void ResetValue(T& value, std::false_type)
+		{
+			value = T();
+		}
+	};
+
+	// Reads JSON Lines (one JSON object per line) into a T that's reused for every record,
+	// calling callback(T& record) for each one. Lines are parsed by the same pooled
+	// CJsonDeserializer, and the record is reset with CRecordResetter before every line, so once
+	// warmed up its strings and containers don't allocate either. Members that aren't reflected
+	// keep their values. The callback returns false to stop reading.
+	// Empty lines are ignored. Malformed ones are skipped and counted, and make Read() return false.
+	template<class T>
+	class CJsonLinesReader
+	{
+	public:
+		static const std::size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+		explicit CJsonLinesReader(std::size_t capacity = CPooledJsonDocument::DEFAULT_CAPACITY,
+			std::size_t stackCapacity = CPooledJsonDocument::DEFAULT_STACK_CAPACITY)
+			: m_deserializer(capacity, stackCapacity)
+			, m_failedLines(0)
+			, m_stopped(false)
+		{}
+
+		template<class Callback>
+		bool Read(const char* data, std::size_t length, Callback callback)
+		{
+			Begin();
+			ReadLines(data, length, callback, true);
+			return m_failedLines == 0;
+		}
+
+		// For inputs that can't be mapped, like pipes. Lines longer than bufferSize grow the buffer.
+		template<class Callback>
+		bool Read(std::FILE* file, Callback callback, std::size_t bufferSize = DEFAULT_BUFFER_SIZE)
+		{
+			Begin();
+			std::vector<char> buffer(bufferSize > 0 ? bufferSize : 1);
+			std::size_t filled = 0;
+			while (!m_stopped)
+			{
+				if (filled == buffer.size())
+				{
+					buffer.resize(buffer.size() * 2);
+				}
+
+				const std::size_t read = std::fread(buffer.data() + filled, 1, buffer.size() - filled, file);
+				filled += read;
+				const bool isLast = (read == 0);
+
+				const std::size_t consumed = ReadLines(buffer.data(), filled, callback, isLast);
+				std::memmove(buffer.data(), buffer.data() + consumed, filled - consumed);
+				filled -= consumed;
+
+				if (isLast)
+				{
+					break;
+				}
+			}
+			return !std::ferror(file) && m_failedLines == 0;
+		}
+
+		std::size_t GetFailedLines() const { return m_failedLines; }
+
+	private:
+		void Begin()
+		{
+			m_failedLines = 0;
+			m_stopped = false;
+		}
+
+		// Returns the bytes consumed. Unless isLast, a trailing line without '\n' is left for the next call.
+		template<class Callback>
+		std::size_t ReadLines(const char* data, std::size_t length, Callback& callback, bool isLast)
+		{
+			const char* begin = data;
+			const char* const end = data + length;
+			while (begin < end && !m_stopped)
+			{
+				const char* newline = static_cast<const char*>(std::memchr(begin, '\n', static_cast<std::size_t>(end - begin)));
+				if (newline == nullptr && !isLast)
+				{
+					break;
+				}
+
+				const char* const lineEnd = (newline != nullptr) ? newline : end;
+				ReadLine(begin, static_cast<std::size_t>(lineEnd - begin), callback);
+				begin = (newline != nullptr) ? newline + 1 : end;
+			}
+			return static_cast<std::size_t>(begin - data);
+		}
+
+		template<class Callback>
+		void ReadLine(const char* line, std::size_t length, Callback& callback)
+		{
+			if (length > 0 && line[length - 1] == '\r')
+			{
+				--length;
+			}
+			if (length == 0)
+			{
+				return;
+			}
+
+			if (!m_deserializer.Parse(line, length))
+			{
+				++m_failedLines;
+				return;
+			}
+
+			CRecordResetter::Reset(m_record);
+			m_deserializer.Deserialize(m_record);
+			m_stopped = !callback(m_record);
+		}
+
+		CJsonDeserializer m_deserializer;
+		T m_record;
+		std::size_t m_failedLines;
+		bool m_stopped;
+	};
+}
@@ -0,0 +1,139 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include <donerserializer/DonerSerializerConfig.h>
+#include <donerserializer/CBufferedWriteStream.h>
+#include <donerserializer/DonerStreamSerialize.h>
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <cstddef>
+#include <functional>
+
+namespace DonerSerializer
+{
+	// Writes records as JSON Lines (one JSON object per line). Every record is streamed into
+	// the same buffer by the same writer, so a batch costs no allocations once the buffer has grown.
+	// Without a sink the buffer just keeps growing. With a sink (CFileSink, CFileDescriptorSink,
+	// COStreamSink or any bool(const char*, std::size_t) functor) the buffer is handed over
+	// whenever it holds flushBytes bytes or flushRecords records (0 disables that threshold),
+	// on Flush() and on destruction.
+	template<class T>
+	class CJsonLinesWriter
+	{
+	public:
+		using TSink = std::function<bool(const char*, std::size_t)>;
+
+		static const std::size_t DEFAULT_FLUSH_BYTES = 64 * 1024;
+
+		CJsonLinesWriter()
+			: CJsonLinesWriter(TSink(), 0, 0)
+		{}
+
+		explicit CJsonLinesWriter(TSink sink, std::size_t flushBytes = DEFAULT_FLUSH_BYTES, std::size_t flushRecords = 0)
+			: m_sink(sink)
+			, m_writer(m_buffer)
+			, m_flushBytes(flushBytes)
+			, m_flushRecords(flushRecords)
+			, m_pendingRecords(0)
+			, m_failed(false)
+		{}
+
+		CJsonLinesWriter(const CJsonLinesWriter&) = delete;
+		CJsonLinesWriter& operator=(const CJsonLinesWriter&) = delete;
+
+		~CJsonLinesWriter()
+		{
+			Flush();
+		}
+
+		bool Write(const T& record)
+		{
+			m_writer.Reset(m_buffer);
+			CJsonStreamSerializer::Serialize(record, m_writer);
+			m_buffer.Put('\n');
+			++m_pendingRecords;
+
+			if ((m_flushBytes > 0 && m_buffer.GetSize() >= m_flushBytes) || (m_flushRecords > 0 && m_pendingRecords >= m_flushRecords))
+			{
+				Flush();
+			}
+			return !m_failed;
+		}
+
+		template<class Iterator>
+		bool Write(Iterator begin, Iterator end)
+		{
+			for (; begin != end; ++begin)
+			{
+				Write(*begin);
+			}
+			return !m_failed;
+		}
+
+		// Hands the buffered lines to the sink. Does nothing if there's no sink.
+		bool Flush()
+		{
+			if (m_sink && m_buffer.GetSize() > 0)
+			{
+				if (!m_failed && !m_sink(m_buffer.GetString(), m_buffer.GetSize()))
+				{
+					m_failed = true;
+				}
+				m_buffer.Clear();
+				m_pendingRecords = 0;
+			}
+			return !m_failed;
+		}
+
+		// Lines not flushed yet
+		const char* GetData() const { return m_buffer.GetString(); }
+		std::size_t GetSize() const { return m_buffer.GetSize(); }
+
+		// Drops the lines not flushed yet, keeping the buffer capacity
+		void Clear()
+		{
+			m_buffer.Clear();
+			m_pendingRecords = 0;
+		}
+
+		bool HasFailed() const { return m_failed; }
+
+	private:
+		TSink m_sink;
+		rapidjson::StringBuffer m_buffer;
+		rapidjson::Writer<rapidjson::StringBuffer> m_writer;
+		std::size_t m_flushBytes;
+		std::size_t m_flushRecords;
+		std::size_t m_pendingRecords;
+		bool m_failed;
+	};
+}
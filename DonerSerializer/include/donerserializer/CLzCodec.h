@@ -0,0 +1,394 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace DonerSerializer
+{
+	// Dependency free LZ77 codec, in the spirit of LZ4: it trades ratio for speed and works on
+	// independent blocks of up to BLOCK_SIZE bytes, so memory usage doesn't depend on the stream size.
+	//
+	// Stream: "DSLZ", then blocks made of their uncompressed and stored sizes (little endian uint32)
+	// followed by the stored bytes, and an empty block at the end. Blocks that don't shrink are stored raw.
+	// Compressed blocks are sequences of a token (literal count in the high nibble, match length - 4 in
+	// the low one, 15 meaning more bytes follow, each adding up to 255), the literals, and a little endian
+	// uint16 match offset. The last sequence has literals only.
+	class CLzCodec
+	{
+	public:
+		static const std::size_t BLOCK_SIZE = 64 * 1024;
+		static const std::size_t HEADER_SIZE = 8;
+		static const std::size_t MAGIC_SIZE = 4;
+
+		static const char* GetMagic() { return "DSLZ"; }
+
+		static std::size_t GetMaxCompressedSize(std::size_t size) { return size + size / 255 + 16; }
+
+		// Writes the compressed block into output, which needs GetMaxCompressedSize(size) bytes, and returns its size
+		static std::size_t CompressBlock(const std::uint8_t* data, std::size_t size, std::uint8_t* output, std::vector<std::int32_t>& table)
+		{
+			table.assign(HASH_SIZE, -1);
+			std::uint8_t* const outputBegin = output;
+			std::size_t anchor = 0;
+			std::size_t index = 0;
+			while (index + MIN_MATCH <= size)
+			{
+				const std::uint32_t sequence = Read32(data + index);
+				std::int32_t& entry = table[Hash(sequence)];
+				const std::size_t candidate = static_cast<std::size_t>(entry);
+				const bool isMatch = entry >= 0 && index - candidate <= MAX_OFFSET && Read32(data + candidate) == sequence;
+				entry = static_cast<std::int32_t>(index);
+				if (!isMatch)
+				{
+					// Incompressible stretches are skipped faster the longer they get
+					index += 1 + ((index - anchor) >> 6);
+					continue;
+				}
+
+				std::size_t length = MIN_MATCH;
+				while (index + length < size && data[candidate + length] == data[index + length])
+				{
+					++length;
+				}
+				output = WriteSequence(output, data + anchor, index - anchor, length - MIN_MATCH);
+				*output++ = static_cast<std::uint8_t>(index - candidate);
+				*output++ = static_cast<std::uint8_t>((index - candidate) >> 8);
+				output = WriteLength(output, length - MIN_MATCH);
+				index += length;
+				anchor = index;
+			}
+			output = WriteSequence(output, data + anchor, size - anchor, 0);
+			return static_cast<std::size_t>(output - outputBegin);
+		}
+
+		// Fails unless data decompresses to exactly size bytes
+		static bool DecompressBlock(const std::uint8_t* data, std::size_t dataSize, std::uint8_t* output, std::size_t size)
+		{
+			const std::uint8_t* const dataEnd = data + dataSize;
+			std::size_t written = 0;
+			while (data != dataEnd)
+			{
+				const std::uint8_t token = *data++;
+				std::size_t literals = token >> 4;
+				if (literals == 15 && !ReadLength(data, dataEnd, literals))
+				{
+					return false;
+				}
+				if (literals > static_cast<std::size_t>(dataEnd - data) || literals > size - written)
+				{
+					return false;
+				}
+				std::memcpy(output + written, data, literals);
+				data += literals;
+				written += literals;
+				if (data == dataEnd)
+				{
+					break;
+				}
+
+				if (dataEnd - data < 2)
+				{
+					return false;
+				}
+				const std::size_t offset = static_cast<std::size_t>(data[0]) | (static_cast<std::size_t>(data[1]) << 8);
+				data += 2;
+				std::size_t length = token & 0x0f;
+				if (length == 15 && !ReadLength(data, dataEnd, length))
+				{
+					return false;
+				}
+				length += MIN_MATCH;
+				if (offset == 0 || offset > written || length > size - written)
+				{
+					return false;
+				}
+				// Byte by byte, as matches may overlap the bytes they produce
+				const std::uint8_t* match = output + written - offset;
+				for (std::size_t index = 0; index < length; ++index)
+				{
+					output[written + index] = match[index];
+				}
+				written += length;
+			}
+			return written == size;
+		}
+
+	private:
+		static const std::size_t MIN_MATCH = 4;
+		static const std::size_t MAX_OFFSET = 65535;
+		static const unsigned HASH_BITS = 14;
+		static const std::size_t HASH_SIZE = std::size_t(1) << HASH_BITS;
+
+		static std::uint32_t Read32(const std::uint8_t* data)
+		{
+			std::uint32_t value;
+			std::memcpy(&value, data, sizeof(value));
+			return value;
+		}
+
+		static std::size_t Hash(std::uint32_t sequence)
+		{
+			return (sequence * 2654435761U) >> (32 - HASH_BITS);
+		}
+
+		static std::uint8_t* WriteLength(std::uint8_t* output, std::size_t length)
+		{
+			if (length >= 15)
+			{
+				for (length -= 15; length >= 255; length -= 255)
+				{
+					*output++ = 255;
+				}
+				*output++ = static_cast<std::uint8_t>(length);
+			}
+			return output;
+		}
+
+		static std::uint8_t* WriteSequence(std::uint8_t* output, const std::uint8_t* literals, std::size_t literalCount, std::size_t matchLength)
+		{
+			const std::size_t literalNibble = literalCount < 15 ? literalCount : 15;
+			const std::size_t matchNibble = matchLength < 15 ? matchLength : 15;
+			*output++ = static_cast<std::uint8_t>((literalNibble << 4) | matchNibble);
+			output = WriteLength(output, literalCount);
+			std::memcpy(output, literals, literalCount);
+			return output + literalCount;
+		}
+
+		static bool ReadLength(const std::uint8_t*& data, const std::uint8_t* dataEnd, std::size_t& length)
+		{
+			std::uint8_t value = 255;
+			while (value == 255)
+			{
+				if (data == dataEnd)
+				{
+					return false;
+				}
+				value = *data++;
+				length += value;
+			}
+			return true;
+		}
+	};
+
+	class CLzCompressor
+	{
+	public:
+		CLzCompressor()
+			: m_started(false)
+		{
+			m_block.reserve(CLzCodec::BLOCK_SIZE);
+		}
+
+		template<class Sink>
+		bool Compress(const char* data, std::size_t size, Sink& sink)
+		{
+			bool success = true;
+			while (size > 0)
+			{
+				const std::size_t count = std::min(size, CLzCodec::BLOCK_SIZE - m_block.size());
+				m_block.insert(m_block.end(), data, data + count);
+				data += count;
+				size -= count;
+				if (m_block.size() == CLzCodec::BLOCK_SIZE)
+				{
+					success = WriteBlock(sink) && success;
+				}
+			}
+			return success;
+		}
+
+		template<class Sink>
+		bool Finish(Sink& sink)
+		{
+			const bool success = (m_block.empty() || WriteBlock(sink)) && WriteHeader(sink, 0, 0);
+			m_started = false;
+			return success;
+		}
+
+	private:
+		template<class Sink>
+		bool WriteHeader(Sink& sink, std::size_t size, std::size_t storedSize)
+		{
+			bool success = true;
+			if (!m_started)
+			{
+				m_started = true;
+				success = sink(CLzCodec::GetMagic(), CLzCodec::MAGIC_SIZE);
+			}
+			char header[CLzCodec::HEADER_SIZE];
+			for (std::size_t index = 0; index < 4; ++index)
+			{
+				header[index] = static_cast<char>(size >> (8 * index));
+				header[4 + index] = static_cast<char>(storedSize >> (8 * index));
+			}
+			return sink(header, sizeof(header)) && success;
+		}
+
+		template<class Sink>
+		bool WriteBlock(Sink& sink)
+		{
+			m_compressed.resize(CLzCodec::GetMaxCompressedSize(m_block.size()));
+			const std::size_t compressedSize = CLzCodec::CompressBlock(m_block.data(), m_block.size(), m_compressed.data(), m_table);
+			const bool isStored = compressedSize >= m_block.size();
+			const std::uint8_t* stored = isStored ? m_block.data() : m_compressed.data();
+			const std::size_t storedSize = isStored ? m_block.size() : compressedSize;
+
+			const bool success = WriteHeader(sink, m_block.size(), storedSize) && sink(reinterpret_cast<const char*>(stored), storedSize);
+			m_block.clear();
+			return success;
+		}
+
+		std::vector<std::uint8_t> m_block;
+		std::vector<std::uint8_t> m_compressed;
+		std::vector<std::int32_t> m_table;
+		bool m_started;
+	};
+
+	class CLzDecompressor
+	{
+	public:
+		CLzDecompressor()
+			: m_position(0)
+			, m_state(EState::Start)
+		{}
+
+		template<class Source>
+		bool Decompress(Source& source, char* output, std::size_t capacity, std::size_t& size)
+		{
+			size = 0;
+			while (size < capacity && m_state != EState::End)
+			{
+				if (m_position == m_block.size() && !ReadBlock(source))
+				{
+					m_state = EState::Start;
+					return false;
+				}
+
+				const std::size_t count = std::min(capacity - size, m_block.size() - m_position);
+				std::memcpy(output + size, m_block.data() + m_position, count);
+				m_position += count;
+				size += count;
+			}
+			// Ready for another stream once this one is over
+			if (size == 0)
+			{
+				m_state = EState::Start;
+			}
+			return true;
+		}
+
+		void Reset()
+		{
+			m_block.clear();
+			m_position = 0;
+			m_state = EState::Start;
+		}
+
+	private:
+		enum class EState
+		{
+			Start,
+			Blocks,
+			End
+		};
+
+		template<class Source>
+		static bool ReadAll(Source& source, void* buffer, std::size_t size)
+		{
+			char* output = static_cast<char*>(buffer);
+			while (size > 0)
+			{
+				const std::size_t count = source(output, size);
+				if (count == 0)
+				{
+					return false;
+				}
+				output += count;
+				size -= count;
+			}
+			return true;
+		}
+
+		template<class Source>
+		bool ReadBlock(Source& source)
+		{
+			m_block.clear();
+			m_position = 0;
+			if (m_state == EState::Start)
+			{
+				char magic[CLzCodec::MAGIC_SIZE];
+				if (!ReadAll(source, magic, sizeof(magic)) || std::memcmp(magic, CLzCodec::GetMagic(), sizeof(magic)) != 0)
+				{
+					return false;
+				}
+				m_state = EState::Blocks;
+			}
+
+			std::uint8_t header[CLzCodec::HEADER_SIZE];
+			if (!ReadAll(source, header, sizeof(header)))
+			{
+				return false;
+			}
+			std::size_t size = 0;
+			std::size_t storedSize = 0;
+			for (std::size_t index = 0; index < 4; ++index)
+			{
+				size |= static_cast<std::size_t>(header[index]) << (8 * index);
+				storedSize |= static_cast<std::size_t>(header[4 + index]) << (8 * index);
+			}
+			if (size == 0)
+			{
+				m_state = EState::End;
+				return storedSize == 0;
+			}
+			if (size > CLzCodec::BLOCK_SIZE || storedSize > size)
+			{
+				return false;
+			}
+
+			m_block.resize(size);
+			if (storedSize == size)
+			{
+				return ReadAll(source, m_block.data(), size);
+			}
+			m_compressed.resize(storedSize);
+			return ReadAll(source, m_compressed.data(), storedSize) && CLzCodec::DecompressBlock(m_compressed.data(), storedSize, m_block.data(), size);
+		}
+
+		std::vector<std::uint8_t> m_block;
+		std::vector<std::uint8_t> m_compressed;
+		std::size_t m_position;
+		EState m_state;
+	};
+}
@@ -0,0 +1,158 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include <cstddef>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace DonerSerializer
+{
+	// Read-only view of a whole file mapped in memory. The OS pages it in on demand,
+	// so the contents are never copied into an intermediate buffer.
+	class CMappedFile
+	{
+	public:
+		explicit CMappedFile(const char* path)
+			: m_data(nullptr)
+			, m_size(0)
+			, m_isOpen(false)
+		{
+			Open(path);
+		}
+
+		~CMappedFile()
+		{
+			Close();
+		}
+
+		CMappedFile(const CMappedFile&) = delete;
+		CMappedFile& operator=(const CMappedFile&) = delete;
+
+		bool IsOpen() const { return m_isOpen; }
+		const char* GetData() const { return m_data; }
+		std::size_t GetSize() const { return m_size; }
+
+	private:
+#ifdef _WIN32
+		void Open(const char* path)
+		{
+			HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if (file == INVALID_HANDLE_VALUE)
+			{
+				return;
+			}
+
+			LARGE_INTEGER size;
+			if (GetFileSizeEx(file, &size))
+			{
+				m_size = static_cast<std::size_t>(size.QuadPart);
+				if (m_size == 0)
+				{
+					m_isOpen = true;
+				}
+				else
+				{
+					HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+					if (mapping != nullptr)
+					{
+						m_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+						m_isOpen = (m_data != nullptr);
+						CloseHandle(mapping);
+					}
+				}
+			}
+			CloseHandle(file);
+		}
+
+		void Close()
+		{
+			if (m_data != nullptr)
+			{
+				UnmapViewOfFile(m_data);
+			}
+		}
+#else
+		void Open(const char* path)
+		{
+			const int file = open(path, O_RDONLY);
+			if (file < 0)
+			{
+				return;
+			}
+
+			struct stat status;
+			if (fstat(file, &status) == 0)
+			{
+				m_size = static_cast<std::size_t>(status.st_size);
+				if (m_size == 0)
+				{
+					m_isOpen = true;
+				}
+				else
+				{
+					void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+					if (data != MAP_FAILED)
+					{
+						madvise(data, m_size, MADV_SEQUENTIAL);
+						m_data = static_cast<const char*>(data);
+						m_isOpen = true;
+					}
+				}
+			}
+			close(file);
+		}
+
+		void Close()
+		{
+			if (m_data != nullptr)
+			{
+				munmap(const_cast<char*>(m_data), m_size);
+			}
+		}
+#endif
+
+		const char* m_data;
+		std::size_t m_size;
+		bool m_isOpen;
+	};
+}
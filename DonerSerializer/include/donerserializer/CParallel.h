@@ -0,0 +1,116 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace DonerSerializer
+{
+	class CParallel
+	{
+	public:
+		// 0 means one thread per hardware thread
+		static std::size_t GetThreadCount(std::size_t requestedThreadCount)
+		{
+			if (requestedThreadCount > 0)
+			{
+				return requestedThreadCount;
+			}
+			const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+			return hardwareThreads > 0 ? hardwareThreads : 1;
+		}
+
+		// Calls task(index, workerIndex) for every index in [0, count) from up to threadCount
+		// threads, the calling one included. Workers grab the next index as they finish the
+		// previous one, in increasing order. workerIndex is in [0, threadCount), so it can be
+		// used to pick per-thread state. The first exception thrown by a task is rethrown here
+		// once every worker has stopped.
+		template<class Task>
+		static void For(std::size_t count, std::size_t threadCount, Task task)
+		{
+			threadCount = std::min(GetThreadCount(threadCount), count);
+			if (threadCount <= 1)
+			{
+				for (std::size_t index = 0; index < count; ++index)
+				{
+					task(index, 0);
+				}
+				return;
+			}
+
+			std::atomic<std::size_t> nextIndex(0);
+			std::exception_ptr exception;
+			std::mutex exceptionMutex;
+
+			auto worker = [&](std::size_t workerIndex)
+			{
+				try
+				{
+					for (std::size_t index = nextIndex++; index < count; index = nextIndex++)
+					{
+						task(index, workerIndex);
+					}
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> lock(exceptionMutex);
+					if (!exception)
+					{
+						exception = std::current_exception();
+					}
+					nextIndex = count;
+				}
+			};
+
+			std::vector<std::thread> threads;
+			threads.reserve(threadCount - 1);
+			for (std::size_t workerIndex = 1; workerIndex < threadCount; ++workerIndex)
+			{
+				threads.emplace_back(worker, workerIndex);
+			}
+			worker(0);
+
+			for (std::thread& thread : threads)
+			{
+				thread.join();
+			}
+
+			if (exception)
+			{
+				std::rethrow_exception(exception);
+			}
+		}
+	};
+}
@@ -0,0 +1,225 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include <donerserializer/DonerSerializerConfig.h>
+#include <donerserializer/CJsonLinesReader.h>
+#include <donerserializer/CParallel.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace DonerSerializer
+{
+	// Splits JSON Lines input into newline aligned chunks of about chunkSize bytes and parses
+	// them on up to threadCount threads (0 means one per hardware thread). Every worker has its
+	// own CJsonLinesReader, kept across calls, so pools stay warm.
+	// - EOrder::Ordered: each chunk collects its records, and chunks are delivered in input order
+	//   as soon as all the previous ones are done. The callback is never called concurrently.
+	//   Workers don't run more than REORDER_CHUNKS_PER_THREAD chunks per thread ahead of the next
+	//   one to deliver, which bounds the records kept in memory.
+	// - EOrder::Unordered: the worker that parsed a record calls callback(T&) right away, so the
+	//   callback must be thread safe.
+	// The callback returns false to stop reading, although records being parsed by other
+	// workers at that moment may still be delivered when unordered.
+	template<class T>
+	class CParallelJsonLinesReader
+	{
+	public:
+		enum class EOrder
+		{
+			Ordered,
+			Unordered
+		};
+
+		static const std::size_t DEFAULT_CHUNK_SIZE = 1024 * 1024;
+		static const std::size_t REORDER_CHUNKS_PER_THREAD = 4;
+
+		explicit CParallelJsonLinesReader(std::size_t threadCount = 0, std::size_t chunkSize = DEFAULT_CHUNK_SIZE)
+			: m_readers(CParallel::GetThreadCount(threadCount))
+			, m_chunkSize(chunkSize > 0 ? chunkSize : 1)
+			, m_failedLines(0)
+		{
+			for (std::unique_ptr<CJsonLinesReader<T>>& reader : m_readers)
+			{
+				reader.reset(new CJsonLinesReader<T>());
+			}
+		}
+
+		template<class Callback>
+		bool Read(const char* data, std::size_t length, Callback callback, EOrder order = EOrder::Ordered)
+		{
+			std::vector<std::pair<const char*, std::size_t>> chunks;
+			Split(data, length, chunks);
+
+			std::atomic<std::size_t> failedLines(0);
+			if (order == EOrder::Ordered)
+			{
+				ReadOrdered(chunks, callback, failedLines);
+			}
+			else
+			{
+				ReadUnordered(chunks, callback, failedLines);
+			}
+
+			m_failedLines = failedLines;
+			return m_failedLines == 0;
+		}
+
+		std::size_t GetFailedLines() const { return m_failedLines; }
+
+	private:
+		using TChunks = std::vector<std::pair<const char*, std::size_t>>;
+
+		void Split(const char* data, std::size_t length, TChunks& chunks) const
+		{
+			std::size_t begin = 0;
+			while (begin < length)
+			{
+				std::size_t end = length;
+				if (length - begin > m_chunkSize)
+				{
+					const char* newline = static_cast<const char*>(std::memchr(data + begin + m_chunkSize, '\n', length - begin - m_chunkSize));
+					if (newline != nullptr)
+					{
+						end = static_cast<std::size_t>(newline - data) + 1;
+					}
+				}
+				chunks.emplace_back(data + begin, end - begin);
+				begin = end;
+			}
+		}
+
+		template<class Callback>
+		void ReadUnordered(const TChunks& chunks, Callback& callback, std::atomic<std::size_t>& failedLines)
+		{
+			std::atomic<bool> stopped(false);
+			auto onRecord = [&callback, &stopped](T& record)
+			{
+				if (!stopped && !callback(record))
+				{
+					stopped = true;
+				}
+				return !stopped;
+			};
+
+			CParallel::For(chunks.size(), m_readers.size(), [&](std::size_t chunkIndex, std::size_t workerIndex)
+			{
+				if (!stopped)
+				{
+					CJsonLinesReader<T>& reader = *m_readers[workerIndex];
+					reader.Read(chunks[chunkIndex].first, chunks[chunkIndex].second, onRecord);
+					failedLines += reader.GetFailedLines();
+				}
+			});
+		}
+
+		// Chunks are handed out in increasing order, but while the next one to deliver is being parsed
+		// the other workers keep taking later ones. So a worker waits before parsing a chunk that is a
+		// whole reorder window ahead of the next one to deliver. That one was handed out before, so it's
+		// always being parsed, and only a window of chunks keeps records, in a ring of reused buffers.
+		template<class Callback>
+		void ReadOrdered(const TChunks& chunks, Callback& callback, std::atomic<std::size_t>& failedLines)
+		{
+			const std::size_t window = m_readers.size() * REORDER_CHUNKS_PER_THREAD;
+			std::vector<std::vector<T>> records(std::min(window, chunks.size()));
+			std::vector<bool> done(records.size(), false);
+			std::size_t nextToDeliver = 0;
+			std::mutex deliveryMutex;
+			std::condition_variable deliveredCondition;
+			std::atomic<bool> stopped(false);
+
+			CParallel::For(chunks.size(), m_readers.size(), [&](std::size_t chunkIndex, std::size_t workerIndex)
+			{
+				{
+					std::unique_lock<std::mutex> lock(deliveryMutex);
+					deliveredCondition.wait(lock, [&]() { return stopped || chunkIndex - nextToDeliver < window; });
+				}
+				if (stopped)
+				{
+					return;
+				}
+
+				try
+				{
+					std::vector<T>& chunkRecords = records[chunkIndex % records.size()];
+					CJsonLinesReader<T>& reader = *m_readers[workerIndex];
+					reader.Read(chunks[chunkIndex].first, chunks[chunkIndex].second, [&chunkRecords](T& record)
+					{
+						chunkRecords.push_back(std::move(record));
+						return true;
+					});
+					failedLines += reader.GetFailedLines();
+
+					{
+						std::lock_guard<std::mutex> lock(deliveryMutex);
+						done[chunkIndex % records.size()] = true;
+						while (nextToDeliver < chunks.size() && done[nextToDeliver % records.size()] && !stopped)
+						{
+							const std::size_t slot = nextToDeliver % records.size();
+							for (T& record : records[slot])
+							{
+								if (!callback(record))
+								{
+									stopped = true;
+									break;
+								}
+							}
+							records[slot].clear();
+							done[slot] = false;
+							++nextToDeliver;
+						}
+					}
+					deliveredCondition.notify_all();
+				}
+				catch (...)
+				{
+					// Nobody would deliver the chunks the other workers are waiting for
+					{
+						std::lock_guard<std::mutex> lock(deliveryMutex);
+						stopped = true;
+					}
+					deliveredCondition.notify_all();
+					throw;
+				}
+			});
+		}
+
+		std::vector<std::unique_ptr<CJsonLinesReader<T>>> m_readers;
+		std::size_t m_chunkSize;
+		std::size_t m_failedLines;
+	};
+}
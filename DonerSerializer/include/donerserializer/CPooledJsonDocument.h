@@ -0,0 +1,114 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include <rapidjson/allocators.h>
+#include <rapidjson/document.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace DonerSerializer
+{
+	// rapidjson::Document whose values and parse stack are allocated from buffers owned by
+	// this object. Reset() drops the contents but keeps the buffers, and grows them whenever
+	// the previous use didn't fit, so once warmed up a reused document doesn't touch the heap.
+	class CPooledJsonDocument
+	{
+	public:
+		using TAllocator = rapidjson::MemoryPoolAllocator<>;
+		using TDocument = rapidjson::GenericDocument<rapidjson::UTF8<>, TAllocator, TAllocator>;
+
+		static const std::size_t DEFAULT_CAPACITY = 64 * 1024;
+		static const std::size_t DEFAULT_STACK_CAPACITY = 16 * 1024;
+
+		explicit CPooledJsonDocument(std::size_t capacity = DEFAULT_CAPACITY, std::size_t stackCapacity = DEFAULT_STACK_CAPACITY)
+			: m_buffer(capacity < MIN_CAPACITY ? MIN_CAPACITY : capacity)
+			, m_stackBuffer(stackCapacity < MIN_CAPACITY ? MIN_CAPACITY : stackCapacity)
+		{
+			Create();
+		}
+
+		CPooledJsonDocument(const CPooledJsonDocument&) = delete;
+		CPooledJsonDocument& operator=(const CPooledJsonDocument&) = delete;
+
+		TDocument& GetDocument() { return *m_document; }
+		const TDocument& GetDocument() const { return *m_document; }
+
+		// Bytes currently reserved for values and parse stack
+		std::size_t GetCapacity() const { return m_buffer.size() + m_stackBuffer.size(); }
+
+		void Reset()
+		{
+			const std::size_t capacity = m_allocator->Capacity();
+			const std::size_t stackCapacity = m_stackAllocator->Capacity();
+			if (capacity > m_buffer.size() || stackCapacity > m_stackBuffer.size())
+			{
+				m_document.reset();
+				m_allocator.reset();
+				m_stackAllocator.reset();
+				Grow(m_buffer, capacity);
+				Grow(m_stackBuffer, stackCapacity);
+				Create();
+			}
+			else
+			{
+				m_document->SetNull();
+				m_allocator->Clear();
+				m_stackAllocator->Clear();
+			}
+		}
+
+	private:
+		static const std::size_t MIN_CAPACITY = 1024;
+
+		static void Grow(std::vector<char>& buffer, std::size_t usedCapacity)
+		{
+			if (usedCapacity > buffer.size())
+			{
+				std::vector<char>(std::max(usedCapacity + usedCapacity / 2, buffer.size() * 2)).swap(buffer);
+			}
+		}
+
+		void Create()
+		{
+			m_allocator.reset(new TAllocator(m_buffer.data(), m_buffer.size()));
+			m_stackAllocator.reset(new TAllocator(m_stackBuffer.data(), m_stackBuffer.size()));
+			m_document.reset(new TDocument(m_allocator.get(), m_stackBuffer.size() / 4, m_stackAllocator.get()));
+		}
+
+		std::vector<char> m_buffer;
+		std::vector<char> m_stackBuffer;
+		std::unique_ptr<TAllocator> m_allocator;
+		std::unique_ptr<TAllocator> m_stackAllocator;
+		std::unique_ptr<TDocument> m_document;
+	};
+}
@@ -0,0 +1,226 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+// DONER_SERIALIZER_HAS_ZLIB is defined by the CMake project when it finds zlib
+#ifdef DONER_SERIALIZER_HAS_ZLIB
+
+#include <cstddef>
+#include <vector>
+
+#include <zlib.h>
+
+namespace DonerSerializer
+{
+	enum class EZlibFormat
+	{
+		Zlib,
+		Gzip
+	};
+
+	// Deflate compressor writing zlib (RFC 1950) or gzip (RFC 1952) streams
+	class CZlibCompressor
+	{
+	public:
+		explicit CZlibCompressor(int level = Z_DEFAULT_COMPRESSION, EZlibFormat format = EZlibFormat::Gzip)
+			: m_buffer(BUFFER_SIZE)
+		{
+			m_stream = z_stream();
+			m_isValid = deflateInit2(&m_stream, level, Z_DEFLATED, (format == EZlibFormat::Gzip) ? 15 + 16 : 15, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+		}
+
+		~CZlibCompressor()
+		{
+			if (m_isValid)
+			{
+				deflateEnd(&m_stream);
+			}
+		}
+
+		CZlibCompressor(const CZlibCompressor&) = delete;
+		CZlibCompressor& operator=(const CZlibCompressor&) = delete;
+
+		template<class Sink>
+		bool Compress(const char* data, std::size_t size, Sink& sink)
+		{
+			bool success = m_isValid;
+			while (success && size > 0)
+			{
+				// avail_in is 32 bits wide
+				const uInt count = static_cast<uInt>(size < MAX_CHUNK_SIZE ? size : MAX_CHUNK_SIZE);
+				m_stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+				m_stream.avail_in = count;
+				success = Deflate(Z_NO_FLUSH, sink);
+				data += count;
+				size -= count;
+			}
+			return success;
+		}
+
+		template<class Sink>
+		bool Finish(Sink& sink)
+		{
+			if (!m_isValid)
+			{
+				return false;
+			}
+			m_stream.next_in = nullptr;
+			m_stream.avail_in = 0;
+			const bool success = Deflate(Z_FINISH, sink);
+			deflateReset(&m_stream);
+			return success;
+		}
+
+	private:
+		static const std::size_t BUFFER_SIZE = 64 * 1024;
+		static const std::size_t MAX_CHUNK_SIZE = 1U << 30;
+
+		template<class Sink>
+		bool Deflate(int flush, Sink& sink)
+		{
+			bool success = true;
+			int result = Z_OK;
+			do
+			{
+				m_stream.next_out = m_buffer.data();
+				m_stream.avail_out = static_cast<uInt>(m_buffer.size());
+				result = deflate(&m_stream, flush);
+				if (result == Z_STREAM_ERROR)
+				{
+					return false;
+				}
+				const std::size_t produced = m_buffer.size() - m_stream.avail_out;
+				success = (produced == 0 || sink(reinterpret_cast<const char*>(m_buffer.data()), produced)) && success;
+			} while (m_stream.avail_out == 0 || (flush == Z_FINISH && result != Z_STREAM_END));
+			return success;
+		}
+
+		z_stream m_stream;
+		std::vector<Bytef> m_buffer;
+		bool m_isValid;
+	};
+
+	// Inflates zlib and gzip streams, detecting which one it gets
+	class CZlibDecompressor
+	{
+	public:
+		CZlibDecompressor()
+			: m_input(BUFFER_SIZE)
+			, m_ended(false)
+		{
+			m_stream = z_stream();
+			m_isValid = inflateInit2(&m_stream, 15 + 32) == Z_OK;
+		}
+
+		~CZlibDecompressor()
+		{
+			if (m_isValid)
+			{
+				inflateEnd(&m_stream);
+			}
+		}
+
+		CZlibDecompressor(const CZlibDecompressor&) = delete;
+		CZlibDecompressor& operator=(const CZlibDecompressor&) = delete;
+
+		template<class Source>
+		bool Decompress(Source& source, char* output, std::size_t capacity, std::size_t& size)
+		{
+			size = 0;
+			if (!m_isValid)
+			{
+				return false;
+			}
+			if (m_ended)
+			{
+				// Ready for another stream once this one is over
+				Reset();
+				return true;
+			}
+
+			m_stream.next_out = reinterpret_cast<Bytef*>(output);
+			m_stream.avail_out = static_cast<uInt>(capacity < MAX_CHUNK_SIZE ? capacity : MAX_CHUNK_SIZE);
+			const uInt available = m_stream.avail_out;
+			while (m_stream.avail_out == available)
+			{
+				if (m_stream.avail_in == 0)
+				{
+					const std::size_t count = source(reinterpret_cast<char*>(m_input.data()), m_input.size());
+					if (count == 0)
+					{
+						// Truncated stream
+						Reset();
+						return false;
+					}
+					m_stream.next_in = m_input.data();
+					m_stream.avail_in = static_cast<uInt>(count);
+				}
+
+				const int result = inflate(&m_stream, Z_NO_FLUSH);
+				if (result == Z_STREAM_END)
+				{
+					m_ended = true;
+					break;
+				}
+				if (result != Z_OK)
+				{
+					Reset();
+					return false;
+				}
+			}
+			size = available - m_stream.avail_out;
+			if (m_ended && size == 0)
+			{
+				Reset();
+			}
+			return true;
+		}
+
+		void Reset()
+		{
+			if (m_isValid)
+			{
+				inflateReset(&m_stream);
+			}
+			m_stream.avail_in = 0;
+			m_ended = false;
+		}
+
+	private:
+		static const std::size_t BUFFER_SIZE = 64 * 1024;
+		static const std::size_t MAX_CHUNK_SIZE = 1U << 30;
+
+		z_stream m_stream;
+		std::vector<Bytef> m_input;
+		bool m_ended;
+		bool m_isValid;
+	};
+}
+
+#endif
@@ -0,0 +1,781 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include <donerserializer/DonerSerializerConfig.h>
+#include <donerserializer/DonerContainerTraits.h>
+#include <donerserializer/DonerColumnar.h>
+#include <donerserializer/DonerDeserialize.h>
+#include <donerserializer/ISerializable.h>
+
+#include <donerreflection/DonerReflection.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef DONER_SERIALIZER_HAS_STRING_VIEW
+#include <string_view>
+#endif
+
+namespace DonerSerializer
+{
+	// Appends raw native bytes and LEB128 sizes to a byte buffer
+	class CBinaryWriter
+	{
+	public:
+		explicit CBinaryWriter(std::vector<std::uint8_t>& output)
+			: m_output(output)
+		{}
+
+		void Write(const void* data, std::size_t size)
+		{
+			const std::uint8_t* bytes = static_cast<const std::uint8_t*>(data);
+			m_output.insert(m_output.end(), bytes, bytes + size);
+		}
+
+		void WriteSize(std::uint64_t size)
+		{
+			while (size >= 0x80)
+			{
+				m_output.push_back(static_cast<std::uint8_t>(size | 0x80));
+				size >>= 7;
+			}
+			m_output.push_back(static_cast<std::uint8_t>(size));
+		}
+
+	private:
+		std::vector<std::uint8_t>& m_output;
+	};
+
+	// Reads what CBinaryWriter wrote. Truncated or invalid input marks the reader as failed,
+	// and from then on every read fails.
+	class CBinaryReader
+	{
+	public:
+		CBinaryReader(const std::uint8_t* data, std::size_t size)
+			: m_current(data)
+			, m_end(data + size)
+			, m_failed(false)
+		{}
+
+		bool Read(void* data, std::size_t size)
+		{
+			if (m_failed || GetRemaining() < size)
+			{
+				return Fail();
+			}
+			std::memcpy(data, m_current, size);
+			m_current += size;
+			return true;
+		}
+
+		bool ReadSize(std::uint64_t& size)
+		{
+			size = 0;
+			for (std::uint32_t shift = 0; shift < 64 && !m_failed && m_current != m_end; shift += 7)
+			{
+				const std::uint8_t byte = *m_current++;
+				size |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+				if ((byte & 0x80) == 0)
+				{
+					return true;
+				}
+			}
+			return Fail();
+		}
+
+		// Element count of a container whose elements take at least minElementSize bytes each.
+		// Counts that can't fit in the remaining input fail, so they are never allocated.
+		bool ReadCount(std::size_t& count, std::size_t minElementSize)
+		{
+			std::uint64_t size = 0;
+			if (!ReadSize(size) || (minElementSize > 0 && size > GetRemaining() / minElementSize))
+			{
+				return Fail();
+			}
+			count = static_cast<std::size_t>(size);
+			return true;
+		}
+
+		const char* Skip(std::size_t size)
+		{
+			if (m_failed || GetRemaining() < size)
+			{
+				Fail();
+				return nullptr;
+			}
+			const char* data = reinterpret_cast<const char*>(m_current);
+			m_current += size;
+			return data;
+		}
+
+		bool HasFailed() const { return m_failed; }
+		bool IsAtEnd() const { return m_current == m_end; }
+
+	private:
+		std::size_t GetRemaining() const { return static_cast<std::size_t>(m_end - m_current); }
+
+		bool Fail()
+		{
+			m_failed = true;
+			m_current = m_end;
+			return false;
+		}
+
+		const std::uint8_t* m_current;
+		const std::uint8_t* m_end;
+		bool m_failed;
+	};
+
+	// 64 bits FNV-1a
+	class CSchemaHash
+	{
+	public:
+		CSchemaHash()
+			: m_value(14695981039346656037ULL)
+		{}
+
+		void Mix(const void* data, std::size_t size)
+		{
+			const std::uint8_t* bytes = static_cast<const std::uint8_t*>(data);
+			for (std::size_t index = 0; index < size; ++index)
+			{
+				m_value = (m_value ^ bytes[index]) * 1099511628211ULL;
+			}
+		}
+
+		void Mix(std::uint64_t value) { Mix(&value, sizeof(value)); }
+		void Mix(const char* text) { Mix(text, std::strlen(text) + 1); }
+
+		std::uint64_t GetValue() const { return m_value; }
+
+	private:
+		std::uint64_t m_value;
+	};
+
+	template<class T>
+	class CBinaryArchiveLayout;
+
+	// Fields are written positionally, in memory order, without names. Arithmetic types other than
+	// bool, and enums, are copied as raw native bytes, and so are std::vectors of them.
+	class CBinaryArchiveResolver
+	{
+	public:
+		// Tag used by CBinaryArchiveResolverType default implementation.
+		// Members whose type resolver derives from it aren't part of the archive.
+		class CUnsupportedType
+		{};
+
+		// Types stored with a plain memcpy
+		template<class T>
+		using IsBitwise = std::integral_constant<bool, (std::is_arithmetic<T>::value && !std::is_same<T, bool>::value) || std::is_enum<T>::value>;
+
+		// Types already being hashed, so recursive types hash a back reference instead of looping
+		struct SSchemaChain
+		{
+			const void* m_type;
+			const SSchemaChain* m_parent;
+		};
+
+		template <class T, class Enable = void>
+		class CBinaryArchiveResolverType : public CUnsupportedType
+		{
+		public:
+			static void Write(const T& value, CBinaryWriter& writer) {}
+			static void Read(T& value, CBinaryReader& reader) {}
+			static void MixSignature(CSchemaHash& hash, const SSchemaChain* chain) {}
+		};
+
+		template<class T>
+		using IsUnsupported = std::is_base_of<CUnsupportedType, CBinaryArchiveResolverType<T>>;
+
+		// Names and types of the archived members of T in memory order, recursively
+		template<class T>
+		static void MixObjectSignature(CSchemaHash& hash, const SSchemaChain* chain)
+		{
+			std::uint64_t depth = 0;
+			for (const SSchemaChain* link = chain; link != nullptr; link = link->m_parent, ++depth)
+			{
+				if (link->m_type == GetTypeId<T>())
+				{
+					hash.Mix("recursive");
+					hash.Mix(depth);
+					return;
+				}
+			}
+
+			const T object{};
+			const SSchemaChain link{ GetTypeId<T>(), chain };
+			std::vector<SMemberSignature> members;
+			APPLY_RESOLVER_WITH_PARAMS_TO_CONST_OBJECT(object, CSignatureBuilder, members, &link)
+			std::stable_sort(members.begin(), members.end(), [](const SMemberSignature& lhs, const SMemberSignature& rhs) { return lhs.m_offset < rhs.m_offset; });
+
+			hash.Mix("object");
+			hash.Mix(static_cast<std::uint64_t>(members.size()));
+			for (const SMemberSignature& member : members)
+			{
+				hash.Mix(member.m_name);
+				hash.Mix(member.m_signature);
+			}
+		}
+
+		template<class T>
+		static std::size_t GetOffset(const T& object, const void* member)
+		{
+			return static_cast<std::size_t>(static_cast<const char*>(member) - reinterpret_cast<const char*>(&object));
+		}
+
+	private:
+		template<class T>
+		static const void* GetTypeId()
+		{
+			static const char id = 0;
+			return &id;
+		}
+
+		struct SMemberSignature
+		{
+			std::size_t m_offset;
+			const char* m_name;
+			std::uint64_t m_signature;
+		};
+
+		class CSignatureBuilder
+		{
+		public:
+			template<typename MainClassType, typename MemberType>
+			static void Apply(const DonerReflection::SProperty<MainClassType, MemberType>& property, const MainClassType& object, std::vector<SMemberSignature>& members, const SSchemaChain* chain)
+			{
+				if (!IsUnsupported<MemberType>::value)
+				{
+					CSchemaHash hash;
+					CBinaryArchiveResolverType<MemberType>::MixSignature(hash, chain);
+					members.push_back(SMemberSignature{ GetOffset(object, &(object.*(property.m_member))), property.m_name, hash.GetValue() });
+				}
+			}
+		};
+	};
+
+	template <class T>
+	class CBinaryArchiveResolver::CBinaryArchiveResolverType<T, typename std::enable_if<CBinaryArchiveResolver::IsBitwise<T>::value>::type>
+	{
+	public:
+		static void Write(const T& value, CBinaryWriter& writer) { writer.Write(&value, sizeof(T)); }
+		static void Read(T& value, CBinaryReader& reader) { reader.Read(&value, sizeof(T)); }
+
+		static void MixSignature(CSchemaHash& hash, const SSchemaChain* chain)
+		{
+			hash.Mix(std::is_floating_point<T>::value ? "float" : "integer");
+			hash.Mix(static_cast<std::uint64_t>(sizeof(T)));
+			hash.Mix(static_cast<std::uint64_t>(std::is_signed<T>::value));
+		}
+	};
+
+	template <>
+	class CBinaryArchiveResolver::CBinaryArchiveResolverType<bool>
+	{
+	public:
+		static void Write(const bool& value, CBinaryWriter& writer)
+		{
+			const std::uint8_t byte = value ? 1 : 0;
+			writer.Write(&byte, 1);
+		}
+
+		static void Read(bool& value, CBinaryReader& reader)
+		{
+			std::uint8_t byte = 0;
+			if (reader.Read(&byte, 1))
+			{
+				value = (byte != 0);
+			}
+		}
+
+		static void MixSignature(CSchemaHash& hash, const SSchemaChain* chain) { hash.Mix("bool"); }
+	};
+
+	template <>
+	class CBinaryArchiveResolver::CBinaryArchiveResolverType<std::string>
+	{
+	public:
+		static void Write(const std::string& value, CBinaryWriter& writer)
+		{
+			writer.WriteSize(value.size());
+			writer.Write(value.data(), value.size());
+		}
+
+		static void Read(std::string& value, CBinaryReader& reader)
+		{
+			std::size_t size = 0;
+			if (reader.ReadCount(size, 1))
+			{
+				value.assign(reader.Skip(size), size);
+			}
+		}
+
+		static void MixSignature(CSchemaHash& hash, const SSchemaChain* chain) { hash.Mix("string"); }
+	};
+
+#ifdef DONER_SERIALIZER_HAS_STRING_VIEW
+	// Points into the input buffer, which needs to outlive the view
+	template <>
+	class CBinaryArchiveResolver::CBinaryArchiveResolverType<std::string_view>
+	{
+	public:
+		static void Write(const std::string_view& value, CBinaryWriter& writer)
+		{
+			writer.WriteSize(value.size());
+			writer.Write(value.data(), value.size());
+		}
+
+		static void Read(std::string_view& value, CBinaryReader& reader)
+		{
+			std::size_t size = 0;
+			if (reader.ReadCount(size, 1))
+			{
+				value = std::string_view(reader.Skip(size), size);
+			}
+		}
+
+		static void MixSignature(CSchemaHash& hash, const SSchemaChain* chain) { hash.Mix("string"); }
+	};
+#endif
+
+	// Loading replaces the previous content of the container
+	template<template<typename, typename> class TT, typename T1, typename T2>
+	class CBinaryArchiveResolver::CBinaryArchiveResolverType<TT<T1, T2>, typename std::enable_if<!SIsMap<TT<T1, T2>>::value>::type>
+	{
+	public:
+		static void Write(const TT<T1, T2>& value, CBinaryWriter& writer)
+		{
+			writer.WriteSize(value.size());
+			Write(value, writer, IsContiguousBitwise(), SSerializeAsColumns<T1>());
+		}
+
+		static void Read(TT<T1, T2>& value, CBinaryReader& reader)
+		{
+			value.clear();
+			Read(value, reader, IsContiguousBitwise(), SSerializeAsColumns<T1>());
+		}
+
+		static void MixSignature(CSchemaHash& hash, const SSchemaChain* chain)
+		{
+			hash.Mix(SSerializeAsColumns<T1>::value ? "columns" : "sequence");
+			CBinaryArchiveResolver::CBinaryArchiveResolverType<T1>::MixSignature(hash, chain);
+		}
+
+	private:
+		using IsContiguousBitwise = std::integral_constant<bool, std::is_same<TT<T1, T2>, std::vector<T1, T2>>::value && CBinaryArchiveResolver::IsBitwise<T1>::value>;
+
+		template<class IsColumnar>
+		static void Write(const TT<T1, T2>& value, CBinaryWriter& writer, std::true_type, IsColumnar)
+		{
+			writer.Write(value.data(), value.size() * sizeof(T1));
+		}
+
+		static void Write(const TT<T1, T2>& value, CBinaryWriter& writer, std::false_type, std::false_type)
+		{
+			for (const auto& member : value)
+			{
+				CBinaryArchiveResolver::CBinaryArchiveResolverType<T1>::Write(member, writer);
+			}
+		}
+
+		// Member by member, following the layout of T1, so each bitwise member of every element ends up contiguous
+		static void Write(const TT<T1, T2>& value, CBinaryWriter& writer, std::false_type, std::true_type)
+		{
+			for (const auto& step : CBinaryArchiveLayout<T1>::Get().GetMemberSteps())
+			{
+				for (const auto& member : value)
+				{
+					const char* base = reinterpret_cast<const char*>(&member);
+					if (step.m_write != nullptr)
+					{
+						step.m_write(base + step.m_offset, writer);
+					}
+					else
+					{
+						writer.Write(base + step.m_offset, step.m_size);
+					}
+				}
+			}
+		}
+
+		static void Read(TT<T1, T2>& value, CBinaryReader& reader, std::false_type, std::true_type)
+		{
+			// Steps through functions take one byte at least, which bounds the size of each element.
+			// Elements without steps are still counted as one byte, so counts stay capped.
+			const auto& steps = CBinaryArchiveLayout<T1>::Get().GetMemberSteps();
+			std::size_t elementSize = 0;
+			for (const auto& step : steps)
+			{
+				elementSize += (step.m_read != nullptr) ? 1 : step.m_size;
+			}
+
+			std::size_t count = 0;
+			if (!reader.ReadCount(count, elementSize > 0 ? elementSize : 1))
+			{
+				return;
+			}
+			value.resize(count);
+			for (auto step = steps.begin(); step != steps.end() && !reader.HasFailed(); ++step)
+			{
+				for (auto& member : value)
+				{
+					char* base = reinterpret_cast<char*>(&member);
+					if (step->m_read != nullptr)
+					{
+						step->m_read(base + step->m_offset, reader);
+					}
+					else
+					{
+						reader.Read(base + step->m_offset, step->m_size);
+					}
+				}
+			}
+		}
+
+		template<class IsColumnar>
+		static void Read(TT<T1, T2>& value, CBinaryReader& reader, std::true_type, IsColumnar)
+		{
+			std::size_t count = 0;
+			if (reader.ReadCount(count, sizeof(T1)))
+			{
+				value.resize(count);
+				reader.Read(value.data(), count * sizeof(T1));
+			}
+		}
+
+		static void Read(TT<T1, T2>& value, CBinaryReader& reader, std::false_type, std::false_type)
+		{
+			// Elements may take no bytes at all, like reflected classes without members, so count isn't capped
+			std::uint64_t count = 0;
+			if (!reader.ReadSize(count))
+			{
+				return;
+			}
+			for (std::uint64_t index = 0; index < count && !reader.HasFailed(); ++index)
+			{
+				AddElement(value, reader, CContainerHelper::CanFillInPlace<TT<T1, T2>>());
+			}
+		}
+
+		static void AddElement(TT<T1, T2>& value, CBinaryReader& reader, std::true_type)
+		{
+			value.emplace_back();
+			CBinaryArchiveResolver::CBinaryArchiveResolverType<T1>::Read(value.back(), reader);
+		}
+
+		static void AddElement(TT<T1, T2>& value, CBinaryReader& reader, std::false_type)
+		{
+			T1 element = T1();
+			CBinaryArchiveResolver::CBinaryArchiveResolverType<T1>::Read(element, reader);
+			value.push_back(std::move(element));
+		}
+	};
+
+	// Loading replaces the previous content of the map
+	template <template <typename, typename, typename...> class TT, typename T1, typename T2, typename... Args>
+	class CBinaryArchiveResolver::CBinaryArchiveResolverType<TT<T1, T2, Args...>, typename std::enable_if<SIsMap<TT<T1, T2, Args...>>::value>::type>
+	{
+	public:
+		static void Write(const TT<T1, T2, Args...>& value, CBinaryWriter& writer)
+		{
+			writer.WriteSize(value.size());
+			for (const auto& val : value)
+			{
+				CBinaryArchiveResolver::CBinaryArchiveResolverType<T1>::Write(val.first, writer);
+				CBinaryArchiveResolver::CBinaryArchiveResolverType<T2>::Write(val.second, writer);
+			}
+		}
+
+		static void Read(TT<T1, T2, Args...>& map, CBinaryReader& reader)
+		{
+			map.clear();
+			std::uint64_t count = 0;
+			if (!reader.ReadSize(count))
+			{
+				return;
+			}
+			for (std::uint64_t index = 0; index < count && !reader.HasFailed(); ++index)
+			{
+				T1 key = T1();
+				CBinaryArchiveResolver::CBinaryArchiveResolverType<T1>::Read(key, reader);
+
+				auto it = map.find(key);
+				if (it == map.end())
+				{
+					it = map.emplace(std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple()).first;
+				}
+				else
+				{
+					it->second = T2();
+				}
+				CBinaryArchiveResolver::CBinaryArchiveResolverType<T2>::Read(it->second, reader);
+			}
+		}
+
+		static void MixSignature(CSchemaHash& hash, const SSchemaChain* chain)
+		{
+			hash.Mix("map");
+			CBinaryArchiveResolver::CBinaryArchiveResolverType<T1>::MixSignature(hash, chain);
+			CBinaryArchiveResolver::CBinaryArchiveResolverType<T2>::MixSignature(hash, chain);
+		}
+	};
+
+	template <class T>
+	class CBinaryArchiveResolver::CBinaryArchiveResolverType<T, typename std::enable_if<std::is_base_of<ISerializable, T>::value>::type>
+	{
+	public:
+		static void Write(const T& value, CBinaryWriter& writer)
+		{
+			CBinaryArchiveLayout<T>::Get().Write(value, writer);
+		}
+
+		static void Read(T& value, CBinaryReader& reader)
+		{
+			CBinaryArchiveLayout<T>::Get().Read(value, reader);
+		}
+
+		static void MixSignature(CSchemaHash& hash, const SSchemaChain* chain)
+		{
+			CBinaryArchiveResolver::MixObjectSignature<T>(hash, chain);
+		}
+	};
+
+	// How the archived members of T are copied, built once per type. Members are sorted by offset,
+	// members of nested objects are inlined, and adjacent bitwise members without padding
+	// between them are merged into a single memcpy.
+	template<class T>
+	class CBinaryArchiveLayout
+	{
+	public:
+		struct SStep
+		{
+			std::size_t m_offset;
+			std::size_t m_size; // Bytes copied as they are, when there are no functions
+			void (*m_write)(const char* member, CBinaryWriter& writer);
+			void (*m_read)(char* member, CBinaryReader& reader);
+		};
+
+		static const CBinaryArchiveLayout& Get()
+		{
+			static const CBinaryArchiveLayout layout;
+			return layout;
+		}
+
+		void Write(const T& object, CBinaryWriter& writer) const
+		{
+			const char* base = reinterpret_cast<const char*>(&object);
+			for (const SStep& step : m_steps)
+			{
+				if (step.m_write != nullptr)
+				{
+					step.m_write(base + step.m_offset, writer);
+				}
+				else
+				{
+					writer.Write(base + step.m_offset, step.m_size);
+				}
+			}
+		}
+
+		void Read(T& object, CBinaryReader& reader) const
+		{
+			char* base = reinterpret_cast<char*>(&object);
+			for (auto it = m_steps.begin(); it != m_steps.end() && !reader.HasFailed(); ++it)
+			{
+				if (it->m_read != nullptr)
+				{
+					it->m_read(base + it->m_offset, reader);
+				}
+				else
+				{
+					reader.Read(base + it->m_offset, it->m_size);
+				}
+			}
+		}
+
+		const std::vector<SStep>& GetSteps() const { return m_steps; }
+
+		// One step per member, without merging bitwise ones, as columns need them apart
+		const std::vector<SStep>& GetMemberSteps() const { return m_memberSteps; }
+
+		// Changes whenever the name, type or order of an archived member changes, nested ones included.
+		// It also covers the byte order and the size of bitwise types, as they are stored natively.
+		std::uint64_t GetSchemaHash() const { return m_schemaHash; }
+
+	private:
+		class CBuilder
+		{
+		public:
+			template<typename MainClassType, typename MemberType>
+			static void Apply(const DonerReflection::SProperty<MainClassType, MemberType>& property, const T& object, std::vector<SStep>& steps)
+			{
+				const std::size_t offset = CBinaryArchiveResolver::GetOffset(object, &(object.*(property.m_member)));
+				AddSteps<MemberType>(offset, steps, CBinaryArchiveResolver::IsUnsupported<MemberType>(), CBinaryArchiveResolver::IsBitwise<MemberType>(), std::is_base_of<ISerializable, MemberType>());
+			}
+
+		private:
+			template<class MemberType>
+			static void WriteMember(const char* member, CBinaryWriter& writer)
+			{
+				CBinaryArchiveResolver::CBinaryArchiveResolverType<MemberType>::Write(*reinterpret_cast<const MemberType*>(member), writer);
+			}
+
+			template<class MemberType>
+			static void ReadMember(char* member, CBinaryReader& reader)
+			{
+				CBinaryArchiveResolver::CBinaryArchiveResolverType<MemberType>::Read(*reinterpret_cast<MemberType*>(member), reader);
+			}
+
+			template<class MemberType, class IsBitwise, class IsObject>
+			static void AddSteps(std::size_t offset, std::vector<SStep>& steps, std::true_type, IsBitwise, IsObject)
+			{}
+
+			template<class MemberType, class IsObject>
+			static void AddSteps(std::size_t offset, std::vector<SStep>& steps, std::false_type, std::true_type, IsObject)
+			{
+				steps.push_back(SStep{ offset, sizeof(MemberType), nullptr, nullptr });
+			}
+
+			template<class MemberType>
+			static void AddSteps(std::size_t offset, std::vector<SStep>& steps, std::false_type, std::false_type, std::false_type)
+			{
+				steps.push_back(SStep{ offset, 0, &WriteMember<MemberType>, &ReadMember<MemberType> });
+			}
+
+			template<class MemberType>
+			static void AddSteps(std::size_t offset, std::vector<SStep>& steps, std::false_type, std::false_type, std::true_type)
+			{
+				for (const auto& step : CBinaryArchiveLayout<MemberType>::Get().GetSteps())
+				{
+					steps.push_back(SStep{ offset + step.m_offset, step.m_size, step.m_write, step.m_read });
+				}
+			}
+		};
+
+		CBinaryArchiveLayout()
+		{
+			const T object{};
+			std::vector<SStep> steps;
+			APPLY_RESOLVER_WITH_PARAMS_TO_CONST_OBJECT(object, CBuilder, steps)
+			std::stable_sort(steps.begin(), steps.end(), [](const SStep& lhs, const SStep& rhs) { return lhs.m_offset < rhs.m_offset; });
+			m_memberSteps = steps;
+
+			for (const SStep& step : steps)
+			{
+				const bool isBitwise = step.m_write == nullptr;
+				if (isBitwise && !m_steps.empty() && m_steps.back().m_write == nullptr && m_steps.back().m_offset + m_steps.back().m_size == step.m_offset)
+				{
+					m_steps.back().m_size += step.m_size;
+				}
+				else
+				{
+					m_steps.push_back(step);
+				}
+			}
+
+			CSchemaHash hash;
+			const std::uint32_t byteOrder = 0x01020304;
+			hash.Mix(&byteOrder, sizeof(byteOrder));
+			CBinaryArchiveResolver::MixObjectSignature<T>(hash, nullptr);
+			m_schemaHash = hash.GetValue();
+		}
+
+		std::vector<SStep> m_steps;
+		std::vector<SStep> m_memberSteps;
+		std::uint64_t m_schemaHash;
+	};
+
+	// Native binary archives of reflected objects: a magic number and the schema hash of T,
+	// followed by its members in memory order. Archives are only meant to be loaded by builds
+	// with the same layout, and the schema hash rejects the rest.
+	class CBinaryArchive
+	{
+	public:
+		// Appends the archive to output
+		template<class T>
+		static void Save(const T& object, std::vector<std::uint8_t>& output)
+		{
+			CBinaryWriter writer(output);
+			const std::uint64_t schemaHash = GetSchemaHash<T>();
+			writer.Write(GetMagic(), MAGIC_SIZE);
+			writer.Write(&schemaHash, sizeof(schemaHash));
+			CBinaryArchiveLayout<T>::Get().Write(object, writer);
+		}
+
+		template<class T>
+		static std::vector<std::uint8_t> GetBuffer(const T& object)
+		{
+			std::vector<std::uint8_t> output;
+			Save(object, output);
+			return output;
+		}
+
+		// Returns false if the schema hash doesn't match, or the input is truncated or has trailing bytes.
+		// In that case object may have been partially loaded.
+		template<class T>
+		static bool Load(T& object, const std::uint8_t* data, std::size_t size)
+		{
+			CBinaryReader reader(data, size);
+			char magic[MAGIC_SIZE] = {};
+			std::uint64_t schemaHash = 0;
+			if (!reader.Read(magic, sizeof(magic)) || std::memcmp(magic, GetMagic(), MAGIC_SIZE) != 0 || !reader.Read(&schemaHash, sizeof(schemaHash)) || schemaHash != GetSchemaHash<T>())
+			{
+				return false;
+			}
+			CBinaryArchiveLayout<T>::Get().Read(object, reader);
+			return !reader.HasFailed() && reader.IsAtEnd();
+		}
+
+		template<class T>
+		static bool Load(T& object, const std::vector<std::uint8_t>& data)
+		{
+			return Load(object, data.data(), data.size());
+		}
+
+		template<class T>
+		static std::uint64_t GetSchemaHash()
+		{
+			return CBinaryArchiveLayout<T>::Get().GetSchemaHash();
+		}
+
+	private:
+		static const std::size_t MAGIC_SIZE = 4;
+
+		static const char* GetMagic() { return "DSBA"; }
+	};
+}
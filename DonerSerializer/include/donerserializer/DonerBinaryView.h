@@ -0,0 +1,625 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include <donerserializer/DonerSerializerConfig.h>
+#include <donerserializer/DonerContainerTraits.h>
+#include <donerserializer/DonerBinaryArchive.h>
+#include <donerserializer/ISerializable.h>
+
+#include <donerreflection/DonerReflection.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#ifdef DONER_SERIALIZER_HAS_STRING_VIEW
+#include <string_view>
+#endif
+
+namespace DonerSerializer
+{
+	// Binary layout read in place through CBinaryView, without decoding it first.
+	// Every object, and every sequence or map of variable size elements, starts with a table
+	// of 32 bits offsets to its elements, relative to the start of the table:
+	//   object:   count, offsets[count], payloads...
+	//   sequence: count, elements[count] for fixed size elements, or count, offsets[count], payloads...
+	//   map:      2 * count, offsets[2 * count] alternating keys and values, payloads...
+	//   string:   size, bytes[size]
+	// Arithmetic types, enums and bools are fixed size, stored as raw native bytes (bools as one byte).
+	// Buffers are limited to 4GB.
+	//
+	// CBinaryViewWriter appends that data and fills the offset tables that point into it.
+	class CBinaryViewWriter
+	{
+	public:
+		explicit CBinaryViewWriter(std::vector<std::uint8_t>& output)
+			: m_output(output)
+		{}
+
+		std::size_t GetPosition() const { return m_output.size(); }
+
+		void Write(const void* data, std::size_t size)
+		{
+			const std::uint8_t* bytes = static_cast<const std::uint8_t*>(data);
+			m_output.insert(m_output.end(), bytes, bytes + size);
+		}
+
+		void WriteUint32(std::size_t value)
+		{
+			const std::uint32_t number = static_cast<std::uint32_t>(value);
+			Write(&number, sizeof(number));
+		}
+
+		// Writes an offset table of count entries and returns its position
+		std::size_t WriteTable(std::size_t count)
+		{
+			const std::size_t table = GetPosition();
+			WriteUint32(count);
+			m_output.resize(m_output.size() + count * sizeof(std::uint32_t));
+			return table;
+		}
+
+		// Points the entry at index of the table to the current position
+		void SetEntry(std::size_t table, std::size_t index)
+		{
+			const std::uint32_t offset = static_cast<std::uint32_t>(GetPosition() - table);
+			std::memcpy(&m_output[table + (index + 1) * sizeof(std::uint32_t)], &offset, sizeof(offset));
+		}
+
+	private:
+		std::vector<std::uint8_t>& m_output;
+	};
+
+	// Bounds checked reads from a view buffer. Out of bounds reads return nullptr or false.
+	class CBinaryViewData
+	{
+	public:
+		static bool ReadUint32(const char* data, const char* end, std::size_t position, std::uint32_t& value)
+		{
+			const char* number = GetElement(data, end, position, sizeof(value));
+			if (number == nullptr)
+			{
+				return false;
+			}
+			std::memcpy(&value, number, sizeof(value));
+			return true;
+		}
+
+		// Start of the element at index of the offset table at data
+		static const char* GetEntry(const char* data, const char* end, std::size_t index)
+		{
+			std::uint32_t count = 0;
+			std::uint32_t offset = 0;
+			if (!ReadUint32(data, end, 0, count) || index >= count || !ReadUint32(data, end, (index + 1) * sizeof(std::uint32_t), offset) || offset >= static_cast<std::size_t>(end - data))
+			{
+				return nullptr;
+			}
+			return data + offset;
+		}
+
+		// Returns the element at position if its size bytes are within bounds
+		static const char* GetElement(const char* data, const char* end, std::size_t position, std::size_t size)
+		{
+			if (data == nullptr)
+			{
+				return nullptr;
+			}
+			const std::size_t available = static_cast<std::size_t>(end - data);
+			return (position <= available && size <= available - position) ? data + position : nullptr;
+		}
+	};
+
+	class CBinaryStringView
+	{
+	public:
+		CBinaryStringView()
+			: m_data("")
+			, m_size(0)
+		{}
+
+		CBinaryStringView(const char* data, std::size_t size)
+			: m_data(data)
+			, m_size(size)
+		{}
+
+		const char* GetData() const { return m_data; }
+		std::size_t GetSize() const { return m_size; }
+		std::string ToString() const { return std::string(m_data, m_size); }
+
+#ifdef DONER_SERIALIZER_HAS_STRING_VIEW
+		operator std::string_view() const { return std::string_view(m_data, m_size); }
+#endif
+
+		bool operator==(const char* text) const { return std::strlen(text) == m_size && std::memcmp(text, m_data, m_size) == 0; }
+		bool operator!=(const char* text) const { return !(*this == text); }
+
+	private:
+		const char* m_data;
+		std::size_t m_size;
+	};
+
+	template<class T>
+	class CBinaryView;
+	template<class T>
+	class CBinaryViewLayout;
+
+	class CBinaryViewResolver
+	{
+	public:
+		// Tag used by CBinaryViewResolverType default implementation.
+		// Members whose type resolver derives from it aren't part of the layout.
+		class CUnsupportedType
+		{};
+
+		// TView is what CBinaryView returns for a T, and Read builds it from the start of its payload.
+		// Types with a non zero fixed size are stored inline in sequences.
+		template <class T, class Enable = void>
+		class CBinaryViewResolverType : public CUnsupportedType
+		{
+		public:
+			using TView = void;
+			static constexpr std::size_t GetFixedSize() { return 0; }
+			static void Write(const T& value, CBinaryViewWriter& writer) {}
+		};
+
+		template<class T>
+		using IsUnsupported = std::is_base_of<CUnsupportedType, CBinaryViewResolverType<T>>;
+
+		template<class T>
+		using TView = typename CBinaryViewResolverType<T>::TView;
+	};
+
+	template <class T>
+	class CBinaryViewResolver::CBinaryViewResolverType<T, typename std::enable_if<CBinaryArchiveResolver::IsBitwise<T>::value>::type>
+	{
+	public:
+		using TView = T;
+
+		static constexpr std::size_t GetFixedSize() { return sizeof(T); }
+
+		static void Write(const T& value, CBinaryViewWriter& writer) { writer.Write(&value, sizeof(T)); }
+
+		static T Read(const char* data, const char* end)
+		{
+			T value = T();
+			if (CBinaryViewData::GetElement(data, end, 0, sizeof(T)) != nullptr)
+			{
+				std::memcpy(&value, data, sizeof(T));
+			}
+			return value;
+		}
+	};
+
+	template <>
+	class CBinaryViewResolver::CBinaryViewResolverType<bool>
+	{
+	public:
+		using TView = bool;
+
+		static constexpr std::size_t GetFixedSize() { return 1; }
+
+		static void Write(const bool& value, CBinaryViewWriter& writer)
+		{
+			const std::uint8_t byte = value ? 1 : 0;
+			writer.Write(&byte, 1);
+		}
+
+		static bool Read(const char* data, const char* end)
+		{
+			return CBinaryViewData::GetElement(data, end, 0, 1) != nullptr && *data != 0;
+		}
+	};
+
+	template <>
+	class CBinaryViewResolver::CBinaryViewResolverType<std::string>
+	{
+	public:
+		using TView = CBinaryStringView;
+
+		static constexpr std::size_t GetFixedSize() { return 0; }
+
+		static void Write(const std::string& value, CBinaryViewWriter& writer)
+		{
+			writer.WriteUint32(value.size());
+			writer.Write(value.data(), value.size());
+		}
+
+		static CBinaryStringView Read(const char* data, const char* end)
+		{
+			std::uint32_t size = 0;
+			if (!CBinaryViewData::ReadUint32(data, end, 0, size) || CBinaryViewData::GetElement(data, end, sizeof(size), size) == nullptr)
+			{
+				return CBinaryStringView();
+			}
+			return CBinaryStringView(data + sizeof(size), size);
+		}
+	};
+
+#ifdef DONER_SERIALIZER_HAS_STRING_VIEW
+	template <>
+	class CBinaryViewResolver::CBinaryViewResolverType<std::string_view>
+	{
+	public:
+		using TView = CBinaryStringView;
+
+		static constexpr std::size_t GetFixedSize() { return 0; }
+
+		static void Write(const std::string_view& value, CBinaryViewWriter& writer)
+		{
+			writer.WriteUint32(value.size());
+			writer.Write(value.data(), value.size());
+		}
+
+		static CBinaryStringView Read(const char* data, const char* end)
+		{
+			return CBinaryViewResolverType<std::string>::Read(data, end);
+		}
+	};
+#endif
+
+	// Random access to the elements of a sequence
+	template<class T>
+	class CBinarySequenceView
+	{
+	public:
+		CBinarySequenceView()
+			: m_data(nullptr)
+			, m_end(nullptr)
+			, m_size(0)
+		{}
+
+		CBinarySequenceView(const char* data, const char* end)
+			: m_data(data)
+			, m_end(end)
+			, m_size(0)
+		{
+			std::uint32_t size = 0;
+			if (CBinaryViewData::ReadUint32(data, end, 0, size))
+			{
+				m_size = size;
+			}
+		}
+
+		std::size_t GetSize() const { return m_size; }
+		bool IsEmpty() const { return m_size == 0; }
+
+		CBinaryViewResolver::TView<T> operator[](std::size_t index) const
+		{
+			return Get(index, std::integral_constant<bool, (CBinaryViewResolver::CBinaryViewResolverType<T>::GetFixedSize() > 0)>());
+		}
+
+	private:
+		CBinaryViewResolver::TView<T> Get(std::size_t index, std::true_type) const
+		{
+			const std::size_t elementSize = CBinaryViewResolver::CBinaryViewResolverType<T>::GetFixedSize();
+			const char* element = (index < m_size) ? CBinaryViewData::GetElement(m_data, m_end, sizeof(std::uint32_t) + index * elementSize, elementSize) : nullptr;
+			return CBinaryViewResolver::CBinaryViewResolverType<T>::Read(element, m_end);
+		}
+
+		CBinaryViewResolver::TView<T> Get(std::size_t index, std::false_type) const
+		{
+			return CBinaryViewResolver::CBinaryViewResolverType<T>::Read(CBinaryViewData::GetEntry(m_data, m_end, index), m_end);
+		}
+
+		const char* m_data;
+		const char* m_end;
+		std::size_t m_size;
+	};
+
+	// Access by index to the entries of a map, in the iteration order of the serialized map
+	template<class TKey, class TValue>
+	class CBinaryMapView
+	{
+	public:
+		CBinaryMapView()
+			: m_data(nullptr)
+			, m_end(nullptr)
+			, m_size(0)
+		{}
+
+		CBinaryMapView(const char* data, const char* end)
+			: m_data(data)
+			, m_end(end)
+			, m_size(0)
+		{
+			std::uint32_t size = 0;
+			if (CBinaryViewData::ReadUint32(data, end, 0, size))
+			{
+				m_size = size / 2;
+			}
+		}
+
+		std::size_t GetSize() const { return m_size; }
+		bool IsEmpty() const { return m_size == 0; }
+
+		CBinaryViewResolver::TView<TKey> GetKey(std::size_t index) const
+		{
+			return CBinaryViewResolver::CBinaryViewResolverType<TKey>::Read(CBinaryViewData::GetEntry(m_data, m_end, index * 2), m_end);
+		}
+
+		CBinaryViewResolver::TView<TValue> GetValue(std::size_t index) const
+		{
+			return CBinaryViewResolver::CBinaryViewResolverType<TValue>::Read(CBinaryViewData::GetEntry(m_data, m_end, index * 2 + 1), m_end);
+		}
+
+	private:
+		const char* m_data;
+		const char* m_end;
+		std::size_t m_size;
+	};
+
+	template<template<typename, typename> class TT, typename T1, typename T2>
+	class CBinaryViewResolver::CBinaryViewResolverType<TT<T1, T2>, typename std::enable_if<!SIsMap<TT<T1, T2>>::value>::type>
+	{
+	public:
+		using TView = CBinarySequenceView<T1>;
+
+		static constexpr std::size_t GetFixedSize() { return 0; }
+
+		static void Write(const TT<T1, T2>& value, CBinaryViewWriter& writer)
+		{
+			Write(value, writer, std::integral_constant<bool, (CBinaryViewResolverType<T1>::GetFixedSize() > 0)>(), IsContiguousBitwise());
+		}
+
+		static TView Read(const char* data, const char* end)
+		{
+			return TView(data, end);
+		}
+
+	private:
+		using IsContiguousBitwise = std::integral_constant<bool, std::is_same<TT<T1, T2>, std::vector<T1, T2>>::value && CBinaryArchiveResolver::IsBitwise<T1>::value>;
+
+		static void Write(const TT<T1, T2>& value, CBinaryViewWriter& writer, std::true_type, std::true_type)
+		{
+			writer.WriteUint32(value.size());
+			writer.Write(value.data(), value.size() * sizeof(T1));
+		}
+
+		static void Write(const TT<T1, T2>& value, CBinaryViewWriter& writer, std::true_type, std::false_type)
+		{
+			writer.WriteUint32(value.size());
+			for (const auto& member : value)
+			{
+				CBinaryViewResolverType<T1>::Write(member, writer);
+			}
+		}
+
+		template<class IsContiguous>
+		static void Write(const TT<T1, T2>& value, CBinaryViewWriter& writer, std::false_type, IsContiguous)
+		{
+			const std::size_t table = writer.WriteTable(value.size());
+			std::size_t index = 0;
+			for (const auto& member : value)
+			{
+				writer.SetEntry(table, index++);
+				CBinaryViewResolverType<T1>::Write(member, writer);
+			}
+		}
+	};
+
+	template <template <typename, typename, typename...> class TT, typename T1, typename T2, typename... Args>
+	class CBinaryViewResolver::CBinaryViewResolverType<TT<T1, T2, Args...>, typename std::enable_if<SIsMap<TT<T1, T2, Args...>>::value>::type>
+	{
+	public:
+		using TView = CBinaryMapView<T1, T2>;
+
+		static constexpr std::size_t GetFixedSize() { return 0; }
+
+		static void Write(const TT<T1, T2, Args...>& value, CBinaryViewWriter& writer)
+		{
+			const std::size_t table = writer.WriteTable(value.size() * 2);
+			std::size_t index = 0;
+			for (const auto& val : value)
+			{
+				writer.SetEntry(table, index++);
+				CBinaryViewResolverType<T1>::Write(val.first, writer);
+				writer.SetEntry(table, index++);
+				CBinaryViewResolverType<T2>::Write(val.second, writer);
+			}
+		}
+
+		static TView Read(const char* data, const char* end)
+		{
+			return TView(data, end);
+		}
+	};
+
+	template <class T>
+	class CBinaryViewResolver::CBinaryViewResolverType<T, typename std::enable_if<std::is_base_of<ISerializable, T>::value>::type>
+	{
+	public:
+		using TView = CBinaryView<T>;
+
+		static constexpr std::size_t GetFixedSize() { return 0; }
+
+		static void Write(const T& value, CBinaryViewWriter& writer)
+		{
+			CBinaryViewLayout<T>::Get().Write(value, writer);
+		}
+
+		static TView Read(const char* data, const char* end)
+		{
+			return TView(data, end);
+		}
+	};
+
+	// Members of T in the view layout, sorted by offset. Built once per type.
+	template<class T>
+	class CBinaryViewLayout
+	{
+	public:
+		static const CBinaryViewLayout& Get()
+		{
+			static const CBinaryViewLayout layout;
+			return layout;
+		}
+
+		void Write(const T& object, CBinaryViewWriter& writer) const
+		{
+			const char* base = reinterpret_cast<const char*>(&object);
+			const std::size_t table = writer.WriteTable(m_fields.size());
+			for (std::size_t index = 0; index < m_fields.size(); ++index)
+			{
+				writer.SetEntry(table, index);
+				m_fields[index].m_write(base + m_fields[index].m_offset, writer);
+			}
+		}
+
+		// Index of member in the offset table of T, or the field count if it isn't in the layout
+		template<class MemberType>
+		std::size_t GetFieldIndex(MemberType T::* member) const
+		{
+			const std::size_t offset = CBinaryArchiveResolver::GetOffset(m_object, &(m_object.*member));
+			auto it = std::lower_bound(m_fields.begin(), m_fields.end(), offset, [](const SField& field, std::size_t value) { return field.m_offset < value; });
+			return (it != m_fields.end() && it->m_offset == offset) ? static_cast<std::size_t>(it - m_fields.begin()) : m_fields.size();
+		}
+
+	private:
+		struct SField
+		{
+			std::size_t m_offset;
+			void (*m_write)(const char* member, CBinaryViewWriter& writer);
+		};
+
+		class CBuilder
+		{
+		public:
+			template<typename MainClassType, typename MemberType>
+			static void Apply(const DonerReflection::SProperty<MainClassType, MemberType>& property, const T& object, std::vector<SField>& fields)
+			{
+				if (!CBinaryViewResolver::IsUnsupported<MemberType>::value)
+				{
+					fields.push_back(SField{ CBinaryArchiveResolver::GetOffset(object, &(object.*(property.m_member))), &WriteMember<MemberType> });
+				}
+			}
+
+		private:
+			template<class MemberType>
+			static void WriteMember(const char* member, CBinaryViewWriter& writer)
+			{
+				CBinaryViewResolver::CBinaryViewResolverType<MemberType>::Write(*reinterpret_cast<const MemberType*>(member), writer);
+			}
+		};
+
+		CBinaryViewLayout()
+			: m_object()
+		{
+			APPLY_RESOLVER_WITH_PARAMS_TO_CONST_OBJECT(m_object, CBuilder, m_fields)
+			std::stable_sort(m_fields.begin(), m_fields.end(), [](const SField& lhs, const SField& rhs) { return lhs.m_offset < rhs.m_offset; });
+		}
+
+		// Only used to find member offsets
+		const T m_object;
+		std::vector<SField> m_fields;
+	};
+
+	// Read-only view of a serialized T. Members are read lazily, straight from the buffer,
+	// each time they are accessed, so opening a view costs the same whatever the buffer size.
+	// Members missing from the buffer, or out of its bounds, read as default values or empty views.
+	// The buffer needs to outlive the view and every view taken from it.
+	template<class T>
+	class CBinaryView
+	{
+	public:
+		CBinaryView()
+			: m_data(nullptr)
+			, m_end(nullptr)
+		{}
+
+		CBinaryView(const char* data, const char* end)
+			: m_data(data)
+			, m_end(end)
+		{}
+
+		// Returns an invalid view if the buffer wasn't serialized from a T with the same schema
+		static CBinaryView Open(const char* data, std::size_t size)
+		{
+			const std::size_t headerSize = MAGIC_SIZE + sizeof(std::uint64_t);
+			std::uint64_t schemaHash = 0;
+			if (data == nullptr || size < headerSize || std::memcmp(data, GetMagic(), MAGIC_SIZE) != 0)
+			{
+				return CBinaryView();
+			}
+			std::memcpy(&schemaHash, data + MAGIC_SIZE, sizeof(schemaHash));
+			if (schemaHash != CBinaryArchive::GetSchemaHash<T>())
+			{
+				return CBinaryView();
+			}
+			return CBinaryView(data + headerSize, data + size);
+		}
+
+		static CBinaryView Open(const std::vector<std::uint8_t>& buffer)
+		{
+			return Open(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+		}
+
+		// Appends the serialized object to output
+		static void Serialize(const T& object, std::vector<std::uint8_t>& output)
+		{
+			CBinaryViewWriter writer(output);
+			const std::uint64_t schemaHash = CBinaryArchive::GetSchemaHash<T>();
+			writer.Write(GetMagic(), MAGIC_SIZE);
+			writer.Write(&schemaHash, sizeof(schemaHash));
+			CBinaryViewLayout<T>::Get().Write(object, writer);
+		}
+
+		static std::vector<std::uint8_t> GetBuffer(const T& object)
+		{
+			std::vector<std::uint8_t> output;
+			Serialize(object, output);
+			return output;
+		}
+
+		bool IsValid() const { return m_data != nullptr; }
+
+		// view.Get(&CFoo::m_member) returns a value for arithmetic types, enums and bools,
+		// a CBinaryStringView for strings, a CBinarySequenceView or CBinaryMapView for containers
+		// and a CBinaryView for reflected classes
+		template<class MemberType>
+		CBinaryViewResolver::TView<MemberType> Get(MemberType T::* member) const
+		{
+			static_assert(!CBinaryViewResolver::IsUnsupported<MemberType>::value, "Member type not supported by binary views");
+			const std::size_t index = CBinaryViewLayout<T>::Get().GetFieldIndex(member);
+			return CBinaryViewResolver::CBinaryViewResolverType<MemberType>::Read(CBinaryViewData::GetEntry(m_data, m_end, index), m_end);
+		}
+
+	private:
+		static const std::size_t MAGIC_SIZE = 4;
+
+		static const char* GetMagic() { return "DSBV"; }
+
+		const char* m_data;
+		const char* m_end;
+	};
+}
@@ -0,0 +1,571 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include <donerserializer/DonerSerializerConfig.h>
+#include <donerserializer/DonerContainerTraits.h>
+#include <donerserializer/DonerDeserialize.h>
+#include <donerserializer/ISerializable.h>
+
+#include <donerreflection/DonerReflection.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef DONER_SERIALIZER_HAS_STRING_VIEW
+#include <string_view>
+#endif
+
+namespace DonerSerializer
+{
+	// Decodes CBOR values one header at a time. Scalars and strings are decoded whole,
+	// while array and map values only carry their element count, as their elements follow.
+	// Any valid encoding is accepted, not only the deterministic one, but indefinite lengths aren't supported.
+	// Tags are ignored and the tagged value is returned instead.
+	// Truncated or invalid input marks the reader as failed, and from then on every value is Invalid.
+	class CCborReader
+	{
+	public:
+		enum class EType
+		{
+			Null, // Undefined is read as Null too
+			Bool,
+			Int, // Negative integers only, non-negative ones are always Uint
+			Uint,
+			Float,
+			Bytes,
+			Text,
+			Array,
+			Map,
+			Invalid
+		};
+
+		struct SValue
+		{
+			EType m_type;
+			bool m_bool;
+			std::int64_t m_int;
+			std::uint64_t m_uint;
+			double m_double;
+			const char* m_data; // Bytes and Text payload
+			std::uint64_t m_size; // Payload size, or element count of Array and Map
+		};
+
+		CCborReader(const std::uint8_t* data, std::size_t size)
+			: m_current(data)
+			, m_end(data + size)
+			, m_failed(false)
+		{}
+
+		bool Read(SValue& value)
+		{
+			value = SValue{ EType::Invalid, false, 0, 0, 0.0, nullptr, 0 };
+			std::uint8_t byte = 0;
+			std::uint64_t argument = 0;
+			do
+			{
+				if (!Get(byte) || !ReadArgument(byte, argument))
+				{
+					return false;
+				}
+			} while ((byte >> 5) == 6);
+
+			switch (byte >> 5)
+			{
+			case 0:
+				value.m_type = EType::Uint;
+				value.m_uint = argument;
+				return true;
+			case 1:
+				// Integers under INT64_MIN are valid CBOR, but can't be represented
+				if (argument <= static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max()))
+				{
+					value.m_type = EType::Int;
+					value.m_int = -1 - static_cast<std::int64_t>(argument);
+				}
+				return true;
+			case 2: return ReadPayload(value, EType::Bytes, argument);
+			case 3: return ReadPayload(value, EType::Text, argument);
+			case 4: return SetContainer(value, EType::Array, argument);
+			case 5: return SetContainer(value, EType::Map, argument);
+			default: return ReadSimple(value, byte & 0x1f, argument);
+			}
+		}
+
+		// Skips the elements of Array and Map values, nested ones included
+		void Skip(const SValue& value)
+		{
+			std::uint64_t remaining = PendingValues(value);
+			SValue nested;
+			while (remaining > 0 && Read(nested))
+			{
+				remaining += PendingValues(nested) - 1;
+			}
+		}
+
+		void SkipValue()
+		{
+			SValue value;
+			if (Read(value))
+			{
+				Skip(value);
+			}
+		}
+
+		bool HasFailed() const { return m_failed; }
+		bool IsAtEnd() const { return m_current == m_end; }
+
+	private:
+		static std::uint64_t PendingValues(const SValue& value)
+		{
+			if (value.m_type == EType::Array)
+			{
+				return value.m_size;
+			}
+			return (value.m_type == EType::Map) ? value.m_size * 2 : 0;
+		}
+
+		bool Fail()
+		{
+			m_failed = true;
+			m_current = m_end;
+			return false;
+		}
+
+		bool Get(std::uint8_t& byte)
+		{
+			if (m_failed || m_current == m_end)
+			{
+				return Fail();
+			}
+			byte = *m_current++;
+			return true;
+		}
+
+		bool GetBigEndian(std::size_t bytes, std::uint64_t& value)
+		{
+			if (m_failed || static_cast<std::size_t>(m_end - m_current) < bytes)
+			{
+				return Fail();
+			}
+			value = 0;
+			for (std::size_t index = 0; index < bytes; ++index)
+			{
+				value = (value << 8) | m_current[index];
+			}
+			m_current += bytes;
+			return true;
+		}
+
+		// The argument follows the initial byte in 1, 2, 4 or 8 bytes, or is embedded in it when under 24
+		bool ReadArgument(std::uint8_t byte, std::uint64_t& argument)
+		{
+			const std::uint8_t info = byte & 0x1f;
+			if (info < 24)
+			{
+				argument = info;
+				return true;
+			}
+			if (info <= 27)
+			{
+				return GetBigEndian(std::size_t(1) << (info - 24), argument);
+			}
+			return Fail(); // Reserved values and indefinite lengths
+		}
+
+		// Containers can't be larger than the remaining input, as each element takes one byte at least
+		bool SetContainer(SValue& value, EType type, std::uint64_t size)
+		{
+			if (size > static_cast<std::uint64_t>(m_end - m_current))
+			{
+				return Fail();
+			}
+			value.m_type = type;
+			value.m_size = size;
+			return true;
+		}
+
+		bool ReadPayload(SValue& value, EType type, std::uint64_t size)
+		{
+			if (size > static_cast<std::uint64_t>(m_end - m_current))
+			{
+				return Fail();
+			}
+			value.m_type = type;
+			value.m_data = reinterpret_cast<const char*>(m_current);
+			value.m_size = size;
+			m_current += size;
+			return true;
+		}
+
+		bool ReadSimple(SValue& value, std::uint8_t info, std::uint64_t argument)
+		{
+			switch (info)
+			{
+			case 20:
+			case 21: value.m_type = EType::Bool; value.m_bool = (info == 21); return true;
+			case 22:
+			case 23: value.m_type = EType::Null; return true;
+			case 25: value.m_type = EType::Float; value.m_double = FromHalf(static_cast<std::uint16_t>(argument)); return true;
+			case 26:
+			{
+				const std::uint32_t bits = static_cast<std::uint32_t>(argument);
+				float number = 0.f;
+				std::memcpy(&number, &bits, sizeof(number));
+				value.m_type = EType::Float;
+				value.m_double = number;
+				return true;
+			}
+			case 27: value.m_type = EType::Float; std::memcpy(&value.m_double, &argument, sizeof(argument)); return true;
+			default: return true; // Other simple values are valid, but have no meaning here
+			}
+		}
+
+		static double FromHalf(std::uint16_t half)
+		{
+			const int exponent = (half >> 10) & 0x1f;
+			const int mantissa = half & 0x3ff;
+			double number = 0.0;
+			if (exponent == 0)
+			{
+				number = std::ldexp(mantissa, -24);
+			}
+			else if (exponent != 31)
+			{
+				number = std::ldexp(mantissa + 1024, exponent - 25);
+			}
+			else
+			{
+				number = (mantissa == 0) ? std::numeric_limits<double>::infinity() : std::numeric_limits<double>::quiet_NaN();
+			}
+			return (half & 0x8000) ? -number : number;
+		}
+
+		const std::uint8_t* m_current;
+		const std::uint8_t* m_end;
+		bool m_failed;
+	};
+
+	class CCborDeserializationResolver
+	{
+	public:
+		using SValue = CCborReader::SValue;
+		using EType = CCborReader::EType;
+
+		// Reads a map and routes each member to its property. Unknown members, and values of
+		// the wrong type, are skipped.
+		template<class T>
+		static void ApplyToObject(T& object, CCborReader& reader)
+		{
+			SValue value;
+			if (!reader.Read(value))
+			{
+				return;
+			}
+			if (value.m_type != EType::Map)
+			{
+				reader.Skip(value);
+				return;
+			}
+
+			const CPropertyLookupTable<T, CPropertyBinder<T>>& table = CPropertyLookupTable<T, CPropertyBinder<T>>::Get();
+			for (std::uint64_t index = 0; index < value.m_size && !reader.HasFailed(); ++index)
+			{
+				SValue key;
+				reader.Read(key);
+				const bool isName = key.m_type == EType::Text && key.m_size <= std::numeric_limits<rapidjson::SizeType>::max();
+				const auto* entry = isName ? table.Find(key.m_data, static_cast<rapidjson::SizeType>(key.m_size)) : nullptr;
+				if (entry != nullptr)
+				{
+					entry->m_function(object, reader);
+				}
+				else
+				{
+					reader.Skip(key);
+					reader.SkipValue();
+				}
+			}
+		}
+
+		template<class T>
+		class CPropertyBinder
+		{
+		public:
+			using TFunction = void (*)(T&, CCborReader&);
+
+			template<class Property>
+			static TFunction Bind()
+			{
+				return &Apply<Property>;
+			}
+
+		private:
+			template<class Property>
+			static void Apply(T& object, CCborReader& reader)
+			{
+				CCborDeserializationResolverType<typename Property::TMember>::Apply(Property::GetMember(object), reader);
+			}
+		};
+
+		template <class T, class Enable = void>
+		class CCborDeserializationResolverType
+		{
+		public:
+			static void Apply(T& value, CCborReader& reader)
+			{
+				reader.SkipValue();
+			}
+		};
+
+		// Reads a scalar. Containers are skipped and reported as Invalid.
+		static SValue ReadScalar(CCborReader& reader)
+		{
+			SValue value;
+			if (reader.Read(value) && (value.m_type == EType::Array || value.m_type == EType::Map))
+			{
+				reader.Skip(value);
+				value.m_type = EType::Invalid;
+			}
+			return value;
+		}
+	};
+
+	template <>
+	class CCborDeserializationResolver::CCborDeserializationResolverType<bool>
+	{
+	public:
+		static void Apply(bool& value, CCborReader& reader)
+		{
+			const SValue att = ReadScalar(reader);
+			if (att.m_type == EType::Bool)
+			{
+				value = att.m_bool;
+			}
+		}
+	};
+
+	// Integers are accepted as long as they fit in T
+	template <class T>
+	class CCborDeserializationResolver::CCborDeserializationResolverType<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type>
+	{
+	public:
+		static void Apply(T& value, CCborReader& reader)
+		{
+			const SValue att = ReadScalar(reader);
+			if (att.m_type == EType::Uint && att.m_uint <= static_cast<std::uint64_t>(std::numeric_limits<T>::max()))
+			{
+				value = static_cast<T>(att.m_uint);
+			}
+			else if (att.m_type == EType::Int && std::is_signed<T>::value && att.m_int >= static_cast<std::int64_t>(std::numeric_limits<T>::min()))
+			{
+				value = static_cast<T>(att.m_int);
+			}
+		}
+	};
+
+	// Integers are accepted too, as the deterministic encoding doesn't turn integral floats into integers,
+	// but other encoders might
+	template <class T>
+	class CCborDeserializationResolver::CCborDeserializationResolverType<T, typename std::enable_if<std::is_floating_point<T>::value>::type>
+	{
+	public:
+		static void Apply(T& value, CCborReader& reader)
+		{
+			const SValue att = ReadScalar(reader);
+			if (att.m_type == EType::Float)
+			{
+				value = static_cast<T>(att.m_double);
+			}
+			else if (att.m_type == EType::Uint)
+			{
+				value = static_cast<T>(att.m_uint);
+			}
+			else if (att.m_type == EType::Int)
+			{
+				value = static_cast<T>(att.m_int);
+			}
+		}
+	};
+
+	template <class T>
+	class CCborDeserializationResolver::CCborDeserializationResolverType<T, typename std::enable_if<std::is_enum<T>::value>::type>
+	{
+	public:
+		static void Apply(T& value, CCborReader& reader)
+		{
+			std::int32_t number = static_cast<std::int32_t>(value);
+			CCborDeserializationResolverType<std::int32_t>::Apply(number, reader);
+			value = static_cast<T>(number);
+		}
+	};
+
+	template <>
+	class CCborDeserializationResolver::CCborDeserializationResolverType<std::string>
+	{
+	public:
+		static void Apply(std::string& value, CCborReader& reader)
+		{
+			const SValue att = ReadScalar(reader);
+			if (att.m_type == EType::Text)
+			{
+				value.assign(att.m_data, static_cast<std::size_t>(att.m_size));
+			}
+		}
+	};
+
+#ifdef DONER_SERIALIZER_HAS_STRING_VIEW
+	// Points into the input buffer, which needs to outlive the view
+	template <>
+	class CCborDeserializationResolver::CCborDeserializationResolverType<std::string_view>
+	{
+	public:
+		static void Apply(std::string_view& value, CCborReader& reader)
+		{
+			const SValue att = ReadScalar(reader);
+			if (att.m_type == EType::Text)
+			{
+				value = std::string_view(att.m_data, static_cast<std::size_t>(att.m_size));
+			}
+		}
+	};
+#endif
+
+	template<template<typename, typename> class TT, typename T1, typename T2>
+	class CCborDeserializationResolver::CCborDeserializationResolverType<TT<T1, T2>, typename std::enable_if<!SIsMap<TT<T1, T2>>::value>::type>
+	{
+	public:
+		static void Apply(TT<T1, T2>& value, CCborReader& reader)
+		{
+			SValue att;
+			if (!reader.Read(att))
+			{
+				return;
+			}
+			if (att.m_type != EType::Array)
+			{
+				reader.Skip(att);
+				return;
+			}
+
+			CContainerHelper::Reserve(value, value.size() + static_cast<std::size_t>(att.m_size));
+			for (std::uint64_t index = 0; index < att.m_size && !reader.HasFailed(); ++index)
+			{
+				AddElement(value, reader, CContainerHelper::CanFillInPlace<TT<T1, T2>>());
+			}
+		}
+
+	private:
+		static void AddElement(TT<T1, T2>& value, CCborReader& reader, std::true_type)
+		{
+			value.emplace_back();
+			CCborDeserializationResolver::CCborDeserializationResolverType<T1>::Apply(value.back(), reader);
+		}
+
+		static void AddElement(TT<T1, T2>& value, CCborReader& reader, std::false_type)
+		{
+			T1 element = T1();
+			CCborDeserializationResolver::CCborDeserializationResolverType<T1>::Apply(element, reader);
+			value.push_back(std::move(element));
+		}
+	};
+
+	template <template <typename, typename, typename...> class TT, typename T1, typename T2, typename... Args>
+	class CCborDeserializationResolver::CCborDeserializationResolverType<TT<T1, T2, Args...>, typename std::enable_if<SIsMap<TT<T1, T2, Args...>>::value>::type>
+	{
+	public:
+		static void Apply(TT<T1, T2, Args...>& map, CCborReader& reader)
+		{
+			SValue att;
+			if (!reader.Read(att))
+			{
+				return;
+			}
+			if (att.m_type != EType::Map)
+			{
+				reader.Skip(att);
+				return;
+			}
+
+			CContainerHelper::Reserve(map, map.size() + static_cast<std::size_t>(att.m_size));
+			for (std::uint64_t index = 0; index < att.m_size && !reader.HasFailed(); ++index)
+			{
+				T1 key = T1();
+				CCborDeserializationResolver::CCborDeserializationResolverType<T1>::Apply(key, reader);
+
+				auto it = map.find(key);
+				if (it == map.end())
+				{
+					it = map.emplace(std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple()).first;
+				}
+				else
+				{
+					it->second = T2();
+				}
+				CCborDeserializationResolver::CCborDeserializationResolverType<T2>::Apply(it->second, reader);
+			}
+		}
+	};
+
+	template <class T>
+	class CCborDeserializationResolver::CCborDeserializationResolverType<T, typename std::enable_if<std::is_base_of<ISerializable, T>::value>::type>
+	{
+	public:
+		static void Apply(T& value, CCborReader& reader)
+		{
+			CCborDeserializationResolver::ApplyToObject(value, reader);
+		}
+	};
+
+	class CCborDeserializer
+	{
+	public:
+		// Returns false if the input is truncated or malformed, or has trailing bytes
+		template<class T>
+		static bool Deserialize(T& object, const std::uint8_t* data, std::size_t size)
+		{
+			CCborReader reader(data, size);
+			CCborDeserializationResolver::ApplyToObject(object, reader);
+			return !reader.HasFailed() && reader.IsAtEnd();
+		}
+
+		template<class T>
+		static bool Deserialize(T& object, const std::vector<std::uint8_t>& data)
+		{
+			return Deserialize(object, data.data(), data.size());
+		}
+	};
+}
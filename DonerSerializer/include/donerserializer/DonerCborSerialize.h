@@ -0,0 +1,437 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include <donerserializer/DonerSerializerConfig.h>
+#include <donerserializer/DonerContainerTraits.h>
+#include <donerserializer/DonerDeserialize.h>
+#include <donerserializer/ISerializable.h>
+
+#include <donerreflection/DonerReflection.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#ifdef DONER_SERIALIZER_HAS_STRING_VIEW
+#include <string_view>
+#endif
+
+namespace DonerSerializer
+{
+	// Appends CBOR encoded values to a byte buffer following the RFC 8949 deterministic encoding:
+	// integers, lengths and floats always use their shortest form and only definite lengths are used.
+	// Map key ordering is up to the caller, see CCborSerializationResolver.
+	class CCborWriter
+	{
+	public:
+		enum EMajorType : std::uint8_t
+		{
+			Unsigned = 0,
+			Negative = 1,
+			Bytes = 2,
+			Text = 3,
+			Array = 4,
+			Map = 5,
+			Tag = 6,
+			Simple = 7
+		};
+
+		explicit CCborWriter(std::vector<std::uint8_t>& output)
+			: m_output(output)
+		{}
+
+		void WriteNull() { Put(0xf6); }
+		void WriteBool(bool value) { Put(value ? 0xf5 : 0xf4); }
+
+		void WriteInt(std::int64_t value)
+		{
+			if (value >= 0)
+			{
+				WriteHeader(Unsigned, static_cast<std::uint64_t>(value));
+			}
+			else
+			{
+				// -1 - value, without overflowing for INT64_MIN
+				WriteHeader(Negative, ~static_cast<std::uint64_t>(value));
+			}
+		}
+
+		void WriteUint(std::uint64_t value) { WriteHeader(Unsigned, value); }
+
+		// Uses the shortest of half, single or double precision that keeps the exact value
+		void WriteFloat(double value)
+		{
+			if (std::isnan(value))
+			{
+				Put(0xf9);
+				PutBigEndian(static_cast<std::uint16_t>(0x7e00));
+				return;
+			}
+
+			const float single = static_cast<float>(value);
+			if (static_cast<double>(single) != value)
+			{
+				std::uint64_t bits;
+				std::memcpy(&bits, &value, sizeof(bits));
+				Put(0xfb);
+				PutBigEndian(bits);
+				return;
+			}
+
+			std::uint32_t bits;
+			std::memcpy(&bits, &single, sizeof(bits));
+			std::uint16_t half = 0;
+			if (ToHalf(bits, half))
+			{
+				Put(0xf9);
+				PutBigEndian(half);
+			}
+			else
+			{
+				Put(0xfa);
+				PutBigEndian(bits);
+			}
+		}
+
+		void WriteText(const char* data, std::size_t length)
+		{
+			WriteHeader(Text, length);
+			Append(reinterpret_cast<const std::uint8_t*>(data), length);
+		}
+
+		void WriteArrayHeader(std::size_t size) { WriteHeader(Array, size); }
+		void WriteMapHeader(std::size_t size) { WriteHeader(Map, size); }
+
+		// Appends an already encoded value
+		void Append(const std::uint8_t* data, std::size_t length)
+		{
+			m_output.insert(m_output.end(), data, data + length);
+		}
+
+	private:
+		void Put(std::uint8_t byte) { m_output.push_back(byte); }
+
+		template<class T>
+		void PutBigEndian(T value)
+		{
+			for (std::size_t shift = sizeof(T) * 8; shift > 0; shift -= 8)
+			{
+				Put(static_cast<std::uint8_t>(value >> (shift - 8)));
+			}
+		}
+
+		void WriteHeader(EMajorType type, std::uint64_t argument)
+		{
+			const std::uint8_t major = static_cast<std::uint8_t>(type << 5);
+			if (argument < 24)
+			{
+				Put(static_cast<std::uint8_t>(major | argument));
+			}
+			else if (argument <= UINT8_MAX)
+			{
+				Put(major | 24);
+				PutBigEndian(static_cast<std::uint8_t>(argument));
+			}
+			else if (argument <= UINT16_MAX)
+			{
+				Put(major | 25);
+				PutBigEndian(static_cast<std::uint16_t>(argument));
+			}
+			else if (argument <= UINT32_MAX)
+			{
+				Put(major | 26);
+				PutBigEndian(static_cast<std::uint32_t>(argument));
+			}
+			else
+			{
+				Put(major | 27);
+				PutBigEndian(argument);
+			}
+		}
+
+		// Converts the bits of a float to half precision, if it can be done without losing precision
+		static bool ToHalf(std::uint32_t bits, std::uint16_t& half)
+		{
+			const std::uint16_t sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000);
+			const std::int32_t exponent = static_cast<std::int32_t>((bits >> 23) & 0xff);
+			const std::uint32_t mantissa = bits & 0x7fffff;
+
+			if (exponent == 0xff) // Infinity, NaN is handled before
+			{
+				half = sign | 0x7c00;
+				return true;
+			}
+			if (exponent == 0)
+			{
+				// Zero, float subnormals are too small for half precision
+				half = sign;
+				return mantissa == 0;
+			}
+
+			const std::int32_t unbiased = exponent - 127;
+			if (unbiased >= -14 && unbiased <= 15)
+			{
+				half = static_cast<std::uint16_t>(sign | ((unbiased + 15) << 10) | (mantissa >> 13));
+				return (mantissa & 0x1fff) == 0;
+			}
+			if (unbiased >= -24 && unbiased < -14)
+			{
+				// Half precision subnormal, the implicit leading bit becomes explicit
+				const std::uint32_t shift = static_cast<std::uint32_t>(-1 - unbiased);
+				const std::uint32_t significand = mantissa | 0x800000;
+				half = static_cast<std::uint16_t>(sign | (significand >> shift));
+				return (significand & ((1U << shift) - 1)) == 0;
+			}
+			return false;
+		}
+
+		std::vector<std::uint8_t>& m_output;
+	};
+
+	class CCborSerializationResolver
+	{
+	public:
+		// Tag used by CCborSerializationResolverType default implementation.
+		// Members whose type resolver derives from it are skipped, key included.
+		class CUnsupportedType
+		{};
+
+		// Objects are maps from property name to value. Properties are written in the deterministic
+		// key order, which the lookup table is already sorted by.
+		template<class T>
+		static void SerializeObject(const T& object, CCborWriter& writer)
+		{
+			const CPropertyLookupTable<T, CPropertyBinder<T>>& table = CPropertyLookupTable<T, CPropertyBinder<T>>::Get();
+			const auto& entries = table.GetEntries();
+
+			const std::size_t memberCount = std::count_if(entries.begin(), entries.end(), [](const typename CPropertyLookupTable<T, CPropertyBinder<T>>::SEntry& entry) { return entry.m_function != nullptr; });
+			writer.WriteMapHeader(memberCount);
+			for (const auto& entry : entries)
+			{
+				if (entry.m_function != nullptr)
+				{
+					writer.WriteText(entry.m_name, entry.m_length);
+					entry.m_function(object, writer);
+				}
+			}
+		}
+
+		// Unsupported members are bound to nullptr
+		template<class T>
+		class CPropertyBinder
+		{
+		public:
+			using TFunction = void (*)(const T&, CCborWriter&);
+
+			template<class Property>
+			static TFunction Bind()
+			{
+				return Bind<Property>(IsUnsupported<typename Property::TMember>());
+			}
+
+		private:
+			template<class Property>
+			static TFunction Bind(std::false_type)
+			{
+				return &Serialize<Property>;
+			}
+
+			template<class Property>
+			static TFunction Bind(std::true_type)
+			{
+				return nullptr;
+			}
+
+			template<class Property>
+			static void Serialize(const T& object, CCborWriter& writer)
+			{
+				CCborSerializationResolverType<typename Property::TMember>::Serialize(Property::GetMember(object), writer);
+			}
+		};
+
+		template <class T, class Enable = void>
+		class CCborSerializationResolverType : public CUnsupportedType
+		{
+		public:
+			static void Serialize(const T& value, CCborWriter& writer)
+			{}
+		};
+
+	private:
+		template<class T>
+		using IsUnsupported = std::is_base_of<CUnsupportedType, CCborSerializationResolverType<T>>;
+	};
+
+	template <class T>
+	class CCborSerializationResolver::CCborSerializationResolverType<T, typename std::enable_if<std::is_integral<T>::value || std::is_floating_point<T>::value>::type>
+	{
+	public:
+		static void Serialize(const T& value, CCborWriter& writer)
+		{
+			Write(value, writer, std::integral_constant<bool, std::is_signed<T>::value>());
+		}
+
+	private:
+		static void Write(bool value, CCborWriter& writer, std::false_type) { writer.WriteBool(value); }
+		static void Write(float value, CCborWriter& writer, std::true_type) { writer.WriteFloat(value); }
+		static void Write(double value, CCborWriter& writer, std::true_type) { writer.WriteFloat(value); }
+		static void Write(long double value, CCborWriter& writer, std::true_type) { writer.WriteFloat(static_cast<double>(value)); }
+
+		template<class U>
+		static void Write(U value, CCborWriter& writer, std::true_type) { writer.WriteInt(static_cast<std::int64_t>(value)); }
+		template<class U>
+		static void Write(U value, CCborWriter& writer, std::false_type) { writer.WriteUint(static_cast<std::uint64_t>(value)); }
+	};
+
+	template <class T>
+	class CCborSerializationResolver::CCborSerializationResolverType<T, typename std::enable_if<std::is_enum<T>::value>::type>
+	{
+	public:
+		static void Serialize(const T& value, CCborWriter& writer)
+		{
+			writer.WriteInt(static_cast<std::int32_t>(value));
+		}
+	};
+
+	template <>
+	class CCborSerializationResolver::CCborSerializationResolverType<std::string>
+	{
+	public:
+		static void Serialize(const std::string& value, CCborWriter& writer)
+		{
+			writer.WriteText(value.data(), value.size());
+		}
+	};
+
+#ifdef DONER_SERIALIZER_HAS_STRING_VIEW
+	template <>
+	class CCborSerializationResolver::CCborSerializationResolverType<std::string_view>
+	{
+	public:
+		static void Serialize(const std::string_view& value, CCborWriter& writer)
+		{
+			writer.WriteText(value.data(), value.size());
+		}
+	};
+#endif
+
+	template<template<typename, typename> class TT, typename T1, typename T2>
+	class CCborSerializationResolver::CCborSerializationResolverType<TT<T1, T2>, typename std::enable_if<!SIsMap<TT<T1, T2>>::value>::type>
+	{
+	public:
+		static void Serialize(const TT<T1, T2>& value, CCborWriter& writer)
+		{
+			writer.WriteArrayHeader(value.size());
+			for (const auto& member : value)
+			{
+				CCborSerializationResolver::CCborSerializationResolverType<T1>::Serialize(member, writer);
+			}
+		}
+	};
+
+	// Keys are encoded first and then sorted bytewise, as the deterministic encoding requires.
+	// This makes the output independent of the iteration order of unordered containers.
+	template <template <typename, typename, typename...> class TT, typename T1, typename T2, typename... Args>
+	class CCborSerializationResolver::CCborSerializationResolverType<TT<T1, T2, Args...>, typename std::enable_if<SIsMap<TT<T1, T2, Args...>>::value>::type>
+	{
+	public:
+		static void Serialize(const TT<T1, T2, Args...>& value, CCborWriter& writer)
+		{
+			using TEntry = typename TT<T1, T2, Args...>::value_type;
+
+			struct SEncodedKey
+			{
+				std::size_t m_offset;
+				std::size_t m_length;
+				const TEntry* m_entry;
+			};
+
+			std::vector<std::uint8_t> keyBuffer;
+			std::vector<SEncodedKey> keys;
+			keys.reserve(value.size());
+			CCborWriter keyWriter(keyBuffer);
+			for (const auto& val : value)
+			{
+				const std::size_t offset = keyBuffer.size();
+				CCborSerializationResolver::CCborSerializationResolverType<T1>::Serialize(val.first, keyWriter);
+				keys.push_back(SEncodedKey{ offset, keyBuffer.size() - offset, &val });
+			}
+
+			const std::uint8_t* data = keyBuffer.data();
+			std::sort(keys.begin(), keys.end(), [data](const SEncodedKey& lhs, const SEncodedKey& rhs)
+			{
+				return std::lexicographical_compare(data + lhs.m_offset, data + lhs.m_offset + lhs.m_length, data + rhs.m_offset, data + rhs.m_offset + rhs.m_length);
+			});
+
+			writer.WriteMapHeader(keys.size());
+			for (const SEncodedKey& key : keys)
+			{
+				writer.Append(data + key.m_offset, key.m_length);
+				CCborSerializationResolver::CCborSerializationResolverType<T2>::Serialize(key.m_entry->second, writer);
+			}
+		}
+	};
+
+	template <class T>
+	class CCborSerializationResolver::CCborSerializationResolverType<T, typename std::enable_if<std::is_base_of<ISerializable, T>::value>::type>
+	{
+	public:
+		static void Serialize(const T& value, CCborWriter& writer)
+		{
+			CCborSerializationResolver::SerializeObject(value, writer);
+		}
+	};
+
+	class CCborSerializer
+	{
+	public:
+		// Appends the encoded object to output. Equal objects always produce identical bytes,
+		// so the output can be hashed or compared directly.
+		template<class T>
+		static void Serialize(const T& object, std::vector<std::uint8_t>& output)
+		{
+			CCborWriter writer(output);
+			CCborSerializationResolver::SerializeObject(object, writer);
+		}
+
+		template<class T>
+		static std::vector<std::uint8_t> GetBuffer(const T& object)
+		{
+			std::vector<std::uint8_t> output;
+			Serialize(object, output);
+			return output;
+		}
+	};
+}
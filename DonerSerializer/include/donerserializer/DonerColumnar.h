@@ -0,0 +1,50 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include <type_traits>
+
+namespace DonerSerializer
+{
+	// Opt-in trait for sequences of reflected classes to be serialized as columns, one array per
+	// property, instead of one object per element. Keys aren't repeated for every element, and
+	// numeric columns end up contiguous, which compresses and decodes much better.
+	// Specialize it with DONER_SERIALIZE_SEQUENCES_AS_COLUMNS, at global scope.
+	template<class T>
+	struct SSerializeAsColumns : std::false_type
+	{};
+}
+
+#define DONER_SERIALIZE_SEQUENCES_AS_COLUMNS(base_class) \
+	namespace DonerSerializer \
+	{ \
+		template <> \
+		struct SSerializeAsColumns<base_class> : std::true_type \
+		{}; \
+	}
@@ -0,0 +1,69 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include <donerserializer/DonerSerializerConfig.h>
+
+#include <type_traits>
+
+#ifdef DONER_SERIALIZER_HAS_PMR
+#include <memory_resource>
+#endif
+
+namespace DonerSerializer
+{
+	template<class T>
+	struct SVoid
+	{
+		using type = void;
+	};
+
+	// Containers with a mapped_type (std::map, std::unordered_map...) are serialized as lists of
+	// key/value pairs, and the rest as sequences. The container specializations of every resolver
+	// are constrained with it because, since C++17, std::map also binds to the two parameter
+	// template template parameter of the sequence ones.
+	template<class T, class Enable = void>
+	struct SIsMap : std::false_type
+	{};
+
+	template<class T>
+	struct SIsMap<T, typename SVoid<typename T::mapped_type>::type> : std::true_type
+	{};
+
+	// std::pmr containers and strings, which can be moved to the memory resource of a CPmrDeserializationScope
+	template<class T, class Enable = void>
+	struct SIsPmrContainer : std::false_type
+	{};
+
+#ifdef DONER_SERIALIZER_HAS_PMR
+	template<class T>
+	struct SIsPmrContainer<T, typename std::enable_if<std::is_same<typename T::allocator_type, std::pmr::polymorphic_allocator<typename T::value_type>>::value>::type> : std::true_type
+	{};
+#endif
+}
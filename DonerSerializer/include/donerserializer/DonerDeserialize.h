@@ -27,21 +27,399 @@
 
 #pragma once
 
+#include <donerserializer/DonerSerializerConfig.h>
+#include <donerserializer/DonerContainerTraits.h>
+#include <donerserializer/CBase64.h>
+#include <donerserializer/CCompression.h>
+#include <donerserializer/DonerColumnar.h>
+#include <donerserializer/CParallel.h>
+#include <donerserializer/CPooledJsonDocument.h>
 #include <donerserializer/ISerializable.h>
 
 #include <donerreflection/DonerReflection.h>
 
 #include <rapidjson/document.h>
+#include <rapidjson/memorystream.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
 #include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef DONER_SERIALIZER_HAS_PMR
+#include <memory_resource>
+#endif
+
+#ifdef DONER_SERIALIZER_HAS_STRING_VIEW
+#include <string_view>
+#endif
 
 namespace DonerSerializer
 {
+	// The Index-th reflected property of T. Being a type, it lets each lookup table entry be a plain
+	// function instantiated for its own property, with the member pointer as a constant.
+	template <class T, std::size_t Index>
+	class CReflectedProperty
+	{
+	private:
+		template <class Property>
+		struct SMemberOf;
+
+		template <class MainClassType, class MemberType>
+		struct SMemberOf<DonerReflection::SProperty<MainClassType, MemberType>>
+		{
+			using Type = MemberType;
+		};
+
+	public:
+		using TMember = typename SMemberOf<typename std::decay<decltype(std::get<Index>(DonerReflection::CPropertiesContainer<T>::GetProperties()))>::type>::Type;
+
+		static const char* GetName()
+		{
+			return std::get<Index>(DonerReflection::CPropertiesContainer<T>::GetProperties()).m_name;
+		}
+
+		static TMember& GetMember(T& object)
+		{
+			constexpr auto property = std::get<Index>(DonerReflection::CPropertiesContainer<T>::GetProperties());
+			return object.*(property.m_member);
+		}
+
+		static const TMember& GetMember(const T& object)
+		{
+			constexpr auto property = std::get<Index>(DonerReflection::CPropertiesContainer<T>::GetProperties());
+			return object.*(property.m_member);
+		}
+	};
+
+	// Reflected properties of T sorted by name, so a JSON key can be routed to its member
+	// with a binary search instead of comparing it against every property.
+	// It's built once per type. Binder::Bind<CReflectedProperty<T, Index>>() gives the plain
+	// function pointer each entry calls for its property.
+	template <class T, class Binder>
+	class CPropertyLookupTable
+	{
+	public:
+		using TFunction = typename Binder::TFunction;
+
+		struct SEntry
+		{
+			const char* m_name;
+			rapidjson::SizeType m_length;
+			TFunction m_function;
+		};
+
+		static const CPropertyLookupTable& Get()
+		{
+			static const CPropertyLookupTable table;
+			return table;
+		}
+
+		const SEntry* Find(const char* name, rapidjson::SizeType length) const
+		{
+			auto it = std::lower_bound(m_entries.begin(), m_entries.end(), SKey{ name, length }, SEntryLess());
+			if (it != m_entries.end() && it->m_length == length && std::memcmp(it->m_name, name, length) == 0)
+			{
+				return &(*it);
+			}
+			return nullptr;
+		}
+
+		// Sorted by name length first and then bytewise, which is also the CBOR deterministic key order
+		const std::vector<SEntry>& GetEntries() const { return m_entries; }
+
+		// Remembers the entries already applied to one object, so a key repeated in the input is only
+		// applied the first time, as rapidjson's FindMember does. Up to 64 entries fit in a mask.
+		class CAppliedEntries
+		{
+		public:
+			explicit CAppliedEntries(const CPropertyLookupTable& table)
+				: m_first(table.m_entries.data())
+				, m_mask(0)
+			{
+				if (table.m_entries.size() > MASK_BITS)
+				{
+					m_overflow.resize(table.m_entries.size() - MASK_BITS, false);
+				}
+			}
+
+			// False if entry was already applied
+			bool Mark(const SEntry* entry)
+			{
+				const std::size_t index = static_cast<std::size_t>(entry - m_first);
+				if (index < MASK_BITS)
+				{
+					const std::uint64_t bit = std::uint64_t(1) << index;
+					const bool isFirst = (m_mask & bit) == 0;
+					m_mask |= bit;
+					return isFirst;
+				}
+				const bool isFirst = !m_overflow[index - MASK_BITS];
+				m_overflow[index - MASK_BITS] = true;
+				return isFirst;
+			}
+
+		private:
+			static const std::size_t MASK_BITS = 64;
+
+			const SEntry* m_first;
+			std::uint64_t m_mask;
+			std::vector<bool> m_overflow;
+		};
+
+	private:
+		struct SKey
+		{
+			const char* m_name;
+			rapidjson::SizeType m_length;
+		};
+
+		struct SEntryLess
+		{
+			bool operator()(const SEntry& lhs, const SEntry& rhs) const { return Less(lhs.m_name, lhs.m_length, rhs.m_name, rhs.m_length); }
+			bool operator()(const SEntry& lhs, const SKey& rhs) const { return Less(lhs.m_name, lhs.m_length, rhs.m_name, rhs.m_length); }
+
+			static bool Less(const char* lhs, rapidjson::SizeType lhsLength, const char* rhs, rapidjson::SizeType rhsLength)
+			{
+				if (lhsLength != rhsLength)
+				{
+					return lhsLength < rhsLength;
+				}
+				return std::memcmp(lhs, rhs, lhsLength) < 0;
+			}
+		};
+
+		CPropertyLookupTable()
+		{
+			AddEntries(std::make_index_sequence<std::tuple_size<decltype(DonerReflection::CPropertiesContainer<T>::GetProperties())>::value>());
+			std::stable_sort(m_entries.begin(), m_entries.end(), SEntryLess());
+		}
+
+		template <std::size_t... Indices>
+		void AddEntries(std::index_sequence<Indices...>)
+		{
+			m_entries.reserve(sizeof...(Indices));
+			using TExpand = int[];
+			(void)TExpand{ 0, (AddEntry<CReflectedProperty<T, Indices>>(), 0)... };
+		}
+
+		template <class Property>
+		void AddEntry()
+		{
+			const char* const name = Property::GetName();
+			m_entries.push_back(SEntry{ name, static_cast<rapidjson::SizeType>(std::strlen(name)), Binder::template Bind<Property>() });
+		}
+
+		std::vector<SEntry> m_entries;
+	};
+
+#ifdef DONER_SERIALIZER_HAS_PMR
+	// While alive, the std::pmr containers and strings deserialized on the thread that created it are
+	// moved to resource before being filled, and their elements are created with it. Nested members of
+	// reflected elements are moved too, so a whole object tree can live in one arena and be released at once.
+	class CPmrDeserializationScope
+	{
+	public:
+		explicit CPmrDeserializationScope(std::pmr::memory_resource* resource)
+			: m_previous(GetResource())
+		{
+			GetResource() = resource;
+		}
+
+		~CPmrDeserializationScope()
+		{
+			GetResource() = m_previous;
+		}
+
+		CPmrDeserializationScope(const CPmrDeserializationScope&) = delete;
+		CPmrDeserializationScope& operator=(const CPmrDeserializationScope&) = delete;
+
+		static std::pmr::memory_resource*& GetResource()
+		{
+			static thread_local std::pmr::memory_resource* resource = nullptr;
+			return resource;
+		}
+
+	private:
+		std::pmr::memory_resource* m_previous;
+	};
+#endif
+
+	class CContainerHelper
+	{
+	public:
+		// Elements are filled in place unless back() returns a proxy, like std::vector<bool> does
+		template<class T>
+		using CanFillInPlace = std::is_same<decltype(std::declval<T&>().back()), typename T::value_type&>;
+
+		template<class T>
+		static void Reserve(T& container, std::size_t size)
+		{
+			Reserve(container, size, 0);
+		}
+
+		// Keys and temporaries are created with the container allocator when they use one, like emplace_back does
+		template<class T, class Allocator>
+		static T MakeElement(const Allocator& allocator)
+		{
+			return MakeElement<T>(allocator, std::integral_constant<int, !std::uses_allocator<T, Allocator>::value ? 0 : (std::is_constructible<T, std::allocator_arg_t, const Allocator&>::value ? 1 : 2)>());
+		}
+
+		// Moves a std::pmr container to the memory resource of the current CPmrDeserializationScope, if any
+		template<class T>
+		static void UseMemoryResource(T& container)
+		{
+			UseMemoryResource(container, SIsPmrContainer<T>());
+		}
+
+		// Memory resources aren't required to be thread-safe, so containers that may allocate from one are filled sequentially
+		template<class T>
+		static bool MayUseMemoryResource(const T& container)
+		{
+#ifdef DONER_SERIALIZER_HAS_PMR
+			return SIsPmrContainer<T>::value || CPmrDeserializationScope::GetResource() != nullptr;
+#else
+			return false;
+#endif
+		}
+
+	private:
+		template<class T, class Allocator>
+		static T MakeElement(const Allocator& allocator, std::integral_constant<int, 0>)
+		{
+			return T();
+		}
+
+		template<class T, class Allocator>
+		static T MakeElement(const Allocator& allocator, std::integral_constant<int, 1>)
+		{
+			return T(std::allocator_arg, allocator);
+		}
+
+		template<class T, class Allocator>
+		static T MakeElement(const Allocator& allocator, std::integral_constant<int, 2>)
+		{
+			return T(allocator);
+		}
+
+		template<class T>
+		static void UseMemoryResource(T& container, std::false_type)
+		{}
+
+#ifdef DONER_SERIALIZER_HAS_PMR
+		// polymorphic_allocator doesn't propagate on assignment, so the container is rebuilt in place
+		template<class T>
+		static void UseMemoryResource(T& container, std::true_type)
+		{
+			std::pmr::memory_resource* resource = CPmrDeserializationScope::GetResource();
+			if (resource != nullptr && !container.get_allocator().resource()->is_equal(*resource))
+			{
+				T moved(std::move(container), typename T::allocator_type(resource));
+				container.~T();
+				::new (static_cast<void*>(std::addressof(container))) T(std::move(moved));
+			}
+		}
+#endif
+
+		template<class T>
+		static auto Reserve(T& container, std::size_t size, int) -> decltype(container.reserve(size), void())
+		{
+			container.reserve(size);
+		}
+
+		template<class T>
+		static void Reserve(T& container, std::size_t size, long)
+		{}
+	};
+
+	// Set by the insitu entry points, whose strings live in the caller buffer. std::string_view members
+	// are only bound while it's active, as anywhere else they'd point into a document destroyed on return.
+	class CInsituDeserializationScope
+	{
+	public:
+		explicit CInsituDeserializationScope(bool active = true)
+			: m_previous(IsActive())
+		{
+			IsActive() = active;
+		}
+
+		~CInsituDeserializationScope()
+		{
+			IsActive() = m_previous;
+		}
+
+		CInsituDeserializationScope(const CInsituDeserializationScope&) = delete;
+		CInsituDeserializationScope& operator=(const CInsituDeserializationScope&) = delete;
+
+		static bool& IsActive()
+		{
+			static thread_local bool active = false;
+			return active;
+		}
+
+	private:
+		bool m_previous;
+	};
+
+	// While alive, std::vector-like members with at least minElements elements are deserialized
+	// from the DOM in parallel chunks on the thread that created it, using up to threadCount
+	// threads (0 means one per hardware thread). Nested containers are deserialized sequentially
+	// by each worker, so threads aren't oversubscribed.
+	class CParallelDeserializationScope
+	{
+	public:
+		static const std::size_t DEFAULT_MIN_ELEMENTS = 1024;
+
+		struct SSettings
+		{
+			bool m_enabled;
+			std::size_t m_threadCount;
+			std::size_t m_minElements;
+		};
+
+		explicit CParallelDeserializationScope(std::size_t threadCount = 0, std::size_t minElements = DEFAULT_MIN_ELEMENTS)
+			: m_previous(GetSettings())
+		{
+			GetSettings() = SSettings{ true, threadCount, minElements };
+		}
+
+		explicit CParallelDeserializationScope(const SSettings& settings)
+			: m_previous(GetSettings())
+		{
+			GetSettings() = settings;
+		}
+
+		~CParallelDeserializationScope()
+		{
+			GetSettings() = m_previous;
+		}
+
+		CParallelDeserializationScope(const CParallelDeserializationScope&) = delete;
+		CParallelDeserializationScope& operator=(const CParallelDeserializationScope&) = delete;
+
+		static SSettings& GetSettings()
+		{
+			static thread_local SSettings settings{ false, 0, 0 };
+			return settings;
+		}
+
+	private:
+		SSettings m_previous;
+	};
+
 	class CDeserializationResolver
 	{
 	public:
-		template<typename MainClassType, typename MemberType>
-		static void Apply(const DonerReflection::SProperty<MainClassType, MemberType>& property, MainClassType& object, const rapidjson::Value& value)
+		template<typename MainClassType, typename MemberType, class TValue>
+		static void Apply(const DonerReflection::SProperty<MainClassType, MemberType>& property, MainClassType& object, const TValue& value)
 		{
 			if (value.HasMember(property.m_name))
 			{
@@ -49,11 +427,58 @@ namespace DonerSerializer
 			}
 		}
 
+		// Walks the JSON object members once, routing each one to its property. Like FindMember,
+		// only the first occurrence of a repeated key is applied.
+		template<class T, class TValue>
+		static void ApplyToObject(T& object, const TValue& value)
+		{
+			if (!value.IsObject())
+			{
+				return;
+			}
+
+			// value may be a whole document, but members are plain values
+			using TMemberValue = typename TValue::ValueType;
+			using TTable = CPropertyLookupTable<T, CPropertyBinder<T, TMemberValue>>;
+			const TTable& table = TTable::Get();
+			typename TTable::CAppliedEntries applied(table);
+			for (typename TValue::ConstMemberIterator it = value.MemberBegin(); it != value.MemberEnd(); ++it)
+			{
+				const auto* entry = table.Find(it->name.GetString(), it->name.GetStringLength());
+				if (entry != nullptr && applied.Mark(entry))
+				{
+					entry->m_function(object, it->value);
+				}
+			}
+		}
+
+		// One table per value type, as rapidjson::GenericValue depends on the document allocator
+		template<class T, class TValue>
+		class CPropertyBinder
+		{
+		public:
+			using TFunction = void (*)(T&, const TValue&);
+
+			template<class Property>
+			static TFunction Bind()
+			{
+				return &Apply<Property>;
+			}
+
+		private:
+			template<class Property>
+			static void Apply(T& object, const TValue& value)
+			{
+				CDeserializationResolverType<typename Property::TMember>::Apply(Property::GetMember(object), value);
+			}
+		};
+
 		template <class T, class Enable = void>
 		class CDeserializationResolverType
 		{
 		public:
-			static void Apply(T& value, const rapidjson::Value& att)
+			template <class TValue>
+			static void Apply(T& value, const TValue& att)
 			{}
 		};
 	};
@@ -62,7 +487,8 @@ namespace DonerSerializer
 	class CDeserializationResolver::CDeserializationResolverType<std::int32_t>
 	{
 	public:
-		static void Apply(std::int32_t& value, const rapidjson::Value& att)
+		template <class TValue>
+		static void Apply(std::int32_t& value, const TValue& att)
 		{
 			if (att.IsInt())
 			{
@@ -75,7 +501,8 @@ namespace DonerSerializer
 	class CDeserializationResolver::CDeserializationResolverType<std::uint32_t>
 	{
 	public:
-		static void Apply(std::uint32_t& value, const rapidjson::Value& att)
+		template <class TValue>
+		static void Apply(std::uint32_t& value, const TValue& att)
 		{
 			if (att.IsUint())
 			{
@@ -88,7 +515,8 @@ namespace DonerSerializer
 	class CDeserializationResolver::CDeserializationResolverType<std::int64_t>
 	{
 	public:
-		static void Apply(std::int64_t& value, const rapidjson::Value& att)
+		template <class TValue>
+		static void Apply(std::int64_t& value, const TValue& att)
 		{
 			if (att.IsInt64())
 			{
@@ -101,7 +529,8 @@ namespace DonerSerializer
 	class CDeserializationResolver::CDeserializationResolverType<std::uint64_t>
 	{
 	public:
-		static void Apply(std::uint64_t& value, const rapidjson::Value& att)
+		template <class TValue>
+		static void Apply(std::uint64_t& value, const TValue& att)
 		{
 			if (att.IsUint64())
 			{
@@ -114,7 +543,8 @@ namespace DonerSerializer
 	class CDeserializationResolver::CDeserializationResolverType<float>
 	{
 	public:
-		static void Apply(float& value, const rapidjson::Value& att)
+		template <class TValue>
+		static void Apply(float& value, const TValue& att)
 		{
 			if (att.IsFloat())
 			{
@@ -127,7 +557,8 @@ namespace DonerSerializer
 	class CDeserializationResolver::CDeserializationResolverType<double>
 	{
 	public:
-		static void Apply(double& value, const rapidjson::Value& att)
+		template <class TValue>
+		static void Apply(double& value, const TValue& att)
 		{
 			if (att.IsDouble())
 			{
@@ -140,7 +571,8 @@ namespace DonerSerializer
 	class CDeserializationResolver::CDeserializationResolverType<bool>
 	{
 	public:
-		static void Apply(bool& value, const rapidjson::Value& att)
+		template <class TValue>
+		static void Apply(bool& value, const TValue& att)
 		{
 			if (att.IsBool())
 			{
@@ -153,11 +585,77 @@ namespace DonerSerializer
 	class CDeserializationResolver::CDeserializationResolverType<std::string>
 	{
 	public:
-		static void Apply(std::string& value, const rapidjson::Value& att)
+		template <class TValue>
+		static void Apply(std::string& value, const TValue& att)
+		{
+			if (att.IsString())
+			{
+				value.assign(att.GetString(), att.GetStringLength());
+			}
+		}
+	};
+
+#ifdef DONER_SERIALIZER_HAS_PMR
+	template <>
+	class CDeserializationResolver::CDeserializationResolverType<std::pmr::string>
+	{
+	public:
+		template <class TValue>
+		static void Apply(std::pmr::string& value, const TValue& att)
 		{
 			if (att.IsString())
 			{
-				value = std::string(att.GetString());
+				CContainerHelper::UseMemoryResource(value);
+				value.assign(att.GetString(), att.GetStringLength());
+			}
+		}
+	};
+#endif
+
+#ifdef DONER_SERIALIZER_HAS_STRING_VIEW
+	// The view points into the caller buffer, so it's only bound by the insitu entry points.
+	// Everywhere else the member is left untouched.
+	template <>
+	class CDeserializationResolver::CDeserializationResolverType<std::string_view>
+	{
+	public:
+		template <class TValue>
+		static void Apply(std::string_view& value, const TValue& att)
+		{
+			if (att.IsString() && CInsituDeserializationScope::IsActive())
+			{
+				value = std::string_view(att.GetString(), att.GetStringLength());
+			}
+		}
+	};
+#endif
+
+	// Byte buffers are read from base64 strings. Arrays of numbers, as written by older versions, are still accepted.
+	template <>
+	class CDeserializationResolver::CDeserializationResolverType<std::vector<std::uint8_t>>
+	{
+	public:
+		template <class TValue>
+		static void Apply(std::vector<std::uint8_t>& value, const TValue& att)
+		{
+			if (att.IsString())
+			{
+				const std::size_t first = value.size();
+				value.resize(first + CBase64::GetMaxDecodedSize(att.GetStringLength()));
+				std::size_t size = 0;
+				if (!CBase64::Decode(att.GetString(), att.GetStringLength(), value.data() + first, size))
+				{
+					size = 0;
+				}
+				value.resize(first + size);
+			}
+			else if (att.IsArray())
+			{
+				value.reserve(value.size() + att.Size());
+				for (const TValue& element : att.GetArray())
+				{
+					value.push_back(element.IsUint() ? static_cast<std::uint8_t>(element.GetUint()) : 0);
+				}
 			}
 		}
 	};
@@ -166,7 +664,8 @@ namespace DonerSerializer
 	class CDeserializationResolver::CDeserializationResolverType<T, typename std::enable_if<std::is_enum<T>::value>::type>
 	{
 	public:
-		static void Apply(T& value, const rapidjson::Value& att)
+		template <class TValue>
+		static void Apply(T& value, const TValue& att)
 		{
 			if (att.IsInt())
 			{
@@ -176,38 +675,152 @@ namespace DonerSerializer
 	};
 
 	template<template<typename, typename> class TT, typename T1, typename T2>
-	class CDeserializationResolver::CDeserializationResolverType<TT<T1, T2>>
+	class CDeserializationResolver::CDeserializationResolverType<TT<T1, T2>, typename std::enable_if<!SIsMap<TT<T1, T2>>::value>::type>
 	{
 	public:
-		static void Apply(TT<T1, T2>& value, const rapidjson::Value& atts)
+		template <class TValue>
+		static void Apply(TT<T1, T2>& value, const TValue& atts)
 		{
-			if (atts.IsArray())
+			if (atts.IsObject())
+			{
+				CContainerHelper::UseMemoryResource(value);
+				ApplyColumns(value, atts, SSerializeAsColumns<T1>());
+			}
+			else if (atts.IsArray() && !ApplyInParallel(value, atts, CanApplyInParallel()))
+			{
+				CContainerHelper::UseMemoryResource(value);
+				CContainerHelper::Reserve(value, value.size() + atts.Size());
+				for (const TValue& att : atts.GetArray())
+				{
+					AddElement(value, att, CContainerHelper::CanFillInPlace<TT<T1, T2>>());
+				}
+			}
+		}
+
+	private:
+		// Applies an object of columns, one array per property, as written for SSerializeAsColumns types.
+		// Elements are appended, as many as the longest column.
+		template <class TValue>
+		static void ApplyColumns(TT<T1, T2>& value, const TValue& columns, std::true_type)
+		{
+			rapidjson::SizeType count = 0;
+			for (typename TValue::ConstMemberIterator it = columns.MemberBegin(); it != columns.MemberEnd(); ++it)
+			{
+				count = it->value.IsArray() ? std::max(count, it->value.Size()) : count;
+			}
+			if (count == 0)
+			{
+				return;
+			}
+
+			const std::size_t first = value.size();
+			value.resize(first + count);
+			const auto begin = std::next(value.begin(), static_cast<std::ptrdiff_t>(first));
+			using TTable = CPropertyLookupTable<T1, CPropertyBinder<T1, TValue>>;
+			const TTable& table = TTable::Get();
+			typename TTable::CAppliedEntries applied(table);
+			for (typename TValue::ConstMemberIterator it = columns.MemberBegin(); it != columns.MemberEnd(); ++it)
 			{
-				for (const rapidjson::Value& att : atts.GetArray())
+				const auto* entry = table.Find(it->name.GetString(), it->name.GetStringLength());
+				if (entry != nullptr && it->value.IsArray() && applied.Mark(entry))
 				{
-					T1 element;
-					CDeserializationResolver::CDeserializationResolverType<T1>::Apply(element, att);
-					value.push_back(element);
+					auto element = begin;
+					for (const TValue& att : it->value.GetArray())
+					{
+						entry->m_function(*element++, att);
+					}
 				}
 			}
 		}
+
+		template <class TValue>
+		static void ApplyColumns(TT<T1, T2>& value, const TValue& columns, std::false_type)
+		{}
+
+		using CanApplyInParallel = std::integral_constant<bool, CContainerHelper::CanFillInPlace<TT<T1, T2>>::value &&
+			std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<typename TT<T1, T2>::iterator>::iterator_category>::value>;
+
+		template <class TValue>
+		static bool ApplyInParallel(TT<T1, T2>& value, const TValue& atts, std::false_type)
+		{
+			return false;
+		}
+
+		// Elements are independent, so once the container is sized each chunk can be filled by a different thread
+		template <class TValue>
+		static bool ApplyInParallel(TT<T1, T2>& value, const TValue& atts, std::true_type)
+		{
+			CParallelDeserializationScope::SSettings& settings = CParallelDeserializationScope::GetSettings();
+			const std::size_t count = atts.Size();
+			if (!settings.m_enabled || count < settings.m_minElements || count == 0 || CContainerHelper::MayUseMemoryResource(value))
+			{
+				return false;
+			}
+
+			const std::size_t first = value.size();
+			value.resize(first + count);
+
+			const std::size_t threadCount = CParallel::GetThreadCount(settings.m_threadCount);
+			const std::size_t rangeCount = std::min(count, threadCount * 4);
+
+			// The calling thread works too, and its nested containers must stay sequential like the other workers'
+			CParallelDeserializationScope sequentialScope(CParallelDeserializationScope::SSettings{ false, settings.m_threadCount, settings.m_minElements });
+			const bool insitu = CInsituDeserializationScope::IsActive();
+			CParallel::For(rangeCount, threadCount, [&value, &atts, first, count, rangeCount, insitu](std::size_t rangeIndex, std::size_t)
+			{
+				CInsituDeserializationScope insituScope(insitu);
+				const std::size_t begin = count * rangeIndex / rangeCount;
+				const std::size_t end = count * (rangeIndex + 1) / rangeCount;
+				for (std::size_t index = begin; index < end; ++index)
+				{
+					CDeserializationResolver::CDeserializationResolverType<T1>::Apply(value[first + index], atts[static_cast<rapidjson::SizeType>(index)]);
+				}
+			});
+			return true;
+		}
+
+		template <class TValue>
+		static void AddElement(TT<T1, T2>& value, const TValue& att, std::true_type)
+		{
+			value.emplace_back();
+			CDeserializationResolver::CDeserializationResolverType<T1>::Apply(value.back(), att);
+		}
+
+		template <class TValue>
+		static void AddElement(TT<T1, T2>& value, const TValue& att, std::false_type)
+		{
+			T1 element = CContainerHelper::MakeElement<T1>(value.get_allocator());
+			CDeserializationResolver::CDeserializationResolverType<T1>::Apply(element, att);
+			value.push_back(std::move(element));
+		}
 	};
 
 	template <template <typename, typename, typename...> class TT, typename T1, typename T2, typename... Args>
-	class CDeserializationResolver::CDeserializationResolverType<TT<T1, T2, Args...>>
+	class CDeserializationResolver::CDeserializationResolverType<TT<T1, T2, Args...>, typename std::enable_if<SIsMap<TT<T1, T2, Args...>>::value>::type>
 	{
 	public:
-		static void Apply(TT<T1, T2, Args...>& map, const rapidjson::Value& atts)
+		template <class TValue>
+		static void Apply(TT<T1, T2, Args...>& map, const TValue& atts)
 		{
 			if (atts.IsArray())
 			{
-				for (const rapidjson::Value& att : atts.GetArray())
+				CContainerHelper::UseMemoryResource(map);
+				CContainerHelper::Reserve(map, map.size() + atts.Size());
+				for (const TValue& att : atts.GetArray())
 				{
-					T1 key;
+					T1 key = CContainerHelper::MakeElement<T1>(map.get_allocator());
 					CDeserializationResolver::CDeserializationResolverType<T1>::Apply(key, att[0]);
-					T2 value;
-					CDeserializationResolver::CDeserializationResolverType<T2>::Apply(value, att[1]);
-					map[key] = value;
+
+					auto it = map.find(key);
+					if (it == map.end())
+					{
+						it = map.emplace(std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple()).first;
+					}
+					else
+					{
+						it->second = CContainerHelper::MakeElement<T2>(map.get_allocator());
+					}
+					CDeserializationResolver::CDeserializationResolverType<T2>::Apply(it->second, att[1]);
 				}
 			}
 		}
@@ -217,23 +830,64 @@ namespace DonerSerializer
 	class CDeserializationResolver::CDeserializationResolverType<T, typename std::enable_if<std::is_base_of<ISerializable, T>::value>::type>
 	{
 	public:
-		static void Apply(T& value, const rapidjson::Value& att)
+		template <class TValue>
+		static void Apply(T& value, const TValue& att)
 		{
-			APPLY_RESOLVER_WITH_PARAMS_TO_OBJECT(value, CDeserializationResolver, att)
+			CDeserializationResolver::ApplyToObject(value, att);
 		}
 	};
 
 	class CJsonDeserializer
 	{
 	public:
-		template<class T>
-		static void Deserialize(T& object, const rapidjson::Value& value)
+		// Instances keep their parsed document in pooled buffers that are reused by every
+		// Parse() call, so deserializing many payloads in a loop doesn't reallocate.
+		explicit CJsonDeserializer(std::size_t capacity = CPooledJsonDocument::DEFAULT_CAPACITY,
+			std::size_t stackCapacity = CPooledJsonDocument::DEFAULT_STACK_CAPACITY)
+			: m_document(capacity, stackCapacity)
+		{
+		}
+
+		bool Parse(const char* const jsonStr)
 		{
-			APPLY_RESOLVER_WITH_PARAMS_TO_OBJECT(object, CDeserializationResolver, value)
+			m_document.Reset();
+			return !m_document.GetDocument().Parse(jsonStr).HasParseError();
+		}
+
+		bool Parse(const char* const data, std::size_t length)
+		{
+			m_document.Reset();
+			rapidjson::MemoryStream stream(data, length);
+			return !m_document.GetDocument().ParseStream(stream).HasParseError();
+		}
+
+		// data was written through a compressor, and is decompressed by decompressor while it's parsed
+		template<class Decompressor>
+		bool ParseCompressed(const char* const data, std::size_t length, Decompressor& decompressor)
+		{
+			m_document.Reset();
+			CDecompressingReadStream<Decompressor, CMemorySource> stream(decompressor, CMemorySource(data, length));
+			return !m_document.GetDocument().ParseStream(stream).HasParseError() && !stream.HasFailed();
 		}
 
 		template<class T>
-		static void Deserialize(const T& object, const rapidjson::Value& value)
+		void Deserialize(T& object) const
+		{
+			CDeserializationResolver::ApplyToObject(object, m_document.GetDocument());
+		}
+
+		const CPooledJsonDocument::TDocument& GetJsonDocument() const { return m_document.GetDocument(); }
+		std::size_t GetCapacity() const { return m_document.GetCapacity(); }
+
+		// value can come from any rapidjson::GenericDocument, like one using a per-frame arena allocator
+		template<class T, class Encoding, class Allocator>
+		static void Deserialize(T& object, const rapidjson::GenericValue<Encoding, Allocator>& value)
+		{
+			CDeserializationResolver::ApplyToObject(object, value);
+		}
+
+		template<class T, class Encoding, class Allocator>
+		static void Deserialize(const T& object, const rapidjson::GenericValue<Encoding, Allocator>& value)
 		{
 			APPLY_RESOLVER_WITH_PARAMS_TO_CONST_OBJECT(object, CDeserializationResolver, value)
 		}
@@ -243,7 +897,7 @@ namespace DonerSerializer
 		{
 			rapidjson::Document parser;
 			rapidjson::Value& root = parser.Parse(jsonStr);
-			APPLY_RESOLVER_WITH_PARAMS_TO_OBJECT(object, CDeserializationResolver, root)
+			CDeserializationResolver::ApplyToObject(object, root);
 		}
 
 		template<class T>
@@ -253,5 +907,33 @@ namespace DonerSerializer
 			rapidjson::Value& root = parser.Parse(jsonStr);
 			APPLY_RESOLVER_WITH_PARAMS_TO_CONST_OBJECT(object, CDeserializationResolver, root)
 		}
+
+		// data doesn't need to be null-terminated
+		template<class T>
+		static bool Deserialize(T& object, const char* const data, std::size_t length)
+		{
+			rapidjson::Document parser;
+			rapidjson::MemoryStream stream(data, length);
+			if (parser.ParseStream(stream).HasParseError())
+			{
+				return false;
+			}
+			CDeserializationResolver::ApplyToObject(object, parser);
+			return true;
+		}
+
+		// Strings are decoded in place inside buffer, which gets modified, so they're copied only
+		// once into their final member. std::string_view members point into buffer.
+		template<class T>
+		static void DeserializeInsitu(T& object, char* buffer)
+		{
+			CInsituDeserializationScope insituScope;
+			rapidjson::Document parser;
+			rapidjson::Value& root = parser.ParseInsitu(buffer);
+			CDeserializationResolver::ApplyToObject(object, root);
+		}
+
+	private:
+		CPooledJsonDocument m_document;
 	};
 }
@@ -0,0 +1,75 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <donerserializer/CJsonLinesReader.h>
+#include <donerserializer/CMappedFile.h>
+#include <donerserializer/CParallelJsonLinesReader.h>
+#include <donerserializer/DonerDeserialize.h>
+#include <donerserializer/DonerStreamDeserialize.h>
+
+namespace DonerSerializer
+{
+	// Memory maps files and parses them from there, without reading them into a buffer first.
+	// Mapping goes through the platform API (<windows.h>, <sys/mman.h>...), so it lives in this
+	// header, and including the other ones doesn't bring those headers and their macros along.
+	class CJsonFileDeserializer
+	{
+	public:
+		// Through a document, like CJsonDeserializer
+		template<class T>
+		static bool Deserialize(T& object, const char* const path)
+		{
+			CMappedFile file(path);
+			return file.IsOpen() && CJsonDeserializer::Deserialize(object, file.GetData(), file.GetSize());
+		}
+
+		// Straight from the parsing events, like CJsonStreamDeserializer
+		template<class T>
+		static bool DeserializeStream(T& object, const char* const path)
+		{
+			CMappedFile file(path);
+			return file.IsOpen() && CJsonStreamDeserializer::Deserialize(object, file.GetData(), file.GetSize());
+		}
+
+		template<class T, class Callback>
+		static bool Read(CJsonLinesReader<T>& reader, const char* const path, Callback callback)
+		{
+			CMappedFile file(path);
+			return file.IsOpen() && reader.Read(file.GetData(), file.GetSize(), callback);
+		}
+
+		template<class T, class Callback>
+		static bool Read(CParallelJsonLinesReader<T>& reader, const char* const path, Callback callback,
+			typename CParallelJsonLinesReader<T>::EOrder order = CParallelJsonLinesReader<T>::EOrder::Ordered)
+		{
+			CMappedFile file(path);
+			return file.IsOpen() && reader.Read(file.GetData(), file.GetSize(), callback, order);
+		}
+	};
+}
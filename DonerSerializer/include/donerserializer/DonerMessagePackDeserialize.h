@@ -0,0 +1,612 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include <donerserializer/DonerSerializerConfig.h>
+#include <donerserializer/DonerContainerTraits.h>
+#include <donerserializer/DonerDeserialize.h>
+#include <donerserializer/ISerializable.h>
+
+#include <donerreflection/DonerReflection.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef DONER_SERIALIZER_HAS_STRING_VIEW
+#include <string_view>
+#endif
+
+namespace DonerSerializer
+{
+	// Decodes MessagePack values one header at a time. Scalars and strings are decoded whole,
+	// while array and map values only carry their element count, as their elements follow.
+	// Truncated or invalid input marks the reader as failed, and from then on every value is Invalid.
+	class CMessagePackReader
+	{
+	public:
+		enum class EType
+		{
+			Nil,
+			Bool,
+			Int, // Negative integers only, non-negative ones are always Uint
+			Uint,
+			Float,
+			Double,
+			String,
+			Binary,
+			Array,
+			Map,
+			Extension,
+			Invalid
+		};
+
+		struct SValue
+		{
+			EType m_type;
+			bool m_bool;
+			std::int64_t m_int;
+			std::uint64_t m_uint;
+			double m_double;
+			const char* m_data; // String, Binary and Extension payload
+			std::uint32_t m_size; // Payload size, or element count of Array and Map
+		};
+
+		CMessagePackReader(const std::uint8_t* data, std::size_t size)
+			: m_current(data)
+			, m_end(data + size)
+			, m_failed(false)
+		{}
+
+		bool Read(SValue& value)
+		{
+			value = SValue{ EType::Invalid, false, 0, 0, 0.0, nullptr, 0 };
+			std::uint8_t byte = 0;
+			if (!Get(byte))
+			{
+				return false;
+			}
+
+			if (byte <= 0x7f)
+			{
+				SetUint(value, byte);
+			}
+			else if (byte <= 0x8f)
+			{
+				return SetContainer(value, EType::Map, byte & 0x0f);
+			}
+			else if (byte <= 0x9f)
+			{
+				return SetContainer(value, EType::Array, byte & 0x0f);
+			}
+			else if (byte <= 0xbf)
+			{
+				return ReadPayload(value, EType::String, byte & 0x1f);
+			}
+			else if (byte >= 0xe0)
+			{
+				SetInt(value, static_cast<std::int8_t>(byte));
+			}
+			else
+			{
+				return ReadTyped(value, byte);
+			}
+			return true;
+		}
+
+		// Skips the elements of Array and Map values, nested ones included
+		void Skip(const SValue& value)
+		{
+			std::uint64_t remaining = PendingValues(value);
+			SValue nested;
+			while (remaining > 0 && Read(nested))
+			{
+				remaining += PendingValues(nested) - 1;
+			}
+		}
+
+		void SkipValue()
+		{
+			SValue value;
+			if (Read(value))
+			{
+				Skip(value);
+			}
+		}
+
+		bool HasFailed() const { return m_failed; }
+		bool IsAtEnd() const { return m_current == m_end; }
+
+	private:
+		static std::uint64_t PendingValues(const SValue& value)
+		{
+			if (value.m_type == EType::Array)
+			{
+				return value.m_size;
+			}
+			return (value.m_type == EType::Map) ? static_cast<std::uint64_t>(value.m_size) * 2 : 0;
+		}
+
+		bool Fail()
+		{
+			m_failed = true;
+			m_current = m_end;
+			return false;
+		}
+
+		bool Get(std::uint8_t& byte)
+		{
+			if (m_failed || m_current == m_end)
+			{
+				return Fail();
+			}
+			byte = *m_current++;
+			return true;
+		}
+
+		template<class T>
+		bool GetBigEndian(T& value)
+		{
+			if (m_failed || static_cast<std::size_t>(m_end - m_current) < sizeof(T))
+			{
+				return Fail();
+			}
+			value = 0;
+			for (std::size_t index = 0; index < sizeof(T); ++index)
+			{
+				value = static_cast<T>((value << 8) | m_current[index]);
+			}
+			m_current += sizeof(T);
+			return true;
+		}
+
+		template<class T>
+		bool GetSize(std::uint32_t& size)
+		{
+			T value = 0;
+			if (!GetBigEndian(value))
+			{
+				return false;
+			}
+			size = value;
+			return true;
+		}
+
+		static void SetUint(SValue& value, std::uint64_t number)
+		{
+			value.m_type = EType::Uint;
+			value.m_uint = number;
+		}
+
+		static void SetInt(SValue& value, std::int64_t number)
+		{
+			if (number >= 0)
+			{
+				SetUint(value, static_cast<std::uint64_t>(number));
+			}
+			else
+			{
+				value.m_type = EType::Int;
+				value.m_int = number;
+			}
+		}
+
+		// Every element takes at least one byte, so bigger counts can't be right and would make the
+		// resolvers reserve huge containers
+		bool SetContainer(SValue& value, EType type, std::uint32_t size)
+		{
+			const std::uint64_t minSize = type == EType::Map ? static_cast<std::uint64_t>(size) * 2 : size;
+			if (minSize > static_cast<std::uint64_t>(m_end - m_current))
+			{
+				return Fail();
+			}
+			value.m_type = type;
+			value.m_size = size;
+			return true;
+		}
+
+		bool ReadPayload(SValue& value, EType type, std::uint32_t size)
+		{
+			if (static_cast<std::size_t>(m_end - m_current) < size)
+			{
+				return Fail();
+			}
+			value.m_type = type;
+			value.m_data = reinterpret_cast<const char*>(m_current);
+			value.m_size = size;
+			m_current += size;
+			return true;
+		}
+
+		bool ReadExtension(SValue& value, std::uint32_t size)
+		{
+			std::uint8_t extensionType = 0;
+			return Get(extensionType) && ReadPayload(value, EType::Extension, size);
+		}
+
+		bool ReadTyped(SValue& value, std::uint8_t byte)
+		{
+			std::uint8_t u8 = 0;
+			std::uint16_t u16 = 0;
+			std::uint32_t u32 = 0;
+			std::uint64_t u64 = 0;
+			std::uint32_t size = 0;
+
+			switch (byte)
+			{
+			case 0xc0: value.m_type = EType::Nil; return true;
+			case 0xc2:
+			case 0xc3: value.m_type = EType::Bool; value.m_bool = (byte == 0xc3); return true;
+			case 0xc4: return GetSize<std::uint8_t>(size) && ReadPayload(value, EType::Binary, size);
+			case 0xc5: return GetSize<std::uint16_t>(size) && ReadPayload(value, EType::Binary, size);
+			case 0xc6: return GetSize<std::uint32_t>(size) && ReadPayload(value, EType::Binary, size);
+			case 0xc7: return GetSize<std::uint8_t>(size) && ReadExtension(value, size);
+			case 0xc8: return GetSize<std::uint16_t>(size) && ReadExtension(value, size);
+			case 0xc9: return GetSize<std::uint32_t>(size) && ReadExtension(value, size);
+			case 0xca:
+			{
+				float number = 0.f;
+				if (!GetBigEndian(u32))
+				{
+					return false;
+				}
+				std::memcpy(&number, &u32, sizeof(number));
+				value.m_type = EType::Float;
+				value.m_double = number;
+				return true;
+			}
+			case 0xcb:
+				if (!GetBigEndian(u64))
+				{
+					return false;
+				}
+				value.m_type = EType::Double;
+				std::memcpy(&value.m_double, &u64, sizeof(u64));
+				return true;
+			case 0xcc: if (!GetBigEndian(u8)) return false; SetUint(value, u8); return true;
+			case 0xcd: if (!GetBigEndian(u16)) return false; SetUint(value, u16); return true;
+			case 0xce: if (!GetBigEndian(u32)) return false; SetUint(value, u32); return true;
+			case 0xcf: if (!GetBigEndian(u64)) return false; SetUint(value, u64); return true;
+			case 0xd0: if (!GetBigEndian(u8)) return false; SetInt(value, static_cast<std::int8_t>(u8)); return true;
+			case 0xd1: if (!GetBigEndian(u16)) return false; SetInt(value, static_cast<std::int16_t>(u16)); return true;
+			case 0xd2: if (!GetBigEndian(u32)) return false; SetInt(value, static_cast<std::int32_t>(u32)); return true;
+			case 0xd3: if (!GetBigEndian(u64)) return false; SetInt(value, static_cast<std::int64_t>(u64)); return true;
+			case 0xd4: return ReadExtension(value, 1);
+			case 0xd5: return ReadExtension(value, 2);
+			case 0xd6: return ReadExtension(value, 4);
+			case 0xd7: return ReadExtension(value, 8);
+			case 0xd8: return ReadExtension(value, 16);
+			case 0xd9: return GetSize<std::uint8_t>(size) && ReadPayload(value, EType::String, size);
+			case 0xda: return GetSize<std::uint16_t>(size) && ReadPayload(value, EType::String, size);
+			case 0xdb: return GetSize<std::uint32_t>(size) && ReadPayload(value, EType::String, size);
+			case 0xdc: return GetSize<std::uint16_t>(size) && SetContainer(value, EType::Array, size);
+			case 0xdd: return GetSize<std::uint32_t>(size) && SetContainer(value, EType::Array, size);
+			case 0xde: return GetSize<std::uint16_t>(size) && SetContainer(value, EType::Map, size);
+			case 0xdf: return GetSize<std::uint32_t>(size) && SetContainer(value, EType::Map, size);
+			default: return Fail(); // 0xc1 is never used
+			}
+		}
+
+		const std::uint8_t* m_current;
+		const std::uint8_t* m_end;
+		bool m_failed;
+	};
+
+	class CMessagePackDeserializationResolver
+	{
+	public:
+		using SValue = CMessagePackReader::SValue;
+		using EType = CMessagePackReader::EType;
+
+		// Reads a map and routes each member to its property. Unknown members, and values of
+		// the wrong type, are skipped.
+		template<class T>
+		static void ApplyToObject(T& object, CMessagePackReader& reader)
+		{
+			SValue value;
+			if (!reader.Read(value))
+			{
+				return;
+			}
+			if (value.m_type != EType::Map)
+			{
+				reader.Skip(value);
+				return;
+			}
+
+			const CPropertyLookupTable<T, CPropertyBinder<T>>& table = CPropertyLookupTable<T, CPropertyBinder<T>>::Get();
+			for (std::uint32_t index = 0; index < value.m_size && !reader.HasFailed(); ++index)
+			{
+				SValue key;
+				reader.Read(key);
+				const auto* entry = (key.m_type == EType::String) ? table.Find(key.m_data, key.m_size) : nullptr;
+				if (entry != nullptr)
+				{
+					entry->m_function(object, reader);
+				}
+				else
+				{
+					reader.Skip(key);
+					reader.SkipValue();
+				}
+			}
+		}
+
+		template<class T>
+		class CPropertyBinder
+		{
+		public:
+			using TFunction = void (*)(T&, CMessagePackReader&);
+
+			template<class Property>
+			static TFunction Bind()
+			{
+				return &Apply<Property>;
+			}
+
+		private:
+			template<class Property>
+			static void Apply(T& object, CMessagePackReader& reader)
+			{
+				CMessagePackDeserializationResolverType<typename Property::TMember>::Apply(Property::GetMember(object), reader);
+			}
+		};
+
+		template <class T, class Enable = void>
+		class CMessagePackDeserializationResolverType
+		{
+		public:
+			static void Apply(T& value, CMessagePackReader& reader)
+			{
+				reader.SkipValue();
+			}
+		};
+
+		// Reads a scalar. Containers are skipped and reported as Invalid.
+		static SValue ReadScalar(CMessagePackReader& reader)
+		{
+			SValue value;
+			if (reader.Read(value) && (value.m_type == EType::Array || value.m_type == EType::Map))
+			{
+				reader.Skip(value);
+				value.m_type = EType::Invalid;
+			}
+			return value;
+		}
+	};
+
+	template <>
+	class CMessagePackDeserializationResolver::CMessagePackDeserializationResolverType<bool>
+	{
+	public:
+		static void Apply(bool& value, CMessagePackReader& reader)
+		{
+			const SValue att = ReadScalar(reader);
+			if (att.m_type == EType::Bool)
+			{
+				value = att.m_bool;
+			}
+		}
+	};
+
+	// Integers are accepted whatever their encoding, as long as they fit in T
+	template <class T>
+	class CMessagePackDeserializationResolver::CMessagePackDeserializationResolverType<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type>
+	{
+	public:
+		static void Apply(T& value, CMessagePackReader& reader)
+		{
+			const SValue att = ReadScalar(reader);
+			if (att.m_type == EType::Uint && att.m_uint <= static_cast<std::uint64_t>(std::numeric_limits<T>::max()))
+			{
+				value = static_cast<T>(att.m_uint);
+			}
+			else if (att.m_type == EType::Int && std::is_signed<T>::value && att.m_int >= static_cast<std::int64_t>(std::numeric_limits<T>::min()))
+			{
+				value = static_cast<T>(att.m_int);
+			}
+		}
+	};
+
+	template <class T>
+	class CMessagePackDeserializationResolver::CMessagePackDeserializationResolverType<T, typename std::enable_if<std::is_floating_point<T>::value>::type>
+	{
+	public:
+		static void Apply(T& value, CMessagePackReader& reader)
+		{
+			const SValue att = ReadScalar(reader);
+			if (att.m_type == EType::Float || att.m_type == EType::Double)
+			{
+				value = static_cast<T>(att.m_double);
+			}
+			else if (att.m_type == EType::Uint)
+			{
+				value = static_cast<T>(att.m_uint);
+			}
+			else if (att.m_type == EType::Int)
+			{
+				value = static_cast<T>(att.m_int);
+			}
+		}
+	};
+
+	template <class T>
+	class CMessagePackDeserializationResolver::CMessagePackDeserializationResolverType<T, typename std::enable_if<std::is_enum<T>::value>::type>
+	{
+	public:
+		static void Apply(T& value, CMessagePackReader& reader)
+		{
+			std::int32_t number = static_cast<std::int32_t>(value);
+			CMessagePackDeserializationResolverType<std::int32_t>::Apply(number, reader);
+			value = static_cast<T>(number);
+		}
+	};
+
+	template <>
+	class CMessagePackDeserializationResolver::CMessagePackDeserializationResolverType<std::string>
+	{
+	public:
+		static void Apply(std::string& value, CMessagePackReader& reader)
+		{
+			const SValue att = ReadScalar(reader);
+			if (att.m_type == EType::String)
+			{
+				value.assign(att.m_data, att.m_size);
+			}
+		}
+	};
+
+#ifdef DONER_SERIALIZER_HAS_STRING_VIEW
+	// Points into the input buffer, which needs to outlive the view
+	template <>
+	class CMessagePackDeserializationResolver::CMessagePackDeserializationResolverType<std::string_view>
+	{
+	public:
+		static void Apply(std::string_view& value, CMessagePackReader& reader)
+		{
+			const SValue att = ReadScalar(reader);
+			if (att.m_type == EType::String)
+			{
+				value = std::string_view(att.m_data, att.m_size);
+			}
+		}
+	};
+#endif
+
+	template<template<typename, typename> class TT, typename T1, typename T2>
+	class CMessagePackDeserializationResolver::CMessagePackDeserializationResolverType<TT<T1, T2>, typename std::enable_if<!SIsMap<TT<T1, T2>>::value>::type>
+	{
+	public:
+		static void Apply(TT<T1, T2>& value, CMessagePackReader& reader)
+		{
+			SValue att;
+			if (!reader.Read(att))
+			{
+				return;
+			}
+			if (att.m_type != EType::Array)
+			{
+				reader.Skip(att);
+				return;
+			}
+
+			CContainerHelper::Reserve(value, value.size() + att.m_size);
+			for (std::uint32_t index = 0; index < att.m_size && !reader.HasFailed(); ++index)
+			{
+				AddElement(value, reader, CContainerHelper::CanFillInPlace<TT<T1, T2>>());
+			}
+		}
+
+	private:
+		static void AddElement(TT<T1, T2>& value, CMessagePackReader& reader, std::true_type)
+		{
+			value.emplace_back();
+			CMessagePackDeserializationResolver::CMessagePackDeserializationResolverType<T1>::Apply(value.back(), reader);
+		}
+
+		static void AddElement(TT<T1, T2>& value, CMessagePackReader& reader, std::false_type)
+		{
+			T1 element = T1();
+			CMessagePackDeserializationResolver::CMessagePackDeserializationResolverType<T1>::Apply(element, reader);
+			value.push_back(std::move(element));
+		}
+	};
+
+	template <template <typename, typename, typename...> class TT, typename T1, typename T2, typename... Args>
+	class CMessagePackDeserializationResolver::CMessagePackDeserializationResolverType<TT<T1, T2, Args...>, typename std::enable_if<SIsMap<TT<T1, T2, Args...>>::value>::type>
+	{
+	public:
+		static void Apply(TT<T1, T2, Args...>& map, CMessagePackReader& reader)
+		{
+			SValue att;
+			if (!reader.Read(att))
+			{
+				return;
+			}
+			if (att.m_type != EType::Map)
+			{
+				reader.Skip(att);
+				return;
+			}
+
+			CContainerHelper::Reserve(map, map.size() + att.m_size);
+			for (std::uint32_t index = 0; index < att.m_size && !reader.HasFailed(); ++index)
+			{
+				T1 key = T1();
+				CMessagePackDeserializationResolver::CMessagePackDeserializationResolverType<T1>::Apply(key, reader);
+
+				auto it = map.find(key);
+				if (it == map.end())
+				{
+					it = map.emplace(std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple()).first;
+				}
+				else
+				{
+					it->second = T2();
+				}
+				CMessagePackDeserializationResolver::CMessagePackDeserializationResolverType<T2>::Apply(it->second, reader);
+			}
+		}
+	};
+
+	template <class T>
+	class CMessagePackDeserializationResolver::CMessagePackDeserializationResolverType<T, typename std::enable_if<std::is_base_of<ISerializable, T>::value>::type>
+	{
+	public:
+		static void Apply(T& value, CMessagePackReader& reader)
+		{
+			CMessagePackDeserializationResolver::ApplyToObject(value, reader);
+		}
+	};
+
+	class CMessagePackDeserializer
+	{
+	public:
+		// Returns false if the input is truncated or malformed, or has trailing bytes
+		template<class T>
+		static bool Deserialize(T& object, const std::uint8_t* data, std::size_t size)
+		{
+			CMessagePackReader reader(data, size);
+			CMessagePackDeserializationResolver::ApplyToObject(object, reader);
+			return !reader.HasFailed() && reader.IsAtEnd();
+		}
+
+		template<class T>
+		static bool Deserialize(T& object, const std::vector<std::uint8_t>& data)
+		{
+			return Deserialize(object, data.data(), data.size());
+		}
+	};
+}
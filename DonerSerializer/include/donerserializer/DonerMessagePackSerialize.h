@@ -0,0 +1,356 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include <donerserializer/DonerSerializerConfig.h>
+#include <donerserializer/DonerContainerTraits.h>
+#include <donerserializer/ISerializable.h>
+
+#include <donerreflection/DonerReflection.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#ifdef DONER_SERIALIZER_HAS_STRING_VIEW
+#include <string_view>
+#endif
+
+namespace DonerSerializer
+{
+	// Appends MessagePack encoded values to a byte buffer, always using the smallest encoding
+	class CMessagePackWriter
+	{
+	public:
+		explicit CMessagePackWriter(std::vector<std::uint8_t>& output)
+			: m_output(output)
+		{}
+
+		void WriteNil() { Put(0xc0); }
+		void WriteBool(bool value) { Put(value ? 0xc3 : 0xc2); }
+
+		void WriteInt(std::int64_t value)
+		{
+			if (value >= 0)
+			{
+				WriteUint(static_cast<std::uint64_t>(value));
+			}
+			else if (value >= -32)
+			{
+				Put(static_cast<std::uint8_t>(value));
+			}
+			else if (value >= INT8_MIN)
+			{
+				Put(0xd0);
+				PutBigEndian(static_cast<std::uint8_t>(value));
+			}
+			else if (value >= INT16_MIN)
+			{
+				Put(0xd1);
+				PutBigEndian(static_cast<std::uint16_t>(value));
+			}
+			else if (value >= INT32_MIN)
+			{
+				Put(0xd2);
+				PutBigEndian(static_cast<std::uint32_t>(value));
+			}
+			else
+			{
+				Put(0xd3);
+				PutBigEndian(static_cast<std::uint64_t>(value));
+			}
+		}
+
+		void WriteUint(std::uint64_t value)
+		{
+			if (value < 0x80)
+			{
+				Put(static_cast<std::uint8_t>(value));
+			}
+			else if (value <= UINT8_MAX)
+			{
+				Put(0xcc);
+				PutBigEndian(static_cast<std::uint8_t>(value));
+			}
+			else if (value <= UINT16_MAX)
+			{
+				Put(0xcd);
+				PutBigEndian(static_cast<std::uint16_t>(value));
+			}
+			else if (value <= UINT32_MAX)
+			{
+				Put(0xce);
+				PutBigEndian(static_cast<std::uint32_t>(value));
+			}
+			else
+			{
+				Put(0xcf);
+				PutBigEndian(value);
+			}
+		}
+
+		void WriteFloat(float value)
+		{
+			std::uint32_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			Put(0xca);
+			PutBigEndian(bits);
+		}
+
+		void WriteDouble(double value)
+		{
+			std::uint64_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			Put(0xcb);
+			PutBigEndian(bits);
+		}
+
+		void WriteString(const char* data, std::size_t length)
+		{
+			WriteHeader(length, 0xa0, 32, 0xd9, 0xda, 0xdb);
+			m_output.insert(m_output.end(), reinterpret_cast<const std::uint8_t*>(data), reinterpret_cast<const std::uint8_t*>(data) + length);
+		}
+
+		void WriteArrayHeader(std::size_t size) { WriteHeader(size, 0x90, 16, 0, 0xdc, 0xdd); }
+		void WriteMapHeader(std::size_t size) { WriteHeader(size, 0x80, 16, 0, 0xde, 0xdf); }
+
+	private:
+		void Put(std::uint8_t byte) { m_output.push_back(byte); }
+
+		template<class T>
+		void PutBigEndian(T value)
+		{
+			for (std::size_t shift = sizeof(T) * 8; shift > 0; shift -= 8)
+			{
+				Put(static_cast<std::uint8_t>(value >> (shift - 8)));
+			}
+		}
+
+		// fixPrefix for sizes under fixLimit, then the 8 (if any), 16 and 32 bits size variants
+		void WriteHeader(std::size_t size, std::uint8_t fixPrefix, std::size_t fixLimit, std::uint8_t prefix8, std::uint8_t prefix16, std::uint8_t prefix32)
+		{
+			if (size < fixLimit)
+			{
+				Put(static_cast<std::uint8_t>(fixPrefix | size));
+			}
+			else if (prefix8 != 0 && size <= UINT8_MAX)
+			{
+				Put(prefix8);
+				PutBigEndian(static_cast<std::uint8_t>(size));
+			}
+			else if (size <= UINT16_MAX)
+			{
+				Put(prefix16);
+				PutBigEndian(static_cast<std::uint16_t>(size));
+			}
+			else
+			{
+				Put(prefix32);
+				PutBigEndian(static_cast<std::uint32_t>(size));
+			}
+		}
+
+		std::vector<std::uint8_t>& m_output;
+	};
+
+	class CMessagePackSerializationResolver
+	{
+	public:
+		// Tag used by CMessagePackSerializationResolverType default implementation.
+		// Members whose type resolver derives from it are skipped, key included.
+		class CUnsupportedType
+		{};
+
+		template<typename MainClassType, typename MemberType>
+		static void Apply(const DonerReflection::SProperty<MainClassType, MemberType>& property, const MainClassType& object, CMessagePackWriter& writer)
+		{
+			ApplyIfSupported(property, object, writer, IsUnsupported<MemberType>());
+		}
+
+		// Objects are maps from property name to value
+		template<class T>
+		static void SerializeObject(const T& object, CMessagePackWriter& writer)
+		{
+			std::size_t memberCount = 0;
+			APPLY_RESOLVER_WITH_PARAMS_TO_CONST_OBJECT(object, CMemberCounter, memberCount)
+			writer.WriteMapHeader(memberCount);
+			APPLY_RESOLVER_WITH_PARAMS_TO_CONST_OBJECT(object, CMessagePackSerializationResolver, writer)
+		}
+
+		template <class T, class Enable = void>
+		class CMessagePackSerializationResolverType : public CUnsupportedType
+		{
+		public:
+			static void Serialize(const T& value, CMessagePackWriter& writer)
+			{}
+		};
+
+	private:
+		template<class T>
+		using IsUnsupported = std::is_base_of<CUnsupportedType, CMessagePackSerializationResolverType<T>>;
+
+		// The map header goes first, so supported members are counted beforehand
+		class CMemberCounter
+		{
+		public:
+			template<typename MainClassType, typename MemberType>
+			static void Apply(const DonerReflection::SProperty<MainClassType, MemberType>& property, const MainClassType& object, std::size_t& memberCount)
+			{
+				memberCount += IsUnsupported<MemberType>::value ? 0 : 1;
+			}
+		};
+
+		template<typename MainClassType, typename MemberType>
+		static void ApplyIfSupported(const DonerReflection::SProperty<MainClassType, MemberType>& property, const MainClassType& object, CMessagePackWriter& writer, std::false_type)
+		{
+			writer.WriteString(property.m_name, std::strlen(property.m_name));
+			CMessagePackSerializationResolverType<MemberType>::Serialize(object.*(property.m_member), writer);
+		}
+
+		template<typename MainClassType, typename MemberType>
+		static void ApplyIfSupported(const DonerReflection::SProperty<MainClassType, MemberType>& property, const MainClassType& object, CMessagePackWriter& writer, std::true_type)
+		{}
+	};
+
+	template <class T>
+	class CMessagePackSerializationResolver::CMessagePackSerializationResolverType<T, typename std::enable_if<std::is_integral<T>::value || std::is_floating_point<T>::value>::type>
+	{
+	public:
+		static void Serialize(const T& value, CMessagePackWriter& writer)
+		{
+			Write(value, writer, std::integral_constant<bool, std::is_signed<T>::value>());
+		}
+
+	private:
+		static void Write(bool value, CMessagePackWriter& writer, std::false_type) { writer.WriteBool(value); }
+		static void Write(float value, CMessagePackWriter& writer, std::true_type) { writer.WriteFloat(value); }
+		static void Write(double value, CMessagePackWriter& writer, std::true_type) { writer.WriteDouble(value); }
+		static void Write(long double value, CMessagePackWriter& writer, std::true_type) { writer.WriteDouble(static_cast<double>(value)); }
+
+		template<class U>
+		static void Write(U value, CMessagePackWriter& writer, std::true_type) { writer.WriteInt(static_cast<std::int64_t>(value)); }
+		template<class U>
+		static void Write(U value, CMessagePackWriter& writer, std::false_type) { writer.WriteUint(static_cast<std::uint64_t>(value)); }
+	};
+
+	template <class T>
+	class CMessagePackSerializationResolver::CMessagePackSerializationResolverType<T, typename std::enable_if<std::is_enum<T>::value>::type>
+	{
+	public:
+		static void Serialize(const T& value, CMessagePackWriter& writer)
+		{
+			writer.WriteInt(static_cast<std::int32_t>(value));
+		}
+	};
+
+	template <>
+	class CMessagePackSerializationResolver::CMessagePackSerializationResolverType<std::string>
+	{
+	public:
+		static void Serialize(const std::string& value, CMessagePackWriter& writer)
+		{
+			writer.WriteString(value.data(), value.size());
+		}
+	};
+
+#ifdef DONER_SERIALIZER_HAS_STRING_VIEW
+	template <>
+	class CMessagePackSerializationResolver::CMessagePackSerializationResolverType<std::string_view>
+	{
+	public:
+		static void Serialize(const std::string_view& value, CMessagePackWriter& writer)
+		{
+			writer.WriteString(value.data(), value.size());
+		}
+	};
+#endif
+
+	template<template<typename, typename> class TT, typename T1, typename T2>
+	class CMessagePackSerializationResolver::CMessagePackSerializationResolverType<TT<T1, T2>, typename std::enable_if<!SIsMap<TT<T1, T2>>::value>::type>
+	{
+	public:
+		static void Serialize(const TT<T1, T2>& value, CMessagePackWriter& writer)
+		{
+			writer.WriteArrayHeader(value.size());
+			for (const auto& member : value)
+			{
+				CMessagePackSerializationResolver::CMessagePackSerializationResolverType<T1>::Serialize(member, writer);
+			}
+		}
+	};
+
+	// Unlike JSON, MessagePack maps accept any key type, so maps are encoded as such
+	template <template <typename, typename, typename...> class TT, typename T1, typename T2, typename... Args>
+	class CMessagePackSerializationResolver::CMessagePackSerializationResolverType<TT<T1, T2, Args...>, typename std::enable_if<SIsMap<TT<T1, T2, Args...>>::value>::type>
+	{
+	public:
+		static void Serialize(const TT<T1, T2, Args...>& value, CMessagePackWriter& writer)
+		{
+			writer.WriteMapHeader(value.size());
+			for (const auto& val : value)
+			{
+				CMessagePackSerializationResolver::CMessagePackSerializationResolverType<T1>::Serialize(val.first, writer);
+				CMessagePackSerializationResolver::CMessagePackSerializationResolverType<T2>::Serialize(val.second, writer);
+			}
+		}
+	};
+
+	template <class T>
+	class CMessagePackSerializationResolver::CMessagePackSerializationResolverType<T, typename std::enable_if<std::is_base_of<ISerializable, T>::value>::type>
+	{
+	public:
+		static void Serialize(const T& value, CMessagePackWriter& writer)
+		{
+			CMessagePackSerializationResolver::SerializeObject(value, writer);
+		}
+	};
+
+	class CMessagePackSerializer
+	{
+	public:
+		// Appends the encoded object to output
+		template<class T>
+		static void Serialize(const T& object, std::vector<std::uint8_t>& output)
+		{
+			CMessagePackWriter writer(output);
+			CMessagePackSerializationResolver::SerializeObject(object, writer);
+		}
+
+		template<class T>
+		static std::vector<std::uint8_t> GetBuffer(const T& object)
+		{
+			std::vector<std::uint8_t> output;
+			Serialize(object, output);
+			return output;
+		}
+	};
+}
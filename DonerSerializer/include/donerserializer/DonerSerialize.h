@@ -27,6 +27,12 @@
 
 #pragma once
 
+#include <donerserializer/DonerSerializerConfig.h>
+#include <donerserializer/DonerContainerTraits.h>
+#include <donerserializer/CBase64.h>
+#include <donerserializer/CBufferedWriteStream.h>
+#include <donerserializer/CCompression.h>
+#include <donerserializer/DonerColumnar.h>
 #include <donerserializer/ISerializable.h>
 
 #include <donerreflection/DonerReflection.h>
@@ -35,30 +41,53 @@
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <ostream>
 #include <string>
+#include <type_traits>
+#include <vector>
+
+#ifdef DONER_SERIALIZER_HAS_PMR
+#include <memory_resource>
+#endif
+
+#ifdef DONER_SERIALIZER_HAS_STRING_VIEW
+#include <string_view>
+#endif
 
 namespace DonerSerializer
 {
 	class CSerializationResolver
 	{
 	public:
-		template<typename MainClassType, typename MemberType>
-		static void Apply(const DonerReflection::SProperty<MainClassType, MemberType>& property, const MainClassType& object, rapidjson::Document& root)
+		// Tag used by CSerializationResolverType default implementation
+		class CUnsupportedType
+		{};
+
+		template<typename MainClassType, typename MemberType, class TValue>
+		static void Apply(const DonerReflection::SProperty<MainClassType, MemberType>& property, const MainClassType& object, TValue& root, typename TValue::AllocatorType& allocator)
 		{
 			if (root.IsNull())
 			{
 				root.SetObject();
 			}
-			CSerializationResolverType<MemberType>::Apply(property.m_name, object.*(property.m_member), root);
+			// root may be a whole document, but members are plain values
+			typename TValue::ValueType& rootValue = root;
+			CSerializationResolverType<MemberType>::Apply(property.m_name, object.*(property.m_member), rootValue, allocator);
 		}
 
 		template <class T, class Enable = void>
-		class CSerializationResolverType
+		class CSerializationResolverType : public CUnsupportedType
 		{
 		public:
-			static void Apply(const char* name, const T& value, rapidjson::Document& root)
+			template <class TValue>
+			static void Apply(const char* name, const T& value, TValue& root, typename TValue::AllocatorType& allocator)
 			{}
-			static void SerializeToJsonArray(rapidjson::Value& root, const T& value, rapidjson::Document::AllocatorType& allocator)
+			template <class TValue>
+			static void SerializeToJsonArray(TValue& root, const T& value, typename TValue::AllocatorType& allocator)
 			{}
 		};
 	};
@@ -67,12 +96,14 @@ namespace DonerSerializer
 	class CSerializationResolver::CSerializationResolverType<T, typename std::enable_if<std::is_integral<T>::value || std::is_floating_point<T>::value>::type>
 	{
 	public:
-		static void Apply(const char* name, const T& value, rapidjson::Document& root)
+		template <class TValue>
+		static void Apply(const char* name, const T& value, TValue& root, typename TValue::AllocatorType& allocator)
 		{
-			root.AddMember(rapidjson::GenericStringRef<char>(name), value, root.GetAllocator());
+			root.AddMember(rapidjson::GenericStringRef<char>(name), value, allocator);
 		}
 
-		static void SerializeToJsonArray(rapidjson::Value& root, const T& value, rapidjson::Document::AllocatorType& allocator)
+		template <class TValue>
+		static void SerializeToJsonArray(TValue& root, const T& value, typename TValue::AllocatorType& allocator)
 		{
 			root.PushBack(value, allocator);
 		}
@@ -82,12 +113,14 @@ namespace DonerSerializer
 	class CSerializationResolver::CSerializationResolverType<T, typename std::enable_if<std::is_enum<T>::value>::type>
 	{
 	public:
-		static void Apply(const char* name, const T& value, rapidjson::Document& root)
+		template <class TValue>
+		static void Apply(const char* name, const T& value, TValue& root, typename TValue::AllocatorType& allocator)
 		{
-			root.AddMember(rapidjson::GenericStringRef<char>(name), static_cast<std::int32_t>(value), root.GetAllocator());
+			root.AddMember(rapidjson::GenericStringRef<char>(name), static_cast<std::int32_t>(value), allocator);
 		}
 
-		static void SerializeToJsonArray(rapidjson::Value& root, const T& value, rapidjson::Document::AllocatorType& allocator)
+		template <class TValue>
+		static void SerializeToJsonArray(TValue& root, const T& value, typename TValue::AllocatorType& allocator)
 		{
 			root.PushBack(static_cast<std::int32_t>(value), allocator);
 		}
@@ -97,65 +130,184 @@ namespace DonerSerializer
 	class CSerializationResolver::CSerializationResolverType<std::string>
 	{
 	public:
-		static void Apply(const char* name, const std::string& value, rapidjson::Document& root)
+		template <class TValue>
+		static void Apply(const char* name, const std::string& value, TValue& root, typename TValue::AllocatorType& allocator)
 		{
-			root.AddMember(rapidjson::GenericStringRef<char>(name), rapidjson::GenericStringRef<char>(value.c_str()), root.GetAllocator());
+			root.AddMember(rapidjson::GenericStringRef<char>(name), rapidjson::GenericStringRef<char>(value.c_str()), allocator);
 		}
 
-		static void SerializeToJsonArray(rapidjson::Value& root, const std::string& value, rapidjson::Document::AllocatorType& allocator)
+		template <class TValue>
+		static void SerializeToJsonArray(TValue& root, const std::string& value, typename TValue::AllocatorType& allocator)
 		{
 			root.PushBack(rapidjson::GenericStringRef<char>(value.c_str()), allocator);
 		}
 	};
 
-	template<template<typename, typename> class TT, typename T1, typename T2>
-	class CSerializationResolver::CSerializationResolverType<TT<T1, T2>>
+#ifdef DONER_SERIALIZER_HAS_PMR
+	template <>
+	class CSerializationResolver::CSerializationResolverType<std::pmr::string>
 	{
 	public:
-		static void Apply(const char* name, const TT<T1, T2>& value, rapidjson::Document& root)
+		template <class TValue>
+		static void Apply(const char* name, const std::pmr::string& value, TValue& root, typename TValue::AllocatorType& allocator)
 		{
-			rapidjson::Value array(rapidjson::kArrayType);
-			for (const auto& member : value)
+			root.AddMember(rapidjson::GenericStringRef<char>(name), rapidjson::GenericStringRef<char>(value.c_str()), allocator);
+		}
+
+		template <class TValue>
+		static void SerializeToJsonArray(TValue& root, const std::pmr::string& value, typename TValue::AllocatorType& allocator)
+		{
+			root.PushBack(rapidjson::GenericStringRef<char>(value.c_str()), allocator);
+		}
+	};
+#endif
+
+#ifdef DONER_SERIALIZER_HAS_STRING_VIEW
+	template <>
+	class CSerializationResolver::CSerializationResolverType<std::string_view>
+	{
+	public:
+		template <class TValue>
+		static void Apply(const char* name, const std::string_view& value, TValue& root, typename TValue::AllocatorType& allocator)
+		{
+			root.AddMember(rapidjson::GenericStringRef<char>(name), rapidjson::GenericStringRef<char>(value.data(), static_cast<rapidjson::SizeType>(value.size())), allocator);
+		}
+
+		template <class TValue>
+		static void SerializeToJsonArray(TValue& root, const std::string_view& value, typename TValue::AllocatorType& allocator)
+		{
+			root.PushBack(rapidjson::GenericStringRef<char>(value.data(), static_cast<rapidjson::SizeType>(value.size())), allocator);
+		}
+	};
+#endif
+
+	// Byte buffers are written as a base64 string instead of an array of numbers
+	template <>
+	class CSerializationResolver::CSerializationResolverType<std::vector<std::uint8_t>>
+	{
+	public:
+		template <class TValue>
+		static void Apply(const char* name, const std::vector<std::uint8_t>& value, TValue& root, typename TValue::AllocatorType& allocator)
+		{
+			root.AddMember(rapidjson::GenericStringRef<char>(name), Encode<TValue>(value, allocator), allocator);
+		}
+
+		template <class TValue>
+		static void SerializeToJsonArray(TValue& root, const std::vector<std::uint8_t>& value, typename TValue::AllocatorType& allocator)
+		{
+			root.PushBack(Encode<TValue>(value, allocator), allocator);
+		}
+
+	private:
+		// Encoded straight into pool allocators, like the default one, so the string isn't copied again.
+		// Allocators that free their blocks get a copy the value owns.
+		template <class TValue>
+		static TValue Encode(const std::vector<std::uint8_t>& value, typename TValue::AllocatorType& allocator)
+		{
+			const std::size_t size = CBase64::GetEncodedSize(value.size());
+			if (TValue::AllocatorType::kNeedFree)
 			{
-				CSerializationResolver::CSerializationResolverType<T1>::SerializeToJsonArray(array, member, root.GetAllocator());
+				std::string encoded(size, '\0');
+				CBase64::Encode(value.data(), value.size(), &encoded[0]);
+				return TValue(encoded.data(), static_cast<rapidjson::SizeType>(size), allocator);
 			}
-			root.AddMember(rapidjson::GenericStringRef<char>(name), array, root.GetAllocator());
+
+			char* buffer = static_cast<char*>(allocator.Malloc(size + 1));
+			CBase64::Encode(value.data(), value.size(), buffer);
+			buffer[size] = '\0';
+			return TValue(rapidjson::GenericStringRef<char>(buffer, static_cast<rapidjson::SizeType>(size)));
+		}
+	};
+
+	template<template<typename, typename> class TT, typename T1, typename T2>
+	class CSerializationResolver::CSerializationResolverType<TT<T1, T2>, typename std::enable_if<!SIsMap<TT<T1, T2>>::value>::type>
+	{
+	public:
+		template <class TValue>
+		static void Apply(const char* name, const TT<T1, T2>& value, TValue& root, typename TValue::AllocatorType& allocator)
+		{
+			TValue array;
+			Serialize(value, array, allocator, SSerializeAsColumns<T1>());
+			root.AddMember(rapidjson::GenericStringRef<char>(name), array, allocator);
+		}
+
+		template <class TValue>
+		static void SerializeToJsonArray(TValue& root, const TT<T1, T2>& value, typename TValue::AllocatorType& allocator)
+		{
+			TValue array;
+			Serialize(value, array, allocator, SSerializeAsColumns<T1>());
+			root.PushBack(array, allocator);
 		}
 
-		static void SerializeToJsonArray(rapidjson::Value& root, const TT<T1, T2>& value, rapidjson::Document::AllocatorType& allocator)
+	private:
+		// One array per property of T1, all of them as long as the sequence
+		class CColumnResolver
 		{
-			rapidjson::Value array(rapidjson::kArrayType);
+		public:
+			template<typename MainClassType, typename MemberType, class TValue>
+			static void Apply(const DonerReflection::SProperty<MainClassType, MemberType>& property, const MainClassType& object, const TT<T1, T2>& value, TValue& columns, typename TValue::AllocatorType& allocator)
+			{
+				if (std::is_base_of<CUnsupportedType, CSerializationResolver::CSerializationResolverType<MemberType>>::value)
+				{
+					return;
+				}
+
+				TValue column(rapidjson::kArrayType);
+				column.Reserve(static_cast<rapidjson::SizeType>(value.size()), allocator);
+				for (const auto& member : value)
+				{
+					CSerializationResolver::CSerializationResolverType<MemberType>::SerializeToJsonArray(column, member.*(property.m_member), allocator);
+				}
+				columns.AddMember(rapidjson::GenericStringRef<char>(property.m_name), column, allocator);
+			}
+		};
+
+		template <class TValue>
+		static void Serialize(const TT<T1, T2>& value, TValue& array, typename TValue::AllocatorType& allocator, std::false_type)
+		{
+			array.SetArray();
 			for (const auto& member : value)
 			{
 				CSerializationResolver::CSerializationResolverType<T1>::SerializeToJsonArray(array, member, allocator);
 			}
-			root.PushBack(array, allocator);
+		}
+
+		template <class TValue>
+		static void Serialize(const TT<T1, T2>& value, TValue& columns, typename TValue::AllocatorType& allocator, std::true_type)
+		{
+			columns.SetObject();
+			if (!value.empty())
+			{
+				APPLY_RESOLVER_WITH_PARAMS_TO_CONST_OBJECT(*value.begin(), CColumnResolver, value, columns, allocator)
+			}
 		}
 	};
 
 	template <template <typename, typename, typename...> class TT, typename T1, typename T2, typename... Args>
-	class CSerializationResolver::CSerializationResolverType<TT<T1, T2, Args...>>
+	class CSerializationResolver::CSerializationResolverType<TT<T1, T2, Args...>, typename std::enable_if<SIsMap<TT<T1, T2, Args...>>::value>::type>
 	{
 	public:
-		static void Apply(const char* name, const TT<T1, T2, Args...>& value, rapidjson::Document& root)
+		template <class TValue>
+		static void Apply(const char* name, const TT<T1, T2, Args...>& value, TValue& root, typename TValue::AllocatorType& allocator)
 		{
-			rapidjson::Value array(rapidjson::kArrayType);
+			TValue array(rapidjson::kArrayType);
 			for (const auto& val : value)
 			{
-				rapidjson::Value element(rapidjson::kArrayType);
-				CSerializationResolver::CSerializationResolverType<T1>::SerializeToJsonArray(element, val.first, root.GetAllocator());
-				CSerializationResolver::CSerializationResolverType<T2>::SerializeToJsonArray(element, val.second, root.GetAllocator());
-				array.PushBack(element, root.GetAllocator());
+				TValue element(rapidjson::kArrayType);
+				CSerializationResolver::CSerializationResolverType<T1>::SerializeToJsonArray(element, val.first, allocator);
+				CSerializationResolver::CSerializationResolverType<T2>::SerializeToJsonArray(element, val.second, allocator);
+				array.PushBack(element, allocator);
 			}
-			root.AddMember(rapidjson::GenericStringRef<char>(name), array, root.GetAllocator());
+			root.AddMember(rapidjson::GenericStringRef<char>(name), array, allocator);
 		}
 
-		static void SerializeToJsonArray(rapidjson::Value& root, const TT<T1, T2, Args...>& value, rapidjson::Document::AllocatorType& allocator)
+		template <class TValue>
+		static void SerializeToJsonArray(TValue& root, const TT<T1, T2, Args...>& value, typename TValue::AllocatorType& allocator)
 		{
-			rapidjson::Value array(rapidjson::kArrayType);
+			TValue array(rapidjson::kArrayType);
 			for (const auto& val : value)
 			{
-				rapidjson::Value element(rapidjson::kArrayType);
+				TValue element(rapidjson::kArrayType);
 				CSerializationResolver::CSerializationResolverType<T1>::SerializeToJsonArray(element, val.first, allocator);
 				CSerializationResolver::CSerializationResolverType<T2>::SerializeToJsonArray(element, val.second, allocator);
 				array.PushBack(element, allocator);
@@ -168,45 +320,102 @@ namespace DonerSerializer
 	class CSerializationResolver::CSerializationResolverType<T, typename std::enable_if<std::is_base_of<ISerializable, T>::value>::type>
 	{
 	public:
-		static void Apply(const char* name, const T& value, rapidjson::Document& root)
+		template <class TValue>
+		static void Apply(const char* name, const T& value, TValue& root, typename TValue::AllocatorType& allocator)
 		{
-			rapidjson::Document document;
-			APPLY_RESOLVER_WITH_PARAMS_TO_CONST_OBJECT(value, CSerializationResolver, document)
-			rapidjson::Value newVal(document, root.GetAllocator());
-			root.AddMember(rapidjson::GenericStringRef<char>(name), newVal, root.GetAllocator());
+			TValue jsonObject;
+			APPLY_RESOLVER_WITH_PARAMS_TO_CONST_OBJECT(value, CSerializationResolver, jsonObject, allocator)
+			root.AddMember(rapidjson::GenericStringRef<char>(name), jsonObject, allocator);
 		}
 
-		static void SerializeToJsonArray(rapidjson::Value& root, const T& value, rapidjson::Document::AllocatorType& allocator)
+		template <class TValue>
+		static void SerializeToJsonArray(TValue& root, const T& value, typename TValue::AllocatorType& allocator)
 		{
-			rapidjson::Document document;
-			APPLY_RESOLVER_WITH_PARAMS_TO_CONST_OBJECT(value, CSerializationResolver, document)
-			rapidjson::Value newVal(document, allocator);
-			root.PushBack(newVal, allocator);
+			TValue jsonObject;
+			APPLY_RESOLVER_WITH_PARAMS_TO_CONST_OBJECT(value, CSerializationResolver, jsonObject, allocator)
+			root.PushBack(jsonObject, allocator);
 		}
 	};
 
 	class CJsonSerializer
 	{
 	public:
-		template<class T>
-		static void Serialize(T& object, rapidjson::Document& document)
+		// Any rapidjson::GenericDocument works, so values can come from a custom allocator, like a
+		// per-frame arena. Its encoding needs char units, as the reflected names are char strings.
+		template<class T, class Encoding, class Allocator, class StackAllocator>
+		static void Serialize(T& object, rapidjson::GenericDocument<Encoding, Allocator, StackAllocator>& document)
 		{
-			APPLY_RESOLVER_WITH_PARAMS_TO_OBJECT(object, CSerializationResolver, document)
+			static_assert(std::is_same<typename Encoding::Ch, char>::value, "The document encoding needs char units");
+			APPLY_RESOLVER_WITH_PARAMS_TO_OBJECT(object, CSerializationResolver, document, document.GetAllocator())
 		}
 
-		template<class T>
-		static void Serialize(const T& object, rapidjson::Document& document)
+		template<class T, class Encoding, class Allocator, class StackAllocator>
+		static void Serialize(const T& object, rapidjson::GenericDocument<Encoding, Allocator, StackAllocator>& document)
 		{
-			APPLY_RESOLVER_WITH_PARAMS_TO_CONST_OBJECT(object, CSerializationResolver, document)
+			static_assert(std::is_same<typename Encoding::Ch, char>::value, "The document encoding needs char units");
+			APPLY_RESOLVER_WITH_PARAMS_TO_CONST_OBJECT(object, CSerializationResolver, document, document.GetAllocator())
 		}
 
-		static std::string GetJsonString(const rapidjson::Document& document)
+		template<class Encoding, class Allocator, class StackAllocator>
+		static std::string GetJsonString(const rapidjson::GenericDocument<Encoding, Allocator, StackAllocator>& document)
 		{
 			rapidjson::StringBuffer strbuf;
 			strbuf.Clear();
 			rapidjson::Writer<rapidjson::StringBuffer> writer(strbuf);
 			document.Accept(writer);
-			return std::string(strbuf.GetString());
+			return std::string(strbuf.GetString(), strbuf.GetSize());
+		}
+
+		static const std::size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+		// Like the CJsonStreamSerializer ones, but object goes through a document first. Output is
+		// written through a single buffer of bufferSize bytes. They return false if any write failed.
+		template<class T>
+		static bool SerializeToFile(const T& object, const char* path, std::size_t bufferSize = DEFAULT_BUFFER_SIZE)
+		{
+			std::FILE* file = std::fopen(path, "wb");
+			if (file == nullptr)
+			{
+				return false;
+			}
+			const bool success = SerializeToStream(object, file, bufferSize);
+			return (std::fclose(file) == 0) && success;
+		}
+
+		template<class T>
+		static bool SerializeToStream(const T& object, std::FILE* file, std::size_t bufferSize = DEFAULT_BUFFER_SIZE)
+		{
+			CJsonSerializer serializer;
+			serializer.Serialize(object);
+			return serializer.Write(CFileSink(file), bufferSize) && std::fflush(file) == 0;
+		}
+
+		template<class T>
+		static bool SerializeToStream(const T& object, int fileDescriptor, std::size_t bufferSize = DEFAULT_BUFFER_SIZE)
+		{
+			CJsonSerializer serializer;
+			serializer.Serialize(object);
+			return serializer.Write(CFileDescriptorSink(fileDescriptor), bufferSize);
+		}
+
+		template<class T>
+		static bool SerializeToStream(const T& object, std::ostream& stream, std::size_t bufferSize = DEFAULT_BUFFER_SIZE)
+		{
+			CJsonSerializer serializer;
+			serializer.Serialize(object);
+			return serializer.Write(COStreamSink(stream), bufferSize) && stream.flush();
+		}
+
+		// A default constructed serializer behaves like a one-shot one: its document keeps its own
+		// allocator until Reset() or SerializeNext() are first called. From then on, the document
+		// allocates from a buffer owned by the serializer, which Reset() keeps along with the output
+		// string buffer, so a long-lived serializer stops reallocating once warmed up.
+		CJsonSerializer() {}
+
+		// Pre-sizes that buffer with capacity bytes, for serializers reused from the start
+		explicit CJsonSerializer(std::size_t capacity)
+		{
+			Reserve(capacity);
 		}
 
 		template<class T>
@@ -214,7 +423,7 @@ namespace DonerSerializer
 		{
 			if (m_document.IsNull())
 			{
-				APPLY_RESOLVER_WITH_PARAMS_TO_OBJECT(object, CSerializationResolver, m_document)
+				APPLY_RESOLVER_WITH_PARAMS_TO_OBJECT(object, CSerializationResolver, m_document, m_document.GetAllocator())
 				return true;
 			}
 			return false;
@@ -225,24 +434,102 @@ namespace DonerSerializer
 		{
 			if (m_document.IsNull())
 			{
-				APPLY_RESOLVER_WITH_PARAMS_TO_CONST_OBJECT(object, CSerializationResolver, m_document)
+				APPLY_RESOLVER_WITH_PARAMS_TO_CONST_OBJECT(object, CSerializationResolver, m_document, m_document.GetAllocator())
 				return true;
 			}
 			return false;
 		}
 
+		template<class T>
+		bool SerializeNext(T& object)
+		{
+			Reset();
+			return Serialize(object);
+		}
+
+		void Reset()
+		{
+			if (!m_allocator)
+			{
+				const std::size_t size = m_document.GetAllocator().Size();
+				Reserve(size + size / 2);
+			}
+			else if (m_allocator->Capacity() > m_buffer.size())
+			{
+				const std::size_t capacity = m_allocator->Capacity();
+				Reserve(std::max(capacity + capacity / 2, m_buffer.size() * 2));
+			}
+			else
+			{
+				m_document.SetNull();
+				m_allocator->Clear();
+			}
+			m_stringBuffer.Clear();
+		}
+
 		std::string GetJsonString() const
 		{
-			rapidjson::StringBuffer strbuf;
-			strbuf.Clear();
-			rapidjson::Writer<rapidjson::StringBuffer> writer(strbuf);
+			std::string result;
+			GetJsonString(result);
+			return result;
+		}
+
+		void GetJsonString(std::string& result) const
+		{
+			m_stringBuffer.Clear();
+			rapidjson::Writer<rapidjson::StringBuffer> writer(m_stringBuffer);
+			m_document.Accept(writer);
+			result.assign(m_stringBuffer.GetString(), m_stringBuffer.GetSize());
+		}
+
+		// Writes the document into sink, a bool(const char* data, std::size_t size) functor like CFileSink,
+		// through a single buffer of bufferSize bytes, without building the whole string
+		template<class Sink>
+		bool Write(Sink sink, std::size_t bufferSize = DEFAULT_BUFFER_SIZE) const
+		{
+			std::vector<char> buffer(bufferSize > 0 ? bufferSize : 1);
+			CBufferedWriteStream<Sink> stream(sink, buffer.data(), buffer.size());
+			rapidjson::Writer<CBufferedWriteStream<Sink>> writer(stream);
+			m_document.Accept(writer);
+			stream.Flush();
+			return !stream.HasFailed();
+		}
+
+		// Writes the document through compressor into sink, a bool(const char* data, std::size_t size)
+		// functor like CFileSink, without building the uncompressed string
+		template<class Sink, class Compressor>
+		bool WriteCompressed(Sink sink, Compressor& compressor, std::size_t bufferSize = CCompression::DEFAULT_BUFFER_SIZE) const
+		{
+			CCompressingSink<Compressor, Sink> compressingSink(compressor, sink);
+			std::vector<char> buffer(bufferSize > 0 ? bufferSize : 1);
+			CBufferedWriteStream<CCompressingSink<Compressor, Sink>> stream(compressingSink, buffer.data(), buffer.size());
+			rapidjson::Writer<CBufferedWriteStream<CCompressingSink<Compressor, Sink>>> writer(stream);
 			m_document.Accept(writer);
-			return std::string(strbuf.GetString());
+			stream.Flush();
+			return compressingSink.Finish() && !stream.HasFailed();
 		}
 
 		rapidjson::Document& GetJsonDocument() { return m_document; }
 
+		// Bytes currently reserved for the document values, 0 until the serializer is first reused
+		std::size_t GetCapacity() const { return m_buffer.size(); }
+
 	protected:
+		static const std::size_t MIN_CAPACITY = 1024;
+
+		// Moves the document, emptied, to a new buffer of capacity bytes
+		void Reserve(std::size_t capacity)
+		{
+			std::vector<char> buffer(capacity < MIN_CAPACITY ? MIN_CAPACITY : capacity);
+			std::unique_ptr<rapidjson::MemoryPoolAllocator<>> allocator(new rapidjson::MemoryPoolAllocator<>(buffer.data(), buffer.size()));
+			rapidjson::Document(allocator.get()).Swap(m_document);
+			m_allocator.swap(allocator);
+			m_buffer.swap(buffer);
+		}
+
+		std::vector<char> m_buffer;
+		std::unique_ptr<rapidjson::MemoryPoolAllocator<>> m_allocator;
 		rapidjson::Document m_document;
+		mutable rapidjson::StringBuffer m_stringBuffer;
 	};
 }
@@ -0,0 +1,55 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#define DONER_SERIALIZER_CPP17
+#endif
+
+#if defined(DONER_SERIALIZER_CPP17) && defined(__has_include)
+#if __has_include(<string_view>)
+#define DONER_SERIALIZER_HAS_STRING_VIEW
+#endif
+#if __has_include(<memory_resource>)
+#define DONER_SERIALIZER_HAS_PMR
+#endif
+#endif
+
+// SSSE3 code paths, like the base64 codec's, are built on x86 whatever the compiler flags, and
+// only taken when the CPU supports them. Their functions are marked with DONER_SERIALIZER_TARGET_SSSE3
+// instead of depending on -mssse3, so translation units built with different flags still get the
+// same inline definitions. Define DONER_SERIALIZER_DISABLE_SIMD to always use the scalar ones.
+#if !defined(DONER_SERIALIZER_DISABLE_SIMD) && (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86))
+#define DONER_SERIALIZER_HAS_SSSE3
+#if defined(__GNUC__) || defined(__clang__)
+#define DONER_SERIALIZER_TARGET_SSSE3 __attribute__((target("ssse3")))
+#else
+#define DONER_SERIALIZER_TARGET_SSSE3
+#endif
+#endif
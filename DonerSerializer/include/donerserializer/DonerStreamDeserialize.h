@@ -0,0 +1,691 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include <donerserializer/DonerSerializerConfig.h>
+#include <donerserializer/DonerContainerTraits.h>
+#include <donerserializer/CCompression.h>
+#include <donerserializer/DonerDeserialize.h>
+#include <donerserializer/ISerializable.h>
+
+#include <donerreflection/DonerReflection.h>
+
+#include <rapidjson/document.h>
+#include <rapidjson/memorystream.h>
+#include <rapidjson/reader.h>
+#include <rapidjson/stream.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef DONER_SERIALIZER_HAS_PMR
+#include <memory_resource>
+#endif
+
+#ifdef DONER_SERIALIZER_HAS_STRING_VIEW
+#include <string_view>
+#endif
+
+namespace DonerSerializer
+{
+	// rapidjson Handler that writes the parsed tokens straight into the reflected objects.
+	// It keeps a stack of frames, one per JSON object/array being parsed, and each frame
+	// knows how to route the incoming tokens to its target member.
+	class CStreamDeserializationHandler
+	{
+	public:
+		enum class ETokenType
+		{
+			Value,
+			StartObject,
+			EndObject,
+			StartArray,
+			EndArray
+		};
+
+		struct SToken
+		{
+			ETokenType m_type;
+			// Only valid for ETokenType::Value. Strings reference the reader buffer.
+			const rapidjson::Value* m_value;
+			// Only valid for ETokenType::EndObject and ETokenType::EndArray
+			rapidjson::SizeType m_count;
+		};
+
+		using TApplyFunction = void (*)(CStreamDeserializationHandler& handler, void* target, const SToken& token);
+		using TCapturedFunction = void (*)(void* target, const rapidjson::Value& value);
+		using TTokenFunction = void (*)(CStreamDeserializationHandler& handler, std::size_t frameIndex, const SToken& token);
+		using TKeyFunction = void (*)(CStreamDeserializationHandler& handler, std::size_t frameIndex, const char* key, rapidjson::SizeType length);
+
+		struct SFrame
+		{
+			TTokenFunction m_onToken;
+			TKeyFunction m_onKey;
+			void* m_target;
+			// Member/element that will receive the next token
+			TApplyFunction m_pending;
+			void* m_pendingTarget;
+			TCapturedFunction m_onCaptured;
+			std::size_t m_state;
+		};
+
+		CStreamDeserializationHandler()
+		{
+			m_frames.reserve(16);
+		}
+
+		void PushFrame(TTokenFunction onToken, TKeyFunction onKey, void* target)
+		{
+			m_frames.push_back(SFrame{ onToken, onKey, target, nullptr, nullptr, nullptr, 0 });
+		}
+
+		void PopFrame() { m_frames.pop_back(); }
+
+		SFrame& GetFrame(std::size_t frameIndex) { return m_frames[frameIndex]; }
+
+		std::size_t GetFrameCount() const { return m_frames.size(); }
+
+		// Ignores the whole value starting with token
+		void Skip(const SToken& token)
+		{
+			if (token.m_type == ETokenType::StartObject || token.m_type == ETokenType::StartArray)
+			{
+				PushFrame(&OnSkipToken, &IgnoreKey, nullptr);
+				m_frames.back().m_state = 1;
+			}
+		}
+
+		// Builds a rapidjson::Value out of the value starting with token and hands it
+		// to onCaptured. Used by the types that only know how to read from a DOM.
+		void Capture(void* target, TCapturedFunction onCaptured, const SToken& token)
+		{
+			if (token.m_type == ETokenType::StartObject || token.m_type == ETokenType::StartArray)
+			{
+				m_captureDocument.SetNull();
+				m_captureDocument.GetAllocator().Clear();
+				PushFrame(&OnCaptureToken, &OnCaptureKey, target);
+				m_frames.back().m_onCaptured = onCaptured;
+				OnCaptureToken(*this, m_frames.size() - 1, token);
+			}
+		}
+
+		static void IgnoreKey(CStreamDeserializationHandler& handler, std::size_t frameIndex, const char* key, rapidjson::SizeType length)
+		{}
+
+		// rapidjson Handler interface
+		bool Null() { rapidjson::Value value; return OnValue(value); }
+		bool Bool(bool b) { rapidjson::Value value(b); return OnValue(value); }
+		bool Int(int i) { rapidjson::Value value(i); return OnValue(value); }
+		bool Uint(unsigned u) { rapidjson::Value value(u); return OnValue(value); }
+		bool Int64(std::int64_t i) { rapidjson::Value value(i); return OnValue(value); }
+		bool Uint64(std::uint64_t u) { rapidjson::Value value(u); return OnValue(value); }
+		bool Double(double d) { rapidjson::Value value(d); return OnValue(value); }
+		bool RawNumber(const char* str, rapidjson::SizeType length, bool copy) { return String(str, length, copy); }
+		bool String(const char* str, rapidjson::SizeType length, bool copy) { rapidjson::Value value(rapidjson::StringRef(str, length)); return OnValue(value); }
+		bool StartObject() { return OnToken(SToken{ ETokenType::StartObject, nullptr, 0 }); }
+		bool EndObject(rapidjson::SizeType memberCount) { return OnToken(SToken{ ETokenType::EndObject, nullptr, memberCount }); }
+		bool StartArray() { return OnToken(SToken{ ETokenType::StartArray, nullptr, 0 }); }
+		bool EndArray(rapidjson::SizeType elementCount) { return OnToken(SToken{ ETokenType::EndArray, nullptr, elementCount }); }
+
+		bool Key(const char* str, rapidjson::SizeType length, bool copy)
+		{
+			if (!m_frames.empty())
+			{
+				const std::size_t frameIndex = m_frames.size() - 1;
+				m_frames[frameIndex].m_onKey(*this, frameIndex, str, length);
+			}
+			return true;
+		}
+
+	private:
+		bool OnValue(const rapidjson::Value& value)
+		{
+			return OnToken(SToken{ ETokenType::Value, &value, 0 });
+		}
+
+		bool OnToken(const SToken& token)
+		{
+			if (!m_frames.empty())
+			{
+				const std::size_t frameIndex = m_frames.size() - 1;
+				m_frames[frameIndex].m_onToken(*this, frameIndex, token);
+			}
+			return true;
+		}
+
+		static void OnSkipToken(CStreamDeserializationHandler& handler, std::size_t frameIndex, const SToken& token)
+		{
+			SFrame& frame = handler.m_frames[frameIndex];
+			if (token.m_type == ETokenType::StartObject || token.m_type == ETokenType::StartArray)
+			{
+				++frame.m_state;
+			}
+			else if (token.m_type == ETokenType::EndObject || token.m_type == ETokenType::EndArray)
+			{
+				if (--frame.m_state == 0)
+				{
+					handler.PopFrame();
+				}
+			}
+		}
+
+		static void OnCaptureKey(CStreamDeserializationHandler& handler, std::size_t frameIndex, const char* key, rapidjson::SizeType length)
+		{
+			handler.m_captureDocument.Key(key, length, true);
+		}
+
+		static void OnCaptureToken(CStreamDeserializationHandler& handler, std::size_t frameIndex, const SToken& token)
+		{
+			SFrame& frame = handler.m_frames[frameIndex];
+			rapidjson::Document& document = handler.m_captureDocument;
+			switch (token.m_type)
+			{
+			case ETokenType::StartObject:
+				document.StartObject();
+				++frame.m_state;
+				break;
+			case ETokenType::StartArray:
+				document.StartArray();
+				++frame.m_state;
+				break;
+			case ETokenType::EndObject:
+				document.EndObject(token.m_count);
+				--frame.m_state;
+				break;
+			case ETokenType::EndArray:
+				document.EndArray(token.m_count);
+				--frame.m_state;
+				break;
+			case ETokenType::Value:
+				if (token.m_value->IsString())
+				{
+					document.String(token.m_value->GetString(), token.m_value->GetStringLength(), true);
+				}
+				else
+				{
+					token.m_value->Accept(document);
+				}
+				break;
+			}
+
+			if (frame.m_state == 0)
+			{
+				// The captured events are sitting in the document stack. Populating it with
+				// no extra events moves them into the document root.
+				auto noEvents = [](rapidjson::Document&) { return true; };
+				document.Populate(noEvents);
+
+				TCapturedFunction onCaptured = frame.m_onCaptured;
+				void* target = frame.m_target;
+				handler.PopFrame();
+
+				// The captured document is reused, so views can't point into it
+				CInsituDeserializationScope insituScope(false);
+				onCaptured(target, document);
+			}
+		}
+
+		std::vector<SFrame> m_frames;
+		rapidjson::Document m_captureDocument;
+	};
+
+	class CStreamDeserializationResolver
+	{
+	public:
+		using ETokenType = CStreamDeserializationHandler::ETokenType;
+		using SToken = CStreamDeserializationHandler::SToken;
+
+		template <class T>
+		static void ApplyToTarget(CStreamDeserializationHandler& handler, void* target, const SToken& token)
+		{
+			CStreamDeserializationResolverType<T>::Apply(*static_cast<T*>(target), handler, token);
+		}
+
+		template <class T>
+		static void ApplyToObject(T& object, CStreamDeserializationHandler& handler, const SToken& token)
+		{
+			if (token.m_type == ETokenType::StartObject)
+			{
+				handler.PushFrame(&OnObjectToken<T>, &OnObjectKey<T>, &object);
+			}
+			else
+			{
+				handler.Skip(token);
+			}
+		}
+
+		// Types without a streaming specialization are read with their CDeserializationResolverType,
+		// capturing into a rapidjson::Value only the JSON subtree they own.
+		template <class T, class Enable = void>
+		class CStreamDeserializationResolverType
+		{
+		public:
+			static void Apply(T& value, CStreamDeserializationHandler& handler, const SToken& token)
+			{
+				if (token.m_type == ETokenType::Value)
+				{
+					CDeserializationResolver::CDeserializationResolverType<T>::Apply(value, *token.m_value);
+				}
+				else
+				{
+					handler.Capture(&value, &ApplyCaptured, token);
+				}
+			}
+
+		private:
+			static void ApplyCaptured(void* target, const rapidjson::Value& value)
+			{
+				CDeserializationResolver::CDeserializationResolverType<T>::Apply(*static_cast<T*>(target), value);
+			}
+		};
+
+	private:
+		// Routes the value following a key to its member
+		template<class T>
+		class CPropertyBinder
+		{
+		public:
+			using TFunction = void (*)(T&, CStreamDeserializationHandler::SFrame&);
+
+			template<class Property>
+			static TFunction Bind()
+			{
+				return &Route<Property>;
+			}
+
+		private:
+			template<class Property>
+			static void Route(T& object, CStreamDeserializationHandler::SFrame& frame)
+			{
+				frame.m_pending = &ApplyToTarget<typename Property::TMember>;
+				frame.m_pendingTarget = &Property::GetMember(object);
+			}
+		};
+
+		template <class T>
+		static void OnObjectKey(CStreamDeserializationHandler& handler, std::size_t frameIndex, const char* key, rapidjson::SizeType length)
+		{
+			CStreamDeserializationHandler::SFrame& frame = handler.GetFrame(frameIndex);
+			T& object = *static_cast<T*>(frame.m_target);
+			frame.m_pending = nullptr;
+
+			const auto* entry = CPropertyLookupTable<T, CPropertyBinder<T>>::Get().Find(key, length);
+			if (entry != nullptr)
+			{
+				entry->m_function(object, frame);
+			}
+		}
+
+		template <class T>
+		static void OnObjectToken(CStreamDeserializationHandler& handler, std::size_t frameIndex, const SToken& token)
+		{
+			if (token.m_type == ETokenType::EndObject)
+			{
+				handler.PopFrame();
+				return;
+			}
+
+			CStreamDeserializationHandler::SFrame& frame = handler.GetFrame(frameIndex);
+			CStreamDeserializationHandler::TApplyFunction pending = frame.m_pending;
+			void* pendingTarget = frame.m_pendingTarget;
+			frame.m_pending = nullptr;
+			if (pending != nullptr)
+			{
+				pending(handler, pendingTarget, token);
+			}
+			else
+			{
+				handler.Skip(token);
+			}
+		}
+	};
+
+	template <>
+	class CStreamDeserializationResolver::CStreamDeserializationResolverType<std::string>
+	{
+	public:
+		static void Apply(std::string& value, CStreamDeserializationHandler& handler, const SToken& token)
+		{
+			if (token.m_type == ETokenType::Value)
+			{
+				CDeserializationResolver::CDeserializationResolverType<std::string>::Apply(value, *token.m_value);
+			}
+			else
+			{
+				handler.Skip(token);
+			}
+		}
+	};
+
+#ifdef DONER_SERIALIZER_HAS_PMR
+	template <>
+	class CStreamDeserializationResolver::CStreamDeserializationResolverType<std::pmr::string>
+	{
+	public:
+		static void Apply(std::pmr::string& value, CStreamDeserializationHandler& handler, const SToken& token)
+		{
+			if (token.m_type == ETokenType::Value)
+			{
+				CDeserializationResolver::CDeserializationResolverType<std::pmr::string>::Apply(value, *token.m_value);
+			}
+			else
+			{
+				handler.Skip(token);
+			}
+		}
+	};
+#endif
+
+#ifdef DONER_SERIALIZER_HAS_STRING_VIEW
+	// Only bound by CJsonStreamDeserializer::DeserializeInsitu, pointing into its buffer
+	template <>
+	class CStreamDeserializationResolver::CStreamDeserializationResolverType<std::string_view>
+	{
+	public:
+		static void Apply(std::string_view& value, CStreamDeserializationHandler& handler, const SToken& token)
+		{
+			if (token.m_type == ETokenType::Value)
+			{
+				CDeserializationResolver::CDeserializationResolverType<std::string_view>::Apply(value, *token.m_value);
+			}
+			else
+			{
+				handler.Skip(token);
+			}
+		}
+	};
+#endif
+
+	// Base64 strings are decoded from the token. Arrays of numbers, as written by older versions, are captured.
+	template <>
+	class CStreamDeserializationResolver::CStreamDeserializationResolverType<std::vector<std::uint8_t>>
+	{
+	public:
+		static void Apply(std::vector<std::uint8_t>& value, CStreamDeserializationHandler& handler, const SToken& token)
+		{
+			if (token.m_type == ETokenType::Value)
+			{
+				CDeserializationResolver::CDeserializationResolverType<std::vector<std::uint8_t>>::Apply(value, *token.m_value);
+			}
+			else if (token.m_type == ETokenType::StartArray)
+			{
+				handler.Capture(&value, &ApplyCaptured, token);
+			}
+			else
+			{
+				handler.Skip(token);
+			}
+		}
+
+	private:
+		static void ApplyCaptured(void* target, const rapidjson::Value& value)
+		{
+			CDeserializationResolver::CDeserializationResolverType<std::vector<std::uint8_t>>::Apply(*static_cast<std::vector<std::uint8_t>*>(target), value);
+		}
+	};
+
+	template<template<typename, typename> class TT, typename T1, typename T2>
+	class CStreamDeserializationResolver::CStreamDeserializationResolverType<TT<T1, T2>, typename std::enable_if<!SIsMap<TT<T1, T2>>::value>::type>
+	{
+	public:
+		static void Apply(TT<T1, T2>& value, CStreamDeserializationHandler& handler, const SToken& token)
+		{
+			if (token.m_type == ETokenType::StartArray)
+			{
+				CContainerHelper::UseMemoryResource(value);
+				handler.PushFrame(&OnToken, &CStreamDeserializationHandler::IgnoreKey, &value);
+			}
+			else if (token.m_type == ETokenType::StartObject && SSerializeAsColumns<T1>::value)
+			{
+				handler.Capture(&value, &ApplyCapturedColumns, token);
+			}
+			else
+			{
+				handler.Skip(token);
+			}
+		}
+
+	private:
+		// Every column is needed before any element is complete, so they're read from a DOM
+		static void ApplyCapturedColumns(void* target, const rapidjson::Value& value)
+		{
+			CDeserializationResolver::CDeserializationResolverType<TT<T1, T2>>::Apply(*static_cast<TT<T1, T2>*>(target), value);
+		}
+
+		static void OnToken(CStreamDeserializationHandler& handler, std::size_t frameIndex, const SToken& token)
+		{
+			if (token.m_type == ETokenType::EndArray)
+			{
+				handler.PopFrame();
+				return;
+			}
+
+			TT<T1, T2>& value = *static_cast<TT<T1, T2>*>(handler.GetFrame(frameIndex).m_target);
+			AddElement(value, handler, token, CContainerHelper::CanFillInPlace<TT<T1, T2>>());
+		}
+
+		// Elements are filled in place, as the frames of composite ones outlive this call
+		static void AddElement(TT<T1, T2>& value, CStreamDeserializationHandler& handler, const SToken& token, std::true_type)
+		{
+			value.emplace_back();
+			CStreamDeserializationResolver::CStreamDeserializationResolverType<T1>::Apply(value.back(), handler, token);
+		}
+
+		// Proxy elements (std::vector<bool>) are scalars resolved from a single token, so a temporary is enough
+		static void AddElement(TT<T1, T2>& value, CStreamDeserializationHandler& handler, const SToken& token, std::false_type)
+		{
+			T1 element = CContainerHelper::MakeElement<T1>(value.get_allocator());
+			CStreamDeserializationResolver::CStreamDeserializationResolverType<T1>::Apply(element, handler, token);
+			value.push_back(std::move(element));
+		}
+	};
+
+	template <template <typename, typename, typename...> class TT, typename T1, typename T2, typename... Args>
+	class CStreamDeserializationResolver::CStreamDeserializationResolverType<TT<T1, T2, Args...>, typename std::enable_if<SIsMap<TT<T1, T2, Args...>>::value>::type>
+	{
+	public:
+		static void Apply(TT<T1, T2, Args...>& map, CStreamDeserializationHandler& handler, const SToken& token)
+		{
+			if (token.m_type == ETokenType::StartArray)
+			{
+				CContainerHelper::UseMemoryResource(map);
+				handler.PushFrame(&OnToken, &CStreamDeserializationHandler::IgnoreKey, &map);
+			}
+			else
+			{
+				handler.Skip(token);
+			}
+		}
+
+	private:
+		enum EPairState : std::size_t
+		{
+			WaitingKey,
+			WaitingValue,
+			WaitingEnd
+		};
+
+		static void OnToken(CStreamDeserializationHandler& handler, std::size_t frameIndex, const SToken& token)
+		{
+			if (token.m_type == ETokenType::EndArray)
+			{
+				handler.PopFrame();
+			}
+			else if (token.m_type == ETokenType::StartArray)
+			{
+				handler.PushFrame(&OnPairToken, &CStreamDeserializationHandler::IgnoreKey, handler.GetFrame(frameIndex).m_target);
+			}
+			else
+			{
+				handler.Skip(token);
+			}
+		}
+
+		// Each [key, value] pair. Keys must be resolved from a single token.
+		static void OnPairToken(CStreamDeserializationHandler& handler, std::size_t frameIndex, const SToken& token)
+		{
+			if (token.m_type == ETokenType::EndArray)
+			{
+				handler.PopFrame();
+				return;
+			}
+
+			CStreamDeserializationHandler::SFrame& frame = handler.GetFrame(frameIndex);
+			if (frame.m_state == WaitingKey)
+			{
+				TT<T1, T2, Args...>& map = *static_cast<TT<T1, T2, Args...>*>(frame.m_target);
+				T1 key = CContainerHelper::MakeElement<T1>(map.get_allocator());
+				if (token.m_type == ETokenType::Value)
+				{
+					CStreamDeserializationResolver::CStreamDeserializationResolverType<T1>::Apply(key, handler, token);
+				}
+
+				auto it = map.find(key);
+				if (it == map.end())
+				{
+					it = map.emplace(std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple()).first;
+				}
+				else
+				{
+					it->second = CContainerHelper::MakeElement<T2>(map.get_allocator());
+				}
+				frame.m_pendingTarget = &(it->second);
+				frame.m_state = WaitingValue;
+				handler.Skip(token);
+			}
+			else if (frame.m_state == WaitingValue)
+			{
+				frame.m_state = WaitingEnd;
+				CStreamDeserializationResolver::CStreamDeserializationResolverType<T2>::Apply(*static_cast<T2*>(frame.m_pendingTarget), handler, token);
+			}
+			else
+			{
+				handler.Skip(token);
+			}
+		}
+	};
+
+	template <class T>
+	class CStreamDeserializationResolver::CStreamDeserializationResolverType<T, typename std::enable_if<std::is_base_of<ISerializable, T>::value>::type>
+	{
+	public:
+		static void Apply(T& value, CStreamDeserializationHandler& handler, const SToken& token)
+		{
+			CStreamDeserializationResolver::ApplyToObject(value, handler, token);
+		}
+	};
+
+	class CJsonStreamDeserializer
+	{
+	public:
+		template<class T>
+		static bool Deserialize(T& object, const char* const jsonStr)
+		{
+			rapidjson::StringStream stream(jsonStr);
+			return Deserialize(object, stream);
+		}
+
+		// data doesn't need to be null-terminated
+		template<class T>
+		static bool Deserialize(T& object, const char* const data, std::size_t length)
+		{
+			rapidjson::MemoryStream stream(data, length);
+			return Deserialize(object, stream);
+		}
+
+		// data was written through a compressor, and is decompressed by decompressor (CLzDecompressor,
+		// CZlibDecompressor...) a bufferSize chunk at a time while it's parsed
+		template<class T, class Decompressor>
+		static bool DeserializeCompressed(T& object, const char* const data, std::size_t length, Decompressor& decompressor, std::size_t bufferSize = CCompression::DEFAULT_BUFFER_SIZE)
+		{
+			return DeserializeCompressedFromSource(object, CMemorySource(data, length), decompressor, bufferSize);
+		}
+
+		template<class T, class Decompressor>
+		static bool DeserializeCompressedFromFile(T& object, const char* const path, Decompressor& decompressor, std::size_t bufferSize = CCompression::DEFAULT_BUFFER_SIZE)
+		{
+			std::FILE* file = std::fopen(path, "rb");
+			if (file == nullptr)
+			{
+				return false;
+			}
+			const bool success = DeserializeCompressedFromSource(object, CFileSource(file), decompressor, bufferSize);
+			std::fclose(file);
+			return success;
+		}
+
+		// Source is a std::size_t(char* buffer, std::size_t size) functor, like CFileSource
+		template<class T, class Source, class Decompressor>
+		static bool DeserializeCompressedFromSource(T& object, Source source, Decompressor& decompressor, std::size_t bufferSize = CCompression::DEFAULT_BUFFER_SIZE)
+		{
+			CDecompressingReadStream<Decompressor, Source> stream(decompressor, source, bufferSize);
+			return Deserialize(object, stream) && !stream.HasFailed();
+		}
+
+		// InputStream can be any rapidjson input stream (rapidjson::FileReadStream, rapidjson::IStreamWrapper...)
+		template<class T, class InputStream>
+		static bool Deserialize(T& object, InputStream& stream)
+		{
+			return Parse<rapidjson::kParseDefaultFlags>(object, stream);
+		}
+
+		// Strings are decoded in place inside buffer, which gets modified, and copied only once
+		// into their final member. std::string_view members point into buffer.
+		template<class T>
+		static bool DeserializeInsitu(T& object, char* buffer)
+		{
+			CInsituDeserializationScope insituScope;
+			rapidjson::InsituStringStream stream(buffer);
+			return Parse<rapidjson::kParseInsituFlag>(object, stream);
+		}
+
+	private:
+		template<unsigned ParseFlags, class T, class InputStream>
+		static bool Parse(T& object, InputStream& stream)
+		{
+			CStreamDeserializationHandler handler;
+			handler.PushFrame(&OnRootToken<T>, &CStreamDeserializationHandler::IgnoreKey, &object);
+
+			rapidjson::Reader reader;
+			return !reader.Parse<ParseFlags>(stream, handler).IsError();
+		}
+
+		template<class T>
+		static void OnRootToken(CStreamDeserializationHandler& handler, std::size_t frameIndex, const CStreamDeserializationHandler::SToken& token)
+		{
+			CStreamDeserializationResolver::ApplyToObject(*static_cast<T*>(handler.GetFrame(frameIndex).m_target), handler, token);
+		}
+	};
+}
@@ -0,0 +1,497 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include <donerserializer/DonerSerializerConfig.h>
+#include <donerserializer/DonerContainerTraits.h>
+#include <donerserializer/CBase64.h>
+#include <donerserializer/CBufferedWriteStream.h>
+#include <donerserializer/CCompression.h>
+#include <donerserializer/CParallel.h>
+#include <donerserializer/DonerColumnar.h>
+#include <donerserializer/ISerializable.h>
+
+#include <donerreflection/DonerReflection.h>
+
+#include <rapidjson/rapidjson.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#ifdef DONER_SERIALIZER_HAS_PMR
+#include <memory_resource>
+#endif
+
+#ifdef DONER_SERIALIZER_HAS_STRING_VIEW
+#include <string_view>
+#endif
+
+namespace DonerSerializer
+{
+	// Emits the SAX events of the reflected data straight into any rapidjson Handler
+	// (rapidjson::Writer, rapidjson::Document...) without building an intermediate DOM.
+	class CStreamSerializationResolver
+	{
+	public:
+		// Tag used by CStreamSerializationResolverType default implementation.
+		// Members whose type resolver derives from it are skipped, key included.
+		class CUnsupportedType
+		{};
+
+		template<typename MainClassType, typename MemberType, typename Handler>
+		static void Apply(const DonerReflection::SProperty<MainClassType, MemberType>& property, const MainClassType& object, Handler& handler, rapidjson::SizeType& memberCount)
+		{
+			ApplyIfSupported(property, object, handler, memberCount, std::is_base_of<CUnsupportedType, CStreamSerializationResolverType<MemberType>>());
+		}
+
+		template <class T, class Enable = void>
+		class CStreamSerializationResolverType : public CUnsupportedType
+		{
+		public:
+			template <class Handler>
+			static void SerializeToHandler(const T& value, Handler& handler)
+			{}
+		};
+
+	private:
+		template<typename MainClassType, typename MemberType, typename Handler>
+		static void ApplyIfSupported(const DonerReflection::SProperty<MainClassType, MemberType>& property, const MainClassType& object, Handler& handler, rapidjson::SizeType& memberCount, std::false_type)
+		{
+			handler.Key(property.m_name, static_cast<rapidjson::SizeType>(std::strlen(property.m_name)), false);
+			CStreamSerializationResolverType<MemberType>::SerializeToHandler(object.*(property.m_member), handler);
+			++memberCount;
+		}
+
+		template<typename MainClassType, typename MemberType, typename Handler>
+		static void ApplyIfSupported(const DonerReflection::SProperty<MainClassType, MemberType>& property, const MainClassType& object, Handler& handler, rapidjson::SizeType& memberCount, std::true_type)
+		{}
+	};
+
+	template <class T>
+	class CStreamSerializationResolver::CStreamSerializationResolverType<T, typename std::enable_if<std::is_integral<T>::value || std::is_floating_point<T>::value>::type>
+	{
+	public:
+		template <class Handler>
+		static void SerializeToHandler(const T& value, Handler& handler)
+		{
+			Write(value, handler);
+		}
+
+	private:
+		template <class Handler>
+		static void Write(bool value, Handler& handler) { handler.Bool(value); }
+		template <class Handler>
+		static void Write(std::int32_t value, Handler& handler) { handler.Int(value); }
+		template <class Handler>
+		static void Write(std::uint32_t value, Handler& handler) { handler.Uint(value); }
+		template <class Handler>
+		static void Write(std::int64_t value, Handler& handler) { handler.Int64(value); }
+		template <class Handler>
+		static void Write(std::uint64_t value, Handler& handler) { handler.Uint64(value); }
+		template <class Handler>
+		static void Write(double value, Handler& handler) { handler.Double(value); }
+	};
+
+	template <class T>
+	class CStreamSerializationResolver::CStreamSerializationResolverType<T, typename std::enable_if<std::is_enum<T>::value>::type>
+	{
+	public:
+		template <class Handler>
+		static void SerializeToHandler(const T& value, Handler& handler)
+		{
+			handler.Int(static_cast<std::int32_t>(value));
+		}
+	};
+
+	template <>
+	class CStreamSerializationResolver::CStreamSerializationResolverType<std::string>
+	{
+	public:
+		template <class Handler>
+		static void SerializeToHandler(const std::string& value, Handler& handler)
+		{
+			handler.String(value.c_str(), static_cast<rapidjson::SizeType>(value.size()), false);
+		}
+	};
+
+#ifdef DONER_SERIALIZER_HAS_PMR
+	template <>
+	class CStreamSerializationResolver::CStreamSerializationResolverType<std::pmr::string>
+	{
+	public:
+		template <class Handler>
+		static void SerializeToHandler(const std::pmr::string& value, Handler& handler)
+		{
+			handler.String(value.c_str(), static_cast<rapidjson::SizeType>(value.size()), false);
+		}
+	};
+#endif
+
+#ifdef DONER_SERIALIZER_HAS_STRING_VIEW
+	template <>
+	class CStreamSerializationResolver::CStreamSerializationResolverType<std::string_view>
+	{
+	public:
+		template <class Handler>
+		static void SerializeToHandler(const std::string_view& value, Handler& handler)
+		{
+			handler.String(value.data(), static_cast<rapidjson::SizeType>(value.size()), false);
+		}
+	};
+#endif
+
+	// Byte buffers are written as a base64 string instead of an array of numbers
+	template <>
+	class CStreamSerializationResolver::CStreamSerializationResolverType<std::vector<std::uint8_t>>
+	{
+	public:
+		template <class Handler>
+		static void SerializeToHandler(const std::vector<std::uint8_t>& value, Handler& handler)
+		{
+			std::string encoded(CBase64::GetEncodedSize(value.size()), '\0');
+			CBase64::Encode(value.data(), value.size(), &encoded[0]);
+			handler.String(encoded.data(), static_cast<rapidjson::SizeType>(encoded.size()), true);
+		}
+	};
+
+	template<template<typename, typename> class TT, typename T1, typename T2>
+	class CStreamSerializationResolver::CStreamSerializationResolverType<TT<T1, T2>, typename std::enable_if<!SIsMap<TT<T1, T2>>::value>::type>
+	{
+	public:
+		template <class Handler>
+		static void SerializeToHandler(const TT<T1, T2>& value, Handler& handler)
+		{
+			Serialize(value, handler, SSerializeAsColumns<T1>());
+		}
+
+	private:
+		// One array per property of T1, all of them as long as the sequence
+		class CColumnResolver
+		{
+		public:
+			template<typename MainClassType, typename MemberType, typename Handler>
+			static void Apply(const DonerReflection::SProperty<MainClassType, MemberType>& property, const MainClassType& object, const TT<T1, T2>& value, Handler& handler, rapidjson::SizeType& memberCount)
+			{
+				if (std::is_base_of<CUnsupportedType, CStreamSerializationResolver::CStreamSerializationResolverType<MemberType>>::value)
+				{
+					return;
+				}
+
+				rapidjson::SizeType elementCount = 0;
+				handler.Key(property.m_name, static_cast<rapidjson::SizeType>(std::strlen(property.m_name)), false);
+				handler.StartArray();
+				for (const auto& member : value)
+				{
+					CStreamSerializationResolver::CStreamSerializationResolverType<MemberType>::SerializeToHandler(member.*(property.m_member), handler);
+					++elementCount;
+				}
+				handler.EndArray(elementCount);
+				++memberCount;
+			}
+		};
+
+		template <class Handler>
+		static void Serialize(const TT<T1, T2>& value, Handler& handler, std::false_type)
+		{
+			rapidjson::SizeType elementCount = 0;
+			handler.StartArray();
+			for (const auto& member : value)
+			{
+				CStreamSerializationResolver::CStreamSerializationResolverType<T1>::SerializeToHandler(member, handler);
+				++elementCount;
+			}
+			handler.EndArray(elementCount);
+		}
+
+		template <class Handler>
+		static void Serialize(const TT<T1, T2>& value, Handler& handler, std::true_type)
+		{
+			rapidjson::SizeType memberCount = 0;
+			handler.StartObject();
+			if (!value.empty())
+			{
+				APPLY_RESOLVER_WITH_PARAMS_TO_CONST_OBJECT(*value.begin(), CColumnResolver, value, handler, memberCount)
+			}
+			handler.EndObject(memberCount);
+		}
+	};
+
+	template <template <typename, typename, typename...> class TT, typename T1, typename T2, typename... Args>
+	class CStreamSerializationResolver::CStreamSerializationResolverType<TT<T1, T2, Args...>, typename std::enable_if<SIsMap<TT<T1, T2, Args...>>::value>::type>
+	{
+	public:
+		template <class Handler>
+		static void SerializeToHandler(const TT<T1, T2, Args...>& value, Handler& handler)
+		{
+			rapidjson::SizeType elementCount = 0;
+			handler.StartArray();
+			for (const auto& val : value)
+			{
+				handler.StartArray();
+				CStreamSerializationResolver::CStreamSerializationResolverType<T1>::SerializeToHandler(val.first, handler);
+				CStreamSerializationResolver::CStreamSerializationResolverType<T2>::SerializeToHandler(val.second, handler);
+				handler.EndArray(2);
+				++elementCount;
+			}
+			handler.EndArray(elementCount);
+		}
+	};
+
+	template <class T>
+	class CStreamSerializationResolver::CStreamSerializationResolverType<T, typename std::enable_if<std::is_base_of<ISerializable, T>::value>::type>
+	{
+	public:
+		template <class Handler>
+		static void SerializeToHandler(const T& value, Handler& handler)
+		{
+			rapidjson::SizeType memberCount = 0;
+			handler.StartObject();
+			APPLY_RESOLVER_WITH_PARAMS_TO_CONST_OBJECT(value, CStreamSerializationResolver, handler, memberCount)
+			handler.EndObject(memberCount);
+		}
+	};
+
+	class CJsonStreamSerializer
+	{
+	public:
+		template<class T, class Handler>
+		static void Serialize(const T& object, Handler& handler)
+		{
+			rapidjson::SizeType memberCount = 0;
+			handler.StartObject();
+			APPLY_RESOLVER_WITH_PARAMS_TO_CONST_OBJECT(object, CStreamSerializationResolver, handler, memberCount)
+			handler.EndObject(memberCount);
+		}
+
+		template<class T>
+		static std::string GetJsonString(const T& object)
+		{
+			rapidjson::StringBuffer strbuf;
+			rapidjson::Writer<rapidjson::StringBuffer> writer(strbuf);
+			Serialize(object, writer);
+			return std::string(strbuf.GetString(), strbuf.GetSize());
+		}
+
+		// Serializes a container of reflected objects as a top-level JSON array
+		template<class Container, class Handler>
+		static void SerializeArray(const Container& objects, Handler& handler)
+		{
+			rapidjson::SizeType elementCount = 0;
+			handler.StartArray();
+			for (const auto& object : objects)
+			{
+				Serialize(object, handler);
+				++elementCount;
+			}
+			handler.EndArray(elementCount);
+		}
+
+		// Same output as SerializeArray, byte by byte. The container needs random access. Ranges of
+		// rangeSize objects are serialized on up to threadCount threads (0 means one per hardware thread)
+		// into their own buffers, which are handed to sink in order as soon as the previous ones are.
+		// Workers don't start a range more than IN_FLIGHT_RANGES_PER_THREAD ranges per thread ahead of
+		// the next one to write, so a slow range doesn't let the whole output pile up in memory, and
+		// the buffers are reused. Sink is a bool(const char* data, std::size_t size) functor, like
+		// CFileSink. Once it fails, ranges not yet started are skipped.
+		template<class Container, class Sink>
+		static bool SerializeArrayParallel(const Container& objects, Sink sink, std::size_t threadCount = 0, std::size_t rangeSize = DEFAULT_RANGE_SIZE)
+		{
+			const std::size_t count = objects.size();
+			rangeSize = (rangeSize > 0) ? rangeSize : 1;
+			const std::size_t rangeCount = (count + rangeSize - 1) / rangeSize;
+			threadCount = CParallel::GetThreadCount(threadCount);
+
+			const std::size_t window = threadCount * IN_FLIGHT_RANGES_PER_THREAD;
+			std::vector<rapidjson::StringBuffer> buffers(std::min(window, rangeCount));
+			std::vector<bool> done(buffers.size(), false);
+			std::size_t nextToWrite = 0;
+			std::mutex writeMutex;
+			std::condition_variable writtenCondition;
+			bool success = sink("[", 1);
+
+			CParallel::For(rangeCount, threadCount, [&](std::size_t rangeIndex, std::size_t)
+			{
+				{
+					std::unique_lock<std::mutex> lock(writeMutex);
+					writtenCondition.wait(lock, [&]() { return !success || rangeIndex - nextToWrite < window; });
+					if (!success)
+					{
+						return;
+					}
+				}
+
+				try
+				{
+					rapidjson::StringBuffer& buffer = buffers[rangeIndex % buffers.size()];
+					rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+					const std::size_t begin = rangeIndex * rangeSize;
+					const std::size_t end = std::min(begin + rangeSize, count);
+					for (std::size_t index = begin; index < end; ++index)
+					{
+						if (index != begin)
+						{
+							buffer.Put(',');
+							writer.Reset(buffer);
+						}
+						Serialize(objects[index], writer);
+					}
+
+					{
+						std::lock_guard<std::mutex> lock(writeMutex);
+						done[rangeIndex % buffers.size()] = true;
+						for (; success && nextToWrite < rangeCount && done[nextToWrite % buffers.size()]; ++nextToWrite)
+						{
+							const std::size_t slot = nextToWrite % buffers.size();
+							rapidjson::StringBuffer& readyBuffer = buffers[slot];
+							success = (nextToWrite == 0 || sink(",", 1)) && sink(readyBuffer.GetString(), readyBuffer.GetSize());
+							readyBuffer.Clear();
+							done[slot] = false;
+						}
+					}
+					writtenCondition.notify_all();
+				}
+				catch (...)
+				{
+					// Nobody would write the ranges the other workers are waiting for
+					{
+						std::lock_guard<std::mutex> lock(writeMutex);
+						success = false;
+					}
+					writtenCondition.notify_all();
+					throw;
+				}
+			});
+
+			return sink("]", 1) && success;
+		}
+
+		// threadCount other than 1 goes through SerializeArrayParallel
+		template<class Container>
+		static std::string GetJsonArrayString(const Container& objects, std::size_t threadCount = 1, std::size_t rangeSize = DEFAULT_RANGE_SIZE)
+		{
+			if (threadCount == 1)
+			{
+				rapidjson::StringBuffer strbuf;
+				rapidjson::Writer<rapidjson::StringBuffer> writer(strbuf);
+				SerializeArray(objects, writer);
+				return std::string(strbuf.GetString(), strbuf.GetSize());
+			}
+
+			std::string result;
+			SerializeArrayParallel(objects, [&result](const char* data, std::size_t size)
+			{
+				result.append(data, size);
+				return true;
+			}, threadCount, rangeSize);
+			return result;
+		}
+
+		static const std::size_t DEFAULT_RANGE_SIZE = 1024;
+		static const std::size_t IN_FLIGHT_RANGES_PER_THREAD = 4;
+		static const std::size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+		// The sinks below write through a single buffer of bufferSize bytes, so memory usage
+		// doesn't depend on the size of the output. They return false if any write failed.
+		template<class T>
+		static bool SerializeToFile(const T& object, const char* path, std::size_t bufferSize = DEFAULT_BUFFER_SIZE)
+		{
+			std::FILE* file = std::fopen(path, "wb");
+			if (file == nullptr)
+			{
+				return false;
+			}
+			const bool success = SerializeToStream(object, file, bufferSize);
+			return (std::fclose(file) == 0) && success;
+		}
+
+		template<class T>
+		static bool SerializeToStream(const T& object, std::FILE* file, std::size_t bufferSize = DEFAULT_BUFFER_SIZE)
+		{
+			return SerializeToSink(object, CFileSink(file), bufferSize) && std::fflush(file) == 0;
+		}
+
+		template<class T>
+		static bool SerializeToStream(const T& object, int fileDescriptor, std::size_t bufferSize = DEFAULT_BUFFER_SIZE)
+		{
+			return SerializeToSink(object, CFileDescriptorSink(fileDescriptor), bufferSize);
+		}
+
+		template<class T>
+		static bool SerializeToStream(const T& object, std::ostream& stream, std::size_t bufferSize = DEFAULT_BUFFER_SIZE)
+		{
+			return SerializeToSink(object, COStreamSink(stream), bufferSize) && stream.flush();
+		}
+
+		// Output goes through compressor (CLzCompressor, CZlibCompressor...) a bufferSize chunk at a
+		// time, so the uncompressed text is never held in memory as a whole
+		template<class T, class Compressor>
+		static bool SerializeCompressedToFile(const T& object, const char* path, Compressor& compressor, std::size_t bufferSize = DEFAULT_BUFFER_SIZE)
+		{
+			std::FILE* file = std::fopen(path, "wb");
+			if (file == nullptr)
+			{
+				return false;
+			}
+			const bool success = SerializeCompressedToSink(object, CFileSink(file), compressor, bufferSize);
+			return (std::fclose(file) == 0) && success;
+		}
+
+		// Sink is a bool(const char* data, std::size_t size) functor, like CFileSink or COStreamSink
+		template<class T, class Sink, class Compressor>
+		static bool SerializeCompressedToSink(const T& object, Sink sink, Compressor& compressor, std::size_t bufferSize = DEFAULT_BUFFER_SIZE)
+		{
+			CCompressingSink<Compressor, Sink> compressingSink(compressor, sink);
+			const bool success = SerializeToSink(object, compressingSink, bufferSize);
+			return compressingSink.Finish() && success;
+		}
+
+	private:
+		template<class T, class Sink>
+		static bool SerializeToSink(const T& object, Sink sink, std::size_t bufferSize)
+		{
+			std::vector<char> buffer(bufferSize > 0 ? bufferSize : 1);
+			CBufferedWriteStream<Sink> stream(sink, buffer.data(), buffer.size());
+			rapidjson::Writer<CBufferedWriteStream<Sink>> writer(stream);
+			Serialize(object, writer);
+			stream.Flush();
+			return !stream.HasFailed();
+		}
+	};
+}
@@ -0,0 +1,192 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#include <donerserializer/CBase64.h>
+#include <donerserializer/DonerDeserialize.h>
+#include <donerserializer/DonerSerialize.h>
+#include <donerserializer/DonerStreamDeserialize.h>
+#include <donerserializer/DonerStreamSerialize.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace CBase64TestInternal
+{
+	class CBlob
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CBlob)
+	public:
+		std::vector<std::uint8_t> m_bytes;
+		std::vector<std::vector<std::uint8_t>> m_chunks;
+	};
+
+	std::string Encode(const std::string& text)
+	{
+		std::string result(DonerSerializer::CBase64::GetEncodedSize(text.size()), '\0');
+		DonerSerializer::CBase64::Encode(reinterpret_cast<const std::uint8_t*>(text.data()), text.size(), &result[0]);
+		return result;
+	}
+
+	bool Decode(const std::string& text, std::string& result)
+	{
+		std::vector<std::uint8_t> buffer(DonerSerializer::CBase64::GetMaxDecodedSize(text.size()));
+		std::size_t size = 0;
+		const bool success = DonerSerializer::CBase64::Decode(text.data(), text.size(), buffer.data(), size);
+		result.assign(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(size));
+		return success;
+	}
+}
+
+DONER_DEFINE_REFLECTION_DATA(CBase64TestInternal::CBlob,
+							   DONER_ADD_NAMED_VAR_INFO(m_bytes, "bytes"),
+							   DONER_ADD_NAMED_VAR_INFO(m_chunks, "chunks")
+)
+
+namespace DonerSerializer
+{
+	class CBase64Test : public ::testing::Test
+	{
+	public:
+		CBase64Test() = default;
+		~CBase64Test() = default;
+	};
+
+	TEST_F(CBase64Test, codec_matches_rfc_4648)
+	{
+		const char* const texts[] = { "", "f", "fo", "foo", "foob", "fooba", "foobar" };
+		const char* const encoded[] = { "", "Zg==", "Zm8=", "Zm9v", "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy" };
+		for (std::size_t index = 0; index < 7; ++index)
+		{
+			EXPECT_EQ(encoded[index], CBase64TestInternal::Encode(texts[index]));
+			std::string decoded;
+			EXPECT_TRUE(CBase64TestInternal::Decode(encoded[index], decoded));
+			EXPECT_EQ(texts[index], decoded);
+		}
+
+		// Long enough to go through the vectorized blocks and the scalar tail
+		std::string text;
+		for (std::size_t size = 0; size < 100; ++size)
+		{
+			std::string decoded;
+			EXPECT_TRUE(CBase64TestInternal::Decode(CBase64TestInternal::Encode(text), decoded));
+			EXPECT_EQ(text, decoded);
+			text.push_back(static_cast<char>(size * 37 + 11));
+		}
+		EXPECT_EQ("+/+/", CBase64TestInternal::Encode("\xfb\xff\xbf"));
+
+		std::string decoded;
+		EXPECT_TRUE(CBase64TestInternal::Decode("Zm9vYg", decoded));
+		EXPECT_EQ("foob", decoded);
+		EXPECT_FALSE(CBase64TestInternal::Decode("Zm9vY", decoded));
+		EXPECT_FALSE(CBase64TestInternal::Decode("Zm9v Zm9v", decoded));
+		EXPECT_FALSE(CBase64TestInternal::Decode("Zm9vYmFy*m9vYmFyZm9vYmFy", decoded));
+		EXPECT_FALSE(CBase64TestInternal::Decode("Zm=vYmFy", decoded));
+	}
+
+	TEST_F(CBase64Test, simd_and_scalar_paths_match)
+	{
+		// Sizes cover several 12 byte encoding and 16 character decoding blocks, with every tail
+		std::vector<std::uint8_t> data;
+		for (std::size_t size = 0; size < 200; ++size)
+		{
+			std::string encoded(DonerSerializer::CBase64::GetEncodedSize(data.size()), '\0');
+			std::string scalarEncoded(encoded.size(), '\0');
+			DonerSerializer::CBase64::Encode(data.data(), data.size(), &encoded[0]);
+			DonerSerializer::CBase64::EncodeScalar(data.data(), data.size(), &scalarEncoded[0]);
+			EXPECT_EQ(scalarEncoded, encoded);
+
+			std::vector<std::uint8_t> decoded(DonerSerializer::CBase64::GetMaxDecodedSize(encoded.size()));
+			std::vector<std::uint8_t> scalarDecoded(decoded.size());
+			std::size_t decodedSize = 0;
+			std::size_t scalarDecodedSize = 0;
+			EXPECT_TRUE(DonerSerializer::CBase64::Decode(encoded.data(), encoded.size(), decoded.data(), decodedSize));
+			EXPECT_TRUE(DonerSerializer::CBase64::DecodeScalar(encoded.data(), encoded.size(), scalarDecoded.data(), scalarDecodedSize));
+			decoded.resize(decodedSize);
+			scalarDecoded.resize(scalarDecodedSize);
+			EXPECT_EQ(data, decoded);
+			EXPECT_EQ(scalarDecoded, decoded);
+
+			// Both reject an invalid character, whether it falls in a block or in the tail
+			if (!encoded.empty())
+			{
+				encoded[size % encoded.size()] = '*';
+				EXPECT_FALSE(DonerSerializer::CBase64::Decode(encoded.data(), encoded.size(), decoded.data(), decodedSize));
+				EXPECT_FALSE(DonerSerializer::CBase64::DecodeScalar(encoded.data(), encoded.size(), scalarDecoded.data(), scalarDecodedSize));
+			}
+
+			data.push_back(static_cast<std::uint8_t>(size * 97 + 13));
+		}
+	}
+
+	TEST_F(CBase64Test, json_byte_vectors_are_base64)
+	{
+		CBase64TestInternal::CBlob blob;
+		blob.m_bytes = { 'f', 'o', 'o', 'b', 'a', 'r' };
+		blob.m_chunks = { { 0xff }, {} };
+
+		const char* const expected = "{\"chunks\":[\"/w==\",\"\"],\"bytes\":\"Zm9vYmFy\"}";
+		DonerSerializer::CJsonSerializer serializer;
+		serializer.Serialize(blob);
+		EXPECT_EQ(expected, serializer.GetJsonString());
+		EXPECT_EQ(expected, DonerSerializer::CJsonStreamSerializer::GetJsonString(blob));
+
+		// Allocators that free their values get a string owned by the value
+		rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::CrtAllocator> crtDocument;
+		DonerSerializer::CJsonSerializer::Serialize(blob, crtDocument);
+		EXPECT_EQ(expected, DonerSerializer::CJsonSerializer::GetJsonString(crtDocument));
+
+		CBase64TestInternal::CBlob result;
+		DonerSerializer::CJsonDeserializer::Deserialize(result, expected);
+		EXPECT_EQ(blob.m_bytes, result.m_bytes);
+		EXPECT_EQ(blob.m_chunks, result.m_chunks);
+
+		CBase64TestInternal::CBlob streamResult;
+		EXPECT_TRUE(DonerSerializer::CJsonStreamDeserializer::Deserialize(streamResult, expected));
+		EXPECT_EQ(blob.m_bytes, streamResult.m_bytes);
+		EXPECT_EQ(blob.m_chunks, streamResult.m_chunks);
+
+		// Arrays of numbers written by older versions are still read
+		const char* const legacy = "{\"bytes\":[102,111,111],\"chunks\":[[255],[]]}";
+		CBase64TestInternal::CBlob legacyResult;
+		DonerSerializer::CJsonDeserializer::Deserialize(legacyResult, legacy);
+		EXPECT_EQ(std::vector<std::uint8_t>({ 'f', 'o', 'o' }), legacyResult.m_bytes);
+		EXPECT_EQ(blob.m_chunks, legacyResult.m_chunks);
+
+		CBase64TestInternal::CBlob legacyStreamResult;
+		EXPECT_TRUE(DonerSerializer::CJsonStreamDeserializer::Deserialize(legacyStreamResult, legacy));
+		EXPECT_EQ(std::vector<std::uint8_t>({ 'f', 'o', 'o' }), legacyStreamResult.m_bytes);
+		EXPECT_EQ(blob.m_chunks, legacyStreamResult.m_chunks);
+
+		// Invalid strings leave the member as it was
+		DonerSerializer::CJsonDeserializer::Deserialize(result, "{\"bytes\":\"Zm9v*\"}");
+		EXPECT_EQ(blob.m_bytes, result.m_bytes);
+	}
+}
\ No newline at end of file
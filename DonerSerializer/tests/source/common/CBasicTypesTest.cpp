@@ -27,12 +27,18 @@
 
 #include <donerserializer/DonerSerialize.h>
 #include <donerserializer/DonerDeserialize.h>
+#include <donerserializer/DonerStreamDeserialize.h>
 
 #include <gtest/gtest.h>
 
+#include <cstring>
+#include <string>
+#include <vector>
+
 namespace CBasicTypesTestInternal
 {
 	const char* const FOO_JSON_DATA = "{\"enum\":0,\"bool\":true,\"double\":6.0,\"float\":5.0,\"uint64t\":4,\"int64t\":3,\"uint32t\":2,\"int32t\":1}";
+	const char* const FOO_JSON_DATA_UNKNOWN_MEMBERS = "{\"int32\":9,\"unknown\":{\"int32t\":8},\"int32t_\":7,\"bool\":true,\"int32t\":1,\"uint32t\":2}";
 	const char* const FOO_JSON_DATA_INHERIT = "{\"int32t_2\":7,\"enum\":0,\"bool\":true,\"double\":6.0,\"float\":5.0,\"uint64t\":4,\"int64t\":3,\"uint32t\":2,\"int32t\":1}";
 
 	class CFoo
@@ -73,6 +79,16 @@ namespace CBasicTypesTestInternal
 
 		std::int32_t m_int32t_2;
 	};
+
+	class CText
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CText)
+	public:
+		std::string m_string;
+#ifdef DONER_SERIALIZER_HAS_STRING_VIEW
+		std::string_view m_view;
+#endif
+	};
 }
 
 DONER_DEFINE_REFLECTION_DATA(CBasicTypesTestInternal::CFoo,
@@ -98,6 +114,17 @@ DONER_DEFINE_REFLECTION_DATA(CBasicTypesTestInternal::CBar,
 							   DONER_ADD_NAMED_VAR_INFO(m_int32t_2, "int32t_2")
 )
 
+#ifdef DONER_SERIALIZER_HAS_STRING_VIEW
+DONER_DEFINE_REFLECTION_DATA(CBasicTypesTestInternal::CText,
+							   DONER_ADD_NAMED_VAR_INFO(m_string, "string"),
+							   DONER_ADD_NAMED_VAR_INFO(m_view, "view")
+)
+#else
+DONER_DEFINE_REFLECTION_DATA(CBasicTypesTestInternal::CText,
+							   DONER_ADD_NAMED_VAR_INFO(m_string, "string")
+)
+#endif
+
 namespace DonerSerializer
 {
 	class CBasicTypesTest : public ::testing::Test
@@ -156,6 +183,88 @@ namespace DonerSerializer
 	}
 
 
+	TEST_F(CBasicTypesTest, deserialize_ignores_unknown_members)
+	{
+		CBasicTypesTestInternal::CFoo foo;
+
+		DonerSerializer::CJsonDeserializer::Deserialize(foo, CBasicTypesTestInternal::FOO_JSON_DATA_UNKNOWN_MEMBERS);
+
+		EXPECT_EQ(1, foo.m_int32t);
+		EXPECT_EQ(2U, foo.m_uint32t);
+		EXPECT_EQ(0L, foo.m_int64t);
+		EXPECT_TRUE(foo.m_bool);
+	}
+
+	TEST_F(CBasicTypesTest, deserialize_basic_types_insitu)
+	{
+		CBasicTypesTestInternal::CFoo foo;
+		std::vector<char> buffer(CBasicTypesTestInternal::FOO_JSON_DATA, CBasicTypesTestInternal::FOO_JSON_DATA + std::strlen(CBasicTypesTestInternal::FOO_JSON_DATA) + 1);
+
+		DonerSerializer::CJsonDeserializer::DeserializeInsitu(foo, buffer.data());
+
+		EXPECT_EQ(1, foo.m_int32t);
+		EXPECT_EQ(2U, foo.m_uint32t);
+		EXPECT_EQ(3L, foo.m_int64t);
+		EXPECT_EQ(4UL, foo.m_uint64t);
+		EXPECT_EQ(5.f, foo.m_float);
+		EXPECT_EQ(6.0, foo.m_double);
+		EXPECT_TRUE(foo.m_bool);
+	}
+
+	TEST_F(CBasicTypesTest, deserialize_strings_insitu)
+	{
+		CBasicTypesTestInternal::CText text;
+		char buffer[] = "{\"string\":\"line\\nbreak\",\"view\":\"tab\\there\"}";
+
+		DonerSerializer::CJsonDeserializer::DeserializeInsitu(text, buffer);
+
+		EXPECT_EQ(std::string("line\nbreak"), text.m_string);
+#ifdef DONER_SERIALIZER_HAS_STRING_VIEW
+		EXPECT_EQ(std::string_view("tab\there"), text.m_view);
+		EXPECT_TRUE(text.m_view.data() >= buffer && text.m_view.data() < buffer + sizeof(buffer));
+#endif
+	}
+
+#ifdef DONER_SERIALIZER_HAS_STRING_VIEW
+	TEST_F(CBasicTypesTest, string_views_are_only_bound_insitu)
+	{
+		// Other entry points parse into documents destroyed on return, so the view is left untouched
+		const char* const json = "{\"string\":\"text\",\"view\":\"dangling\"}";
+		CBasicTypesTestInternal::CText text;
+		text.m_view = "kept";
+
+		DonerSerializer::CJsonDeserializer::Deserialize(text, json);
+		EXPECT_EQ(std::string("text"), text.m_string);
+		EXPECT_EQ(std::string_view("kept"), text.m_view);
+
+		EXPECT_TRUE(DonerSerializer::CJsonStreamDeserializer::Deserialize(text, json));
+		EXPECT_EQ(std::string_view("kept"), text.m_view);
+
+		char buffer[] = "{\"view\":\"bound\"}";
+		EXPECT_TRUE(DonerSerializer::CJsonStreamDeserializer::DeserializeInsitu(text, buffer));
+		EXPECT_EQ(std::string_view("bound"), text.m_view);
+		EXPECT_TRUE(text.m_view.data() >= buffer && text.m_view.data() < buffer + sizeof(buffer));
+		EXPECT_FALSE(DonerSerializer::CInsituDeserializationScope::IsActive());
+	}
+#endif
+
+	TEST_F(CBasicTypesTest, deserialize_strings_reusing_capacity)
+	{
+		CBasicTypesTestInternal::CText text;
+		text.m_string.reserve(64);
+		const char* const data = text.m_string.data();
+
+		DonerSerializer::CJsonDeserializer::Deserialize(text, "{\"string\":\"nul\\u0000inside\"}");
+
+		EXPECT_EQ(std::string("nul\0inside", 10), text.m_string);
+		EXPECT_EQ(data, text.m_string.data());
+
+		DonerSerializer::CJsonDeserializer::Deserialize(text, "{\"string\":\"short\"}");
+
+		EXPECT_EQ(std::string("short"), text.m_string);
+		EXPECT_EQ(data, text.m_string.data());
+	}
+
 	TEST_F(CBasicTypesTest, serialize_basic_types_from_main_class)
 	{
 		CBasicTypesTestInternal::CFoo foo;
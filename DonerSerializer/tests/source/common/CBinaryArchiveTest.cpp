@@ -0,0 +1,245 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#include <donerserializer/DonerBinaryArchive.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace CBinaryArchiveTestInternal
+{
+	class CVector3 : public DonerSerializer::ISerializable
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CVector3)
+	public:
+		CVector3()
+			: m_x(0.f)
+			, m_y(0.f)
+			, m_z(0.f)
+		{}
+
+		CVector3(float x, float y, float z)
+			: m_x(x)
+			, m_y(y)
+			, m_z(z)
+		{}
+
+		float m_x;
+		float m_y;
+		float m_z;
+	};
+
+	class CFoo
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CFoo)
+	public:
+		enum class EEnumTest { Test1, Test2 };
+
+		CFoo()
+			: m_int32t(0)
+			, m_uint64t(0)
+			, m_double(0.0)
+			, m_bool(false)
+			, m_enum(EEnumTest::Test1)
+			, m_pointer(nullptr)
+		{}
+
+		std::int32_t m_int32t;
+		std::uint64_t m_uint64t;
+		double m_double;
+		bool m_bool;
+		EEnumTest m_enum;
+		std::string m_string;
+		CVector3 m_position;
+		std::vector<float> m_vFloat;
+		std::vector<bool> m_vBool;
+		std::vector<std::string> m_vString;
+		std::vector<CVector3> m_vVector3;
+		std::map<std::int32_t, std::string> m_map;
+		std::unordered_map<std::string, std::vector<std::int16_t>> m_unorderedMap;
+		int* m_pointer;
+	};
+
+	// Same names as CVector3, but a different type
+	class CVector3Int
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CVector3Int)
+	public:
+		CVector3Int()
+			: m_x(0)
+			, m_y(0)
+			, m_z(0)
+		{}
+
+		std::int32_t m_x;
+		std::int32_t m_y;
+		std::int32_t m_z;
+	};
+}
+
+DONER_DEFINE_REFLECTION_DATA(CBinaryArchiveTestInternal::CVector3,
+							   DONER_ADD_NAMED_VAR_INFO(m_x, "x"),
+							   DONER_ADD_NAMED_VAR_INFO(m_y, "y"),
+							   DONER_ADD_NAMED_VAR_INFO(m_z, "z")
+)
+
+DONER_DEFINE_REFLECTION_DATA(CBinaryArchiveTestInternal::CFoo,
+							   DONER_ADD_NAMED_VAR_INFO(m_int32t, "int32t"),
+							   DONER_ADD_NAMED_VAR_INFO(m_uint64t, "uint64t"),
+							   DONER_ADD_NAMED_VAR_INFO(m_double, "double"),
+							   DONER_ADD_NAMED_VAR_INFO(m_bool, "bool"),
+							   DONER_ADD_NAMED_VAR_INFO(m_enum, "enum"),
+							   DONER_ADD_NAMED_VAR_INFO(m_string, "string"),
+							   DONER_ADD_NAMED_VAR_INFO(m_position, "position"),
+							   DONER_ADD_NAMED_VAR_INFO(m_vFloat, "v_float"),
+							   DONER_ADD_NAMED_VAR_INFO(m_vBool, "v_bool"),
+							   DONER_ADD_NAMED_VAR_INFO(m_vString, "v_string"),
+							   DONER_ADD_NAMED_VAR_INFO(m_vVector3, "v_vector3"),
+							   DONER_ADD_NAMED_VAR_INFO(m_map, "map"),
+							   DONER_ADD_NAMED_VAR_INFO(m_unorderedMap, "u_map"),
+							   DONER_ADD_NAMED_VAR_INFO(m_pointer, "pointer")
+)
+
+DONER_DEFINE_REFLECTION_DATA(CBinaryArchiveTestInternal::CVector3Int,
+							   DONER_ADD_NAMED_VAR_INFO(m_x, "x"),
+							   DONER_ADD_NAMED_VAR_INFO(m_y, "y"),
+							   DONER_ADD_NAMED_VAR_INFO(m_z, "z")
+)
+
+namespace DonerSerializer
+{
+	class CBinaryArchiveTest : public ::testing::Test
+	{
+	public:
+		CBinaryArchiveTest() = default;
+		~CBinaryArchiveTest() = default;
+	};
+
+	TEST_F(CBinaryArchiveTest, roundtrip_all_supported_types)
+	{
+		CBinaryArchiveTestInternal::CFoo foo;
+		foo.m_int32t = -100000;
+		foo.m_uint64t = 18000000000000000000ULL;
+		foo.m_double = 0.1;
+		foo.m_bool = true;
+		foo.m_enum = CBinaryArchiveTestInternal::CFoo::EEnumTest::Test2;
+		foo.m_string = std::string(300, 'x');
+		foo.m_position = CBinaryArchiveTestInternal::CVector3(1.f, 2.f, 3.f);
+		foo.m_vFloat = { 0.5f, -1.f, 1e10f };
+		foo.m_vBool = { true, false, true };
+		foo.m_vString = { "a", "" };
+		foo.m_vVector3 = { CBinaryArchiveTestInternal::CVector3(4.f, 5.f, 6.f), CBinaryArchiveTestInternal::CVector3() };
+		foo.m_map[-7] = "minus seven";
+		foo.m_map[70000] = "big";
+		foo.m_unorderedMap["two"] = { 2, -2 };
+		int pointee = 0;
+		foo.m_pointer = &pointee;
+
+		const std::vector<std::uint8_t> buffer = DonerSerializer::CBinaryArchive::GetBuffer(foo);
+
+		// Containers are replaced, not appended to
+		CBinaryArchiveTestInternal::CFoo result;
+		result.m_vFloat = { 7.f };
+		result.m_map[1] = "one";
+		ASSERT_TRUE(DonerSerializer::CBinaryArchive::Load(result, buffer));
+
+		EXPECT_EQ(foo.m_int32t, result.m_int32t);
+		EXPECT_EQ(foo.m_uint64t, result.m_uint64t);
+		EXPECT_EQ(foo.m_double, result.m_double);
+		EXPECT_EQ(foo.m_bool, result.m_bool);
+		EXPECT_TRUE(foo.m_enum == result.m_enum);
+		EXPECT_EQ(foo.m_string, result.m_string);
+		EXPECT_EQ(2.f, result.m_position.m_y);
+		EXPECT_EQ(3.f, result.m_position.m_z);
+		EXPECT_EQ(foo.m_vFloat, result.m_vFloat);
+		EXPECT_EQ(foo.m_vBool, result.m_vBool);
+		EXPECT_EQ(foo.m_vString, result.m_vString);
+		ASSERT_EQ(2U, result.m_vVector3.size());
+		EXPECT_EQ(5.f, result.m_vVector3[0].m_y);
+		EXPECT_EQ(foo.m_map, result.m_map);
+		EXPECT_EQ(foo.m_unorderedMap, result.m_unorderedMap);
+		// Pointers aren't archived
+		EXPECT_EQ(nullptr, result.m_pointer);
+	}
+
+	TEST_F(CBinaryArchiveTest, adjacent_bitwise_members_are_copied_at_once)
+	{
+		// The three floats of CVector3 are a single copy
+		const auto& steps = DonerSerializer::CBinaryArchiveLayout<CBinaryArchiveTestInternal::CVector3>::Get().GetSteps();
+		ASSERT_EQ(1U, steps.size());
+		EXPECT_EQ(3 * sizeof(float), steps[0].m_size);
+
+		// Magic number, schema hash and the floats
+		const CBinaryArchiveTestInternal::CVector3 vector(1.f, 2.f, 3.f);
+		EXPECT_EQ(4 + 8 + 3 * sizeof(float), DonerSerializer::CBinaryArchive::GetBuffer(vector).size());
+
+		std::vector<CBinaryArchiveTestInternal::CVector3> vectors(100);
+		std::vector<std::uint8_t> buffer;
+		DonerSerializer::CBinaryWriter writer(buffer);
+		DonerSerializer::CBinaryArchiveResolver::CBinaryArchiveResolverType<std::vector<CBinaryArchiveTestInternal::CVector3>>::Write(vectors, writer);
+		EXPECT_EQ(1 + 100 * 3 * sizeof(float), buffer.size());
+	}
+
+	TEST_F(CBinaryArchiveTest, load_rejects_mismatched_schema_and_invalid_input)
+	{
+		EXPECT_NE(DonerSerializer::CBinaryArchive::GetSchemaHash<CBinaryArchiveTestInternal::CVector3>(), DonerSerializer::CBinaryArchive::GetSchemaHash<CBinaryArchiveTestInternal::CVector3Int>());
+
+		const CBinaryArchiveTestInternal::CVector3 vector(1.f, 2.f, 3.f);
+		std::vector<std::uint8_t> buffer = DonerSerializer::CBinaryArchive::GetBuffer(vector);
+
+		CBinaryArchiveTestInternal::CVector3Int vectorInt;
+		EXPECT_FALSE(DonerSerializer::CBinaryArchive::Load(vectorInt, buffer));
+		EXPECT_EQ(0, vectorInt.m_x);
+
+		CBinaryArchiveTestInternal::CVector3 result;
+		const std::vector<std::uint8_t> truncated(buffer.begin(), buffer.end() - 1);
+		EXPECT_FALSE(DonerSerializer::CBinaryArchive::Load(result, truncated));
+
+		buffer.push_back(0);
+		EXPECT_FALSE(DonerSerializer::CBinaryArchive::Load(result, buffer));
+
+		// A huge element count fails instead of being allocated
+		CBinaryArchiveTestInternal::CFoo foo;
+		foo.m_vFloat = { 1.f };
+		buffer = DonerSerializer::CBinaryArchive::GetBuffer(foo);
+		std::vector<std::uint8_t> floatCount(1 + sizeof(float), 0x01);
+		std::memcpy(&floatCount[1], &foo.m_vFloat[0], sizeof(float));
+		auto it = std::search(buffer.begin(), buffer.end(), floatCount.begin(), floatCount.end());
+		ASSERT_TRUE(it != buffer.end());
+		*it = 0xff;
+		buffer.insert(it + 1, { 0xff, 0xff, 0xff, 0x0f });
+		EXPECT_FALSE(DonerSerializer::CBinaryArchive::Load(foo, buffer));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,235 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#include <donerserializer/DonerBinaryView.h>
+#include <donerserializer/CMappedFile.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace CBinaryViewTestInternal
+{
+	class CBasic : public DonerSerializer::ISerializable
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CBasic)
+	public:
+		CBasic()
+			: m_int32t(0)
+			, m_bool(false)
+		{}
+
+		CBasic(std::int32_t int32t, bool _bool, const std::string& name)
+			: m_int32t(int32t)
+			, m_bool(_bool)
+			, m_name(name)
+		{}
+
+		std::int32_t m_int32t;
+		bool m_bool;
+		std::string m_name;
+	};
+
+	class CAsset
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CAsset)
+	public:
+		enum class EEnumTest { Test1, Test2 };
+
+		CAsset()
+			: m_uint64t(0)
+			, m_double(0.0)
+			, m_enum(EEnumTest::Test1)
+		{}
+
+		std::uint64_t m_uint64t;
+		double m_double;
+		EEnumTest m_enum;
+		std::string m_name;
+		std::vector<float> m_vFloat;
+		std::vector<bool> m_vBool;
+		std::vector<std::string> m_vString;
+		std::vector<CBasic> m_vBasic;
+		std::map<std::string, std::int32_t> m_map;
+		CBasic m_basic;
+	};
+
+	CAsset CreateAsset()
+	{
+		CAsset asset;
+		asset.m_uint64t = 18000000000000000000ULL;
+		asset.m_double = 0.1;
+		asset.m_enum = CAsset::EEnumTest::Test2;
+		asset.m_name = "asset";
+		asset.m_vFloat = { 0.5f, -1.f, 1e10f };
+		asset.m_vBool = { true, false, true };
+		asset.m_vString = { "a", "", "ccc" };
+		asset.m_vBasic = { CBasic(1, false, "first"), CBasic(127, true, "second") };
+		asset.m_map["one"] = 1;
+		asset.m_map["two"] = 2;
+		asset.m_basic = CBasic(-33, true, "basic");
+		return asset;
+	}
+}
+
+DONER_DEFINE_REFLECTION_DATA(CBinaryViewTestInternal::CBasic,
+							   DONER_ADD_NAMED_VAR_INFO(m_int32t, "int32t"),
+							   DONER_ADD_NAMED_VAR_INFO(m_bool, "bool"),
+							   DONER_ADD_NAMED_VAR_INFO(m_name, "name")
+)
+
+DONER_DEFINE_REFLECTION_DATA(CBinaryViewTestInternal::CAsset,
+							   DONER_ADD_NAMED_VAR_INFO(m_uint64t, "uint64t"),
+							   DONER_ADD_NAMED_VAR_INFO(m_double, "double"),
+							   DONER_ADD_NAMED_VAR_INFO(m_enum, "enum"),
+							   DONER_ADD_NAMED_VAR_INFO(m_name, "name"),
+							   DONER_ADD_NAMED_VAR_INFO(m_vFloat, "v_float"),
+							   DONER_ADD_NAMED_VAR_INFO(m_vBool, "v_bool"),
+							   DONER_ADD_NAMED_VAR_INFO(m_vString, "v_string"),
+							   DONER_ADD_NAMED_VAR_INFO(m_vBasic, "v_basic"),
+							   DONER_ADD_NAMED_VAR_INFO(m_map, "map"),
+							   DONER_ADD_NAMED_VAR_INFO(m_basic, "basic")
+)
+
+namespace DonerSerializer
+{
+	class CBinaryViewTest : public ::testing::Test
+	{
+	public:
+		CBinaryViewTest() = default;
+		~CBinaryViewTest() = default;
+	};
+
+	TEST_F(CBinaryViewTest, view_reads_members_in_place)
+	{
+		using CAsset = CBinaryViewTestInternal::CAsset;
+		using CBasic = CBinaryViewTestInternal::CBasic;
+
+		const std::vector<std::uint8_t> buffer = DonerSerializer::CBinaryView<CAsset>::GetBuffer(CBinaryViewTestInternal::CreateAsset());
+		const DonerSerializer::CBinaryView<CAsset> view = DonerSerializer::CBinaryView<CAsset>::Open(buffer);
+		ASSERT_TRUE(view.IsValid());
+
+		EXPECT_EQ(18000000000000000000ULL, view.Get(&CAsset::m_uint64t));
+		EXPECT_EQ(0.1, view.Get(&CAsset::m_double));
+		EXPECT_TRUE(CAsset::EEnumTest::Test2 == view.Get(&CAsset::m_enum));
+		EXPECT_EQ("asset", view.Get(&CAsset::m_name).ToString());
+
+		const auto vFloat = view.Get(&CAsset::m_vFloat);
+		ASSERT_EQ(3U, vFloat.GetSize());
+		EXPECT_EQ(1e10f, vFloat[2]);
+		EXPECT_EQ(0.f, vFloat[3]);
+
+		const auto vBool = view.Get(&CAsset::m_vBool);
+		ASSERT_EQ(3U, vBool.GetSize());
+		EXPECT_TRUE(vBool[0]);
+		EXPECT_FALSE(vBool[1]);
+
+		const auto vString = view.Get(&CAsset::m_vString);
+		ASSERT_EQ(3U, vString.GetSize());
+		EXPECT_TRUE(vString[1] == "");
+		EXPECT_TRUE(vString[2] == "ccc");
+
+		const auto vBasic = view.Get(&CAsset::m_vBasic);
+		ASSERT_EQ(2U, vBasic.GetSize());
+		EXPECT_EQ(127, vBasic[1].Get(&CBasic::m_int32t));
+		EXPECT_TRUE(vBasic[1].Get(&CBasic::m_bool));
+		EXPECT_TRUE(vBasic[1].Get(&CBasic::m_name) == "second");
+
+		const auto map = view.Get(&CAsset::m_map);
+		ASSERT_EQ(2U, map.GetSize());
+		EXPECT_TRUE(map.GetKey(1) == "two");
+		EXPECT_EQ(2, map.GetValue(1));
+
+		const DonerSerializer::CBinaryView<CBasic> basic = view.Get(&CAsset::m_basic);
+		EXPECT_EQ(-33, basic.Get(&CBasic::m_int32t));
+		EXPECT_TRUE(basic.Get(&CBasic::m_name) == "basic");
+	}
+
+	TEST_F(CBinaryViewTest, view_of_mapped_file)
+	{
+		using CAsset = CBinaryViewTestInternal::CAsset;
+
+		const std::vector<std::uint8_t> buffer = DonerSerializer::CBinaryView<CAsset>::GetBuffer(CBinaryViewTestInternal::CreateAsset());
+		const char* const path = "CBinaryViewTest.bin";
+		std::FILE* file = std::fopen(path, "wb");
+		ASSERT_TRUE(file != nullptr);
+		std::fwrite(buffer.data(), 1, buffer.size(), file);
+		std::fclose(file);
+
+		{
+			DonerSerializer::CMappedFile mappedFile(path);
+			ASSERT_TRUE(mappedFile.IsOpen());
+			const auto view = DonerSerializer::CBinaryView<CAsset>::Open(mappedFile.GetData(), mappedFile.GetSize());
+			ASSERT_TRUE(view.IsValid());
+			EXPECT_TRUE(view.Get(&CAsset::m_vBasic)[0].Get(&CBinaryViewTestInternal::CBasic::m_name) == "first");
+		}
+		std::remove(path);
+	}
+
+	TEST_F(CBinaryViewTest, invalid_buffers_read_as_defaults)
+	{
+		using CAsset = CBinaryViewTestInternal::CAsset;
+		using CBasic = CBinaryViewTestInternal::CBasic;
+
+		const std::vector<std::uint8_t> buffer = DonerSerializer::CBinaryView<CAsset>::GetBuffer(CBinaryViewTestInternal::CreateAsset());
+
+		// Schema of another class
+		EXPECT_FALSE(DonerSerializer::CBinaryView<CBasic>::Open(buffer).IsValid());
+		EXPECT_FALSE(DonerSerializer::CBinaryView<CAsset>::Open(reinterpret_cast<const char*>(buffer.data()), 4).IsValid());
+
+		// Every truncation reads whatever is left in bounds, and defaults for the rest
+		for (std::size_t size = 12; size < buffer.size(); ++size)
+		{
+			const std::vector<std::uint8_t> truncated(buffer.begin(), buffer.begin() + size);
+			const auto view = DonerSerializer::CBinaryView<CAsset>::Open(truncated);
+			ASSERT_TRUE(view.IsValid());
+			view.Get(&CAsset::m_name);
+			const auto vString = view.Get(&CAsset::m_vString);
+			for (std::size_t index = 0; index < vString.GetSize(); ++index)
+			{
+				vString[index].ToString();
+			}
+			const auto vFloat = view.Get(&CAsset::m_vFloat);
+			float sum = 0.f;
+			for (std::size_t index = 0; index < vFloat.GetSize(); ++index)
+			{
+				sum += vFloat[index];
+			}
+			EXPECT_LE(sum, 1e10f);
+			view.Get(&CAsset::m_basic).Get(&CBasic::m_name);
+			view.Get(&CAsset::m_map).GetKey(1);
+		}
+
+		const std::vector<std::uint8_t> truncated(buffer.begin(), buffer.begin() + 20);
+		EXPECT_TRUE(DonerSerializer::CBinaryView<CAsset>::Open(truncated).Get(&CAsset::m_basic).Get(&CBasic::m_name) == "");
+	}
+}
\ No newline at end of file
@@ -0,0 +1,275 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#include <donerserializer/DonerCborSerialize.h>
+#include <donerserializer/DonerCborDeserialize.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace CCborTestInternal
+{
+	class CBasic : public DonerSerializer::ISerializable
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CBasic)
+	public:
+		CBasic()
+			: m_int32t(0)
+			, m_bool(false)
+		{}
+
+		CBasic(std::int32_t int32t, bool _bool)
+			: m_int32t(int32t)
+			, m_bool(_bool)
+		{}
+
+		std::int32_t m_int32t;
+		bool m_bool;
+	};
+
+	class CFoo
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CFoo)
+	public:
+		enum class EEnumTest { Test1, Test2 };
+
+		CFoo()
+			: m_int32t(0)
+			, m_uint32t(0)
+			, m_int64t(0)
+			, m_uint64t(0)
+			, m_float(0.f)
+			, m_double(0.0)
+			, m_bool(false)
+			, m_enum(EEnumTest::Test1)
+		{}
+
+		std::int32_t m_int32t;
+		std::uint32_t m_uint32t;
+		std::int64_t m_int64t;
+		std::uint64_t m_uint64t;
+		float m_float;
+		double m_double;
+		bool m_bool;
+		EEnumTest m_enum;
+		std::string m_string;
+		std::vector<std::string> m_vString;
+		std::vector<bool> m_vBool;
+		std::vector<std::vector<std::int32_t>> m_vVector;
+		std::map<std::int32_t, std::string> m_map;
+		std::unordered_map<std::string, std::int32_t> m_unorderedMap;
+		CBasic m_basic;
+		std::vector<CBasic> m_vBasic;
+	};
+
+	CFoo CreateFoo()
+	{
+		CFoo foo;
+		foo.m_int32t = -100000;
+		foo.m_uint32t = 4000000000U;
+		foo.m_int64t = std::numeric_limits<std::int64_t>::min();
+		foo.m_uint64t = 18000000000000000000ULL;
+		foo.m_float = 5.5f;
+		foo.m_double = 0.1;
+		foo.m_bool = true;
+		foo.m_enum = CFoo::EEnumTest::Test2;
+		foo.m_string = std::string(40, 'x');
+		foo.m_vString = { "a", "" };
+		foo.m_vBool = { true, false, true };
+		foo.m_vVector = { { 0, -1 }, {}, { 300 } };
+		foo.m_map[-7] = "minus seven";
+		foo.m_map[70000] = "big";
+		foo.m_unorderedMap["two"] = 2;
+		foo.m_basic = CBasic(-33, true);
+		foo.m_vBasic = { CBasic(1, false), CBasic(127, true) };
+		return foo;
+	}
+
+	std::vector<std::uint8_t> EncodeFloat(double value)
+	{
+		std::vector<std::uint8_t> output;
+		DonerSerializer::CCborWriter writer(output);
+		writer.WriteFloat(value);
+		return output;
+	}
+}
+
+DONER_DEFINE_REFLECTION_DATA(CCborTestInternal::CBasic,
+							   DONER_ADD_NAMED_VAR_INFO(m_int32t, "int32t"),
+							   DONER_ADD_NAMED_VAR_INFO(m_bool, "bool")
+)
+
+DONER_DEFINE_REFLECTION_DATA(CCborTestInternal::CFoo,
+							   DONER_ADD_NAMED_VAR_INFO(m_int32t, "int32t"),
+							   DONER_ADD_NAMED_VAR_INFO(m_uint32t, "uint32t"),
+							   DONER_ADD_NAMED_VAR_INFO(m_int64t, "int64t"),
+							   DONER_ADD_NAMED_VAR_INFO(m_uint64t, "uint64t"),
+							   DONER_ADD_NAMED_VAR_INFO(m_float, "float"),
+							   DONER_ADD_NAMED_VAR_INFO(m_double, "double"),
+							   DONER_ADD_NAMED_VAR_INFO(m_bool, "bool"),
+							   DONER_ADD_NAMED_VAR_INFO(m_enum, "enum"),
+							   DONER_ADD_NAMED_VAR_INFO(m_string, "string"),
+							   DONER_ADD_NAMED_VAR_INFO(m_vString, "v_string"),
+							   DONER_ADD_NAMED_VAR_INFO(m_vBool, "v_bool"),
+							   DONER_ADD_NAMED_VAR_INFO(m_vVector, "v_vector"),
+							   DONER_ADD_NAMED_VAR_INFO(m_map, "map"),
+							   DONER_ADD_NAMED_VAR_INFO(m_unorderedMap, "u_map"),
+							   DONER_ADD_NAMED_VAR_INFO(m_basic, "basic"),
+							   DONER_ADD_NAMED_VAR_INFO(m_vBasic, "v_basic")
+)
+
+namespace DonerSerializer
+{
+	class CCborTest : public ::testing::Test
+	{
+	public:
+		CCborTest() = default;
+		~CCborTest() = default;
+	};
+
+	TEST_F(CCborTest, serialize_uses_deterministic_encoding)
+	{
+		// Shorter keys go first, whatever the declaration order
+		CCborTestInternal::CBasic basic(300, true);
+		std::vector<std::uint8_t> expected = { 0xa2, 0x64, 'b', 'o', 'o', 'l', 0xf5, 0x66, 'i', 'n', 't', '3', '2', 't', 0x19, 0x01, 0x2c };
+		EXPECT_EQ(expected, DonerSerializer::CCborSerializer::GetBuffer(basic));
+
+		basic.m_int32t = -500;
+		expected = { 0xa2, 0x64, 'b', 'o', 'o', 'l', 0xf5, 0x66, 'i', 'n', 't', '3', '2', 't', 0x39, 0x01, 0xf3 };
+		EXPECT_EQ(expected, DonerSerializer::CCborSerializer::GetBuffer(basic));
+
+		// RFC 8949 Appendix A examples
+		EXPECT_EQ(std::vector<std::uint8_t>({ 0xf9, 0x00, 0x00 }), CCborTestInternal::EncodeFloat(0.0));
+		EXPECT_EQ(std::vector<std::uint8_t>({ 0xf9, 0x80, 0x00 }), CCborTestInternal::EncodeFloat(-0.0));
+		EXPECT_EQ(std::vector<std::uint8_t>({ 0xf9, 0x3e, 0x00 }), CCborTestInternal::EncodeFloat(1.5));
+		EXPECT_EQ(std::vector<std::uint8_t>({ 0xf9, 0x7b, 0xff }), CCborTestInternal::EncodeFloat(65504.0));
+		EXPECT_EQ(std::vector<std::uint8_t>({ 0xf9, 0x00, 0x01 }), CCborTestInternal::EncodeFloat(5.960464477539063e-8));
+		EXPECT_EQ(std::vector<std::uint8_t>({ 0xf9, 0x04, 0x00 }), CCborTestInternal::EncodeFloat(0.00006103515625));
+		EXPECT_EQ(std::vector<std::uint8_t>({ 0xf9, 0x7c, 0x00 }), CCborTestInternal::EncodeFloat(std::numeric_limits<double>::infinity()));
+		EXPECT_EQ(std::vector<std::uint8_t>({ 0xf9, 0x7e, 0x00 }), CCborTestInternal::EncodeFloat(std::numeric_limits<double>::quiet_NaN()));
+		EXPECT_EQ(std::vector<std::uint8_t>({ 0xfa, 0x47, 0xc3, 0x50, 0x00 }), CCborTestInternal::EncodeFloat(100000.0));
+		EXPECT_EQ(std::vector<std::uint8_t>({ 0xfa, 0x7f, 0x7f, 0xff, 0xff }), CCborTestInternal::EncodeFloat(3.4028234663852886e+38));
+		EXPECT_EQ(std::vector<std::uint8_t>({ 0xfb, 0x3f, 0xf1, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9a }), CCborTestInternal::EncodeFloat(1.1));
+	}
+
+	TEST_F(CCborTest, equal_objects_produce_identical_bytes)
+	{
+		CCborTestInternal::CFoo foo = CCborTestInternal::CreateFoo();
+		CCborTestInternal::CFoo other = CCborTestInternal::CreateFoo();
+
+		// Same content, but a different iteration order
+		other.m_unorderedMap.clear();
+		other.m_unorderedMap.reserve(64);
+		for (std::int32_t index = 15; index >= 0; --index)
+		{
+			other.m_unorderedMap[std::to_string(index)] = index;
+		}
+		for (std::int32_t index = 0; index < 16; ++index)
+		{
+			foo.m_unorderedMap[std::to_string(index)] = index;
+		}
+		other.m_unorderedMap["two"] = 2;
+		ASSERT_EQ(foo.m_unorderedMap, other.m_unorderedMap);
+
+		EXPECT_EQ(DonerSerializer::CCborSerializer::GetBuffer(foo), DonerSerializer::CCborSerializer::GetBuffer(other));
+
+		// Map keys are sorted by their encoding, so non-negative integers go before negative ones
+		std::map<std::int32_t, bool> map = { { -7, true }, { 1, false }, { 70000, true } };
+		std::vector<std::uint8_t> buffer;
+		DonerSerializer::CCborWriter writer(buffer);
+		DonerSerializer::CCborSerializationResolver::CCborSerializationResolverType<std::map<std::int32_t, bool>>::Serialize(map, writer);
+		const std::vector<std::uint8_t> expected = { 0xa3, 0x01, 0xf4, 0x1a, 0x00, 0x01, 0x11, 0x70, 0xf5, 0x26, 0xf5 };
+		EXPECT_EQ(expected, buffer);
+	}
+
+	TEST_F(CCborTest, roundtrip_all_supported_types)
+	{
+		const CCborTestInternal::CFoo foo = CCborTestInternal::CreateFoo();
+		const std::vector<std::uint8_t> buffer = DonerSerializer::CCborSerializer::GetBuffer(foo);
+
+		CCborTestInternal::CFoo result;
+		ASSERT_TRUE(DonerSerializer::CCborDeserializer::Deserialize(result, buffer));
+
+		EXPECT_EQ(foo.m_int32t, result.m_int32t);
+		EXPECT_EQ(foo.m_uint32t, result.m_uint32t);
+		EXPECT_EQ(foo.m_int64t, result.m_int64t);
+		EXPECT_EQ(foo.m_uint64t, result.m_uint64t);
+		EXPECT_EQ(foo.m_float, result.m_float);
+		EXPECT_EQ(foo.m_double, result.m_double);
+		EXPECT_EQ(foo.m_bool, result.m_bool);
+		EXPECT_TRUE(foo.m_enum == result.m_enum);
+		EXPECT_EQ(foo.m_string, result.m_string);
+		EXPECT_EQ(foo.m_vString, result.m_vString);
+		EXPECT_EQ(foo.m_vBool, result.m_vBool);
+		EXPECT_EQ(foo.m_vVector, result.m_vVector);
+		EXPECT_EQ(foo.m_map, result.m_map);
+		EXPECT_EQ(foo.m_unorderedMap, result.m_unorderedMap);
+		EXPECT_EQ(foo.m_basic.m_int32t, result.m_basic.m_int32t);
+		EXPECT_EQ(foo.m_basic.m_bool, result.m_basic.m_bool);
+		ASSERT_EQ(2U, result.m_vBasic.size());
+		EXPECT_EQ(127, result.m_vBasic[1].m_int32t);
+		EXPECT_TRUE(result.m_vBasic[1].m_bool);
+	}
+
+	TEST_F(CCborTest, deserialize_skips_unknown_and_mismatched_members)
+	{
+		// {"unknown": [1, {"a": null}], "int32t": 1(h'00'), "bool": true}, with the value of int32t tagged
+		const std::vector<std::uint8_t> buffer = { 0xa3,
+			0x67, 'u', 'n', 'k', 'n', 'o', 'w', 'n', 0x82, 0x01, 0xa1, 0x61, 'a', 0xf6,
+			0x66, 'i', 'n', 't', '3', '2', 't', 0xc1, 0x41, 0x00,
+			0x64, 'b', 'o', 'o', 'l', 0xf5 };
+
+		CCborTestInternal::CBasic basic(5, false);
+		EXPECT_TRUE(DonerSerializer::CCborDeserializer::Deserialize(basic, buffer));
+		EXPECT_EQ(5, basic.m_int32t);
+		EXPECT_TRUE(basic.m_bool);
+
+		// Non deterministic encodings are accepted too, 7 is encoded here with 4 bytes
+		const std::vector<std::uint8_t> longInteger = { 0xa1, 0x66, 'i', 'n', 't', '3', '2', 't', 0x1a, 0x00, 0x00, 0x00, 0x07 };
+		EXPECT_TRUE(DonerSerializer::CCborDeserializer::Deserialize(basic, longInteger));
+		EXPECT_EQ(7, basic.m_int32t);
+
+		// 5000000000 doesn't fit in an int32_t
+		const std::vector<std::uint8_t> bigInteger = { 0xa1, 0x66, 'i', 'n', 't', '3', '2', 't', 0x1b, 0, 0, 0, 0x01, 0x2a, 0x05, 0xf2, 0x00 };
+		EXPECT_TRUE(DonerSerializer::CCborDeserializer::Deserialize(basic, bigInteger));
+		EXPECT_EQ(7, basic.m_int32t);
+
+		const std::vector<std::uint8_t> truncated(buffer.begin(), buffer.end() - 3);
+		EXPECT_FALSE(DonerSerializer::CCborDeserializer::Deserialize(basic, truncated));
+
+		// Indefinite length array
+		const std::vector<std::uint8_t> indefinite = { 0xa1, 0x66, 'i', 'n', 't', '3', '2', 't', 0x9f, 0x01, 0xff };
+		EXPECT_FALSE(DonerSerializer::CCborDeserializer::Deserialize(basic, indefinite));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,194 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#include <donerserializer/DonerBinaryArchive.h>
+#include <donerserializer/DonerColumnar.h>
+#include <donerserializer/DonerDeserialize.h>
+#include <donerserializer/DonerSerialize.h>
+#include <donerserializer/DonerStreamDeserialize.h>
+#include <donerserializer/DonerStreamSerialize.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <string>
+#include <vector>
+
+namespace CColumnarTestInternal
+{
+	class CSample : public DonerSerializer::ISerializable
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CSample)
+	public:
+		CSample()
+			: m_id(0)
+			, m_value(0.f)
+			, m_pointer(nullptr)
+		{}
+
+		CSample(std::int32_t id, float value, const std::string& tag)
+			: m_id(id)
+			, m_value(value)
+			, m_tag(tag)
+			, m_pointer(nullptr)
+		{}
+
+		std::int32_t m_id;
+		float m_value;
+		std::string m_tag;
+		int* m_pointer;
+	};
+
+	class CBasic : public DonerSerializer::ISerializable
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CBasic)
+	public:
+		CBasic()
+			: m_int32t(0)
+		{}
+
+		std::int32_t m_int32t;
+	};
+
+	class CBatch
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CBatch)
+	public:
+		std::vector<CSample> m_samples;
+		std::list<CSample> m_lSamples;
+		std::vector<CBasic> m_basics;
+	};
+
+	CBatch CreateBatch()
+	{
+		CBatch batch;
+		batch.m_samples = { CSample(1, 0.5f, "a"), CSample(2, 1.5f, "b") };
+		batch.m_lSamples = { CSample(3, 2.5f, "c") };
+		batch.m_basics.resize(1);
+		batch.m_basics[0].m_int32t = 7;
+		return batch;
+	}
+
+	void ExpectEqual(const CBatch& expected, const CBatch& result)
+	{
+		ASSERT_EQ(expected.m_samples.size(), result.m_samples.size());
+		for (std::size_t index = 0; index < expected.m_samples.size(); ++index)
+		{
+			EXPECT_EQ(expected.m_samples[index].m_id, result.m_samples[index].m_id);
+			EXPECT_EQ(expected.m_samples[index].m_value, result.m_samples[index].m_value);
+			EXPECT_EQ(expected.m_samples[index].m_tag, result.m_samples[index].m_tag);
+		}
+		ASSERT_EQ(expected.m_lSamples.size(), result.m_lSamples.size());
+		EXPECT_EQ(expected.m_lSamples.front().m_tag, result.m_lSamples.front().m_tag);
+		ASSERT_EQ(expected.m_basics.size(), result.m_basics.size());
+		EXPECT_EQ(expected.m_basics[0].m_int32t, result.m_basics[0].m_int32t);
+	}
+}
+
+DONER_DEFINE_REFLECTION_DATA(CColumnarTestInternal::CSample,
+							   DONER_ADD_NAMED_VAR_INFO(m_id, "id"),
+							   DONER_ADD_NAMED_VAR_INFO(m_value, "value"),
+							   DONER_ADD_NAMED_VAR_INFO(m_tag, "tag"),
+							   DONER_ADD_NAMED_VAR_INFO(m_pointer, "pointer")
+)
+
+DONER_DEFINE_REFLECTION_DATA(CColumnarTestInternal::CBasic,
+							   DONER_ADD_NAMED_VAR_INFO(m_int32t, "int32t")
+)
+
+DONER_DEFINE_REFLECTION_DATA(CColumnarTestInternal::CBatch,
+							   DONER_ADD_NAMED_VAR_INFO(m_samples, "samples"),
+							   DONER_ADD_NAMED_VAR_INFO(m_lSamples, "l_samples"),
+							   DONER_ADD_NAMED_VAR_INFO(m_basics, "basics")
+)
+
+DONER_SERIALIZE_SEQUENCES_AS_COLUMNS(CColumnarTestInternal::CSample)
+
+namespace DonerSerializer
+{
+	class CColumnarTest : public ::testing::Test
+	{
+	public:
+		CColumnarTest() = default;
+		~CColumnarTest() = default;
+	};
+
+	TEST_F(CColumnarTest, json_columns_roundtrip)
+	{
+		const CColumnarTestInternal::CBatch batch = CColumnarTestInternal::CreateBatch();
+
+		const char* const expected = "{\"basics\":[{\"int32t\":7}],"
+			"\"l_samples\":{\"tag\":[\"c\"],\"value\":[2.5],\"id\":[3]},"
+			"\"samples\":{\"tag\":[\"a\",\"b\"],\"value\":[0.5,1.5],\"id\":[1,2]}}";
+
+		DonerSerializer::CJsonSerializer serializer;
+		serializer.Serialize(batch);
+		EXPECT_EQ(expected, serializer.GetJsonString());
+		EXPECT_EQ(expected, DonerSerializer::CJsonStreamSerializer::GetJsonString(batch));
+
+		CColumnarTestInternal::CBatch result;
+		DonerSerializer::CJsonDeserializer::Deserialize(result, expected);
+		CColumnarTestInternal::ExpectEqual(batch, result);
+
+		CColumnarTestInternal::CBatch streamResult;
+		EXPECT_TRUE(DonerSerializer::CJsonStreamDeserializer::Deserialize(streamResult, expected));
+		CColumnarTestInternal::ExpectEqual(batch, streamResult);
+
+		// Elements are appended, as many as the longest column, and unknown columns are ignored
+		DonerSerializer::CJsonDeserializer::Deserialize(result, "{\"samples\":{\"id\":[4,5,6],\"value\":[3.5],\"unknown\":[1]}}");
+		ASSERT_EQ(5U, result.m_samples.size());
+		EXPECT_EQ(6, result.m_samples[4].m_id);
+		EXPECT_EQ(3.5f, result.m_samples[2].m_value);
+		EXPECT_EQ(0.f, result.m_samples[3].m_value);
+
+		// Empty sequences are empty objects
+		CColumnarTestInternal::CBatch empty;
+		EXPECT_EQ("{\"basics\":[],\"l_samples\":{},\"samples\":{}}", DonerSerializer::CJsonStreamSerializer::GetJsonString(empty));
+	}
+
+	TEST_F(CColumnarTest, binary_columns_are_contiguous)
+	{
+		const CColumnarTestInternal::CBatch batch = CColumnarTestInternal::CreateBatch();
+		const std::vector<std::uint8_t> buffer = DonerSerializer::CBinaryArchive::GetBuffer(batch);
+
+		// m_samples is the first member: header, element count and then the id column
+		const std::int32_t ids[] = { 1, 2 };
+		ASSERT_LT(13 + sizeof(ids), buffer.size());
+		EXPECT_EQ(2, buffer[12]);
+		EXPECT_EQ(0, std::memcmp(&buffer[13], ids, sizeof(ids)));
+
+		CColumnarTestInternal::CBatch result;
+		ASSERT_TRUE(DonerSerializer::CBinaryArchive::Load(result, buffer));
+		CColumnarTestInternal::ExpectEqual(batch, result);
+
+		const std::vector<std::uint8_t> truncated(buffer.begin(), buffer.end() - 1);
+		EXPECT_FALSE(DonerSerializer::CBinaryArchive::Load(result, truncated));
+	}
+}
\ No newline at end of file
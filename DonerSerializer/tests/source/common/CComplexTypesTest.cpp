@@ -35,10 +35,12 @@
 
 #include <vector>
 #include <map>
+#include <stdexcept>
 #include <string>
 
 namespace CComplexTypesTestInternal
 {
+	const char* const FOO_JSON_DATA_WITH_VERSION = "{\"version\":1,\"map\":[[1,{\"basic\":{\"bool\":true,\"float\":3.0,\"int32t\":2}}]],\"vector\":[{\"basic\":{\"bool\":false,\"float\":2.0,\"int32t\":1}}]}";
 	const char* const FOO_JSON_DATA = "{\"map\":[[1,{\"basic\":{\"bool\":true,\"float\":3.0,\"int32t\":2}}],[7,{\"basic\":{\"bool\":false,\"float\":2.0,\"int32t\":1}}]],\"vector\":[{\"basic\":{\"bool\":false,\"float\":2.0,\"int32t\":1}},{\"basic\":{\"bool\":true,\"float\":3.0,\"int32t\":2}}]}";
 
 	class CBasic : public DonerSerializer::ISerializable
@@ -82,6 +84,11 @@ namespace CComplexTypesTestInternal
 		std::vector<CFoo> m_vector;
 		std::map<std::uint64_t, CFoo> m_map;
 	};
+
+	struct SChecked
+	{
+		std::int32_t m_value;
+	};
 }
 
 DONER_DEFINE_REFLECTION_DATA(CComplexTypesTestInternal::CBasic,
@@ -99,6 +106,23 @@ DONER_DEFINE_REFLECTION_DATA(CComplexTypesTestInternal::CBar,
 							   DONER_ADD_NAMED_VAR_INFO(m_map, "map")
 )
 
+namespace DonerSerializer
+{
+	template <>
+	class CDeserializationResolver::CDeserializationResolverType<CComplexTypesTestInternal::SChecked>
+	{
+	public:
+		static void Apply(CComplexTypesTestInternal::SChecked& value, const rapidjson::Value& att)
+		{
+			if (att.GetInt() < 0)
+			{
+				throw std::runtime_error("negative value");
+			}
+			value.m_value = att.GetInt();
+		}
+	};
+}
+
 namespace DonerReflection
 {
 	class CComplexTypesTest : public ::testing::Test
@@ -166,4 +190,209 @@ namespace DonerReflection
 
 		ASSERT_STREQ(CComplexTypesTestInternal::FOO_JSON_DATA, result.c_str());
 	}
+
+	TEST_F(CComplexTypesTest, serialize_complex_type_into_existing_document)
+	{
+		CComplexTypesTestInternal::CFoo foo1;
+		foo1.m_basic = CComplexTypesTestInternal::CBasic(1, 2.f, false);
+
+		CComplexTypesTestInternal::CFoo foo2;
+		foo2.m_basic = CComplexTypesTestInternal::CBasic(2, 3.f, true);
+
+		CComplexTypesTestInternal::CBar bar;
+		bar.m_vector.push_back(foo1);
+		bar.m_map[1] = foo2;
+
+		rapidjson::Document document;
+		document.SetObject();
+		document.AddMember("version", 1, document.GetAllocator());
+
+		DonerSerializer::CJsonSerializer::Serialize(bar, document);
+
+		ASSERT_TRUE(document["vector"][0]["basic"].IsObject());
+		EXPECT_EQ(1, document["vector"][0]["basic"]["int32t"].GetInt());
+
+		std::string result = DonerSerializer::CJsonSerializer::GetJsonString(document);
+
+		ASSERT_STREQ(CComplexTypesTestInternal::FOO_JSON_DATA_WITH_VERSION, result.c_str());
+	}
+
+	TEST_F(CComplexTypesTest, deserialize_complex_type_reusing_deserializer)
+	{
+		DonerSerializer::CJsonDeserializer deserializer(1024, 1024);
+
+		std::size_t warmCapacity = 0;
+		for (int i = 0; i < 4; ++i)
+		{
+			ASSERT_TRUE(deserializer.Parse(CComplexTypesTestInternal::FOO_JSON_DATA));
+
+			CComplexTypesTestInternal::CBar bar;
+			deserializer.Deserialize(bar);
+
+			ASSERT_EQ(2U, bar.m_vector.size());
+			EXPECT_EQ(2, bar.m_vector[1].m_basic.m_int32t);
+			ASSERT_EQ(2U, bar.m_map.size());
+			EXPECT_EQ(1, bar.m_map[7].m_basic.m_int32t);
+
+			if (i == 1)
+			{
+				warmCapacity = deserializer.GetCapacity();
+			}
+			else if (i > 1)
+			{
+				EXPECT_EQ(warmCapacity, deserializer.GetCapacity());
+			}
+		}
+
+		EXPECT_FALSE(deserializer.Parse("{\"vector\":["));
+	}
+
+	TEST_F(CComplexTypesTest, deserialize_applies_the_first_of_repeated_keys)
+	{
+		const char* const json = "{\"vector\":[{\"basic\":{\"int32t\":1,\"int32t\":2}}],\"vector\":[{},{}]}";
+
+		CComplexTypesTestInternal::CBar bar;
+		DonerSerializer::CJsonDeserializer::Deserialize(bar, json);
+
+		ASSERT_EQ(1U, bar.m_vector.size());
+		EXPECT_EQ(1, bar.m_vector[0].m_basic.m_int32t);
+	}
+
+	TEST_F(CComplexTypesTest, serialize_complex_type_reusing_serializer)
+	{
+		CComplexTypesTestInternal::CFoo foo1;
+		foo1.m_basic = CComplexTypesTestInternal::CBasic(1, 2.f, false);
+
+		CComplexTypesTestInternal::CFoo foo2;
+		foo2.m_basic = CComplexTypesTestInternal::CBasic(2, 3.f, true);
+
+		CComplexTypesTestInternal::CBar bar;
+		bar.m_vector.push_back(foo1);
+		bar.m_vector.push_back(foo2);
+		bar.m_map[1] = foo2;
+		bar.m_map[7] = foo1;
+
+		DonerSerializer::CJsonSerializer serializer(1024);
+		EXPECT_TRUE(serializer.Serialize(bar));
+		EXPECT_FALSE(serializer.Serialize(foo1));
+
+		std::string result;
+		std::size_t warmCapacity = 0;
+		for (int i = 0; i < 4; ++i)
+		{
+			serializer.SerializeNext(foo1);
+			serializer.GetJsonString(result);
+			ASSERT_STREQ("{\"basic\":{\"bool\":false,\"float\":2.0,\"int32t\":1}}", result.c_str());
+
+			serializer.SerializeNext(bar);
+			serializer.GetJsonString(result);
+			ASSERT_STREQ(CComplexTypesTestInternal::FOO_JSON_DATA, result.c_str());
+
+			if (i == 1)
+			{
+				warmCapacity = serializer.GetCapacity();
+			}
+			else if (i > 1)
+			{
+				EXPECT_EQ(warmCapacity, serializer.GetCapacity());
+			}
+		}
+	}
+
+	TEST_F(CComplexTypesTest, serialize_complex_type_reusing_default_serializer)
+	{
+		CComplexTypesTestInternal::CFoo foo;
+		foo.m_basic = CComplexTypesTestInternal::CBasic(1, 2.f, false);
+
+		DonerSerializer::CJsonSerializer serializer;
+		EXPECT_TRUE(serializer.Serialize(foo));
+		EXPECT_EQ(0u, serializer.GetCapacity());
+		EXPECT_STREQ("{\"basic\":{\"bool\":false,\"float\":2.0,\"int32t\":1}}", serializer.GetJsonString().c_str());
+
+		EXPECT_TRUE(serializer.SerializeNext(foo));
+		EXPECT_LT(0u, serializer.GetCapacity());
+		EXPECT_STREQ("{\"basic\":{\"bool\":false,\"float\":2.0,\"int32t\":1}}", serializer.GetJsonString().c_str());
+	}
+
+	TEST_F(CComplexTypesTest, deserialize_complex_type_in_parallel)
+	{
+		std::string json = "{\"vector\":[";
+		for (int index = 0; index < 5000; ++index)
+		{
+			json += (index == 0) ? "" : ",";
+			json += "{\"basic\":{\"bool\":" + std::string(index % 2 == 0 ? "true" : "false") + ",\"float\":1.5,\"int32t\":" + std::to_string(index) + "}}";
+		}
+		json += "]}";
+
+		CComplexTypesTestInternal::CBar sequentialBar;
+		DonerSerializer::CJsonDeserializer::Deserialize(sequentialBar, json.c_str());
+
+		CComplexTypesTestInternal::CBar parallelBar;
+		parallelBar.m_vector.resize(1);
+		{
+			DonerSerializer::CParallelDeserializationScope scope(4, 16);
+			DonerSerializer::CJsonDeserializer::Deserialize(parallelBar, json.c_str());
+		}
+
+		ASSERT_EQ(5001U, parallelBar.m_vector.size());
+		ASSERT_EQ(5000U, sequentialBar.m_vector.size());
+		for (std::size_t index = 0; index < sequentialBar.m_vector.size(); ++index)
+		{
+			const CComplexTypesTestInternal::CBasic& expected = sequentialBar.m_vector[index].m_basic;
+			const CComplexTypesTestInternal::CBasic& actual = parallelBar.m_vector[index + 1].m_basic;
+			ASSERT_EQ(static_cast<std::int32_t>(index), actual.m_int32t);
+			EXPECT_EQ(expected.m_int32t, actual.m_int32t);
+			EXPECT_EQ(expected.m_float, actual.m_float);
+			EXPECT_EQ(expected.m_bool, actual.m_bool);
+		}
+		EXPECT_FALSE(DonerSerializer::CParallelDeserializationScope::GetSettings().m_enabled);
+	}
+
+	TEST_F(CComplexTypesTest, deserialize_in_parallel_restores_settings_on_exceptions)
+	{
+		std::string json = "[";
+		for (int index = 0; index < 64; ++index)
+		{
+			json += (index == 0) ? "" : ",";
+			json += std::to_string(index == 40 ? -1 : index);
+		}
+		json += "]";
+		rapidjson::Document document;
+		document.Parse(json.c_str());
+
+		DonerSerializer::CParallelDeserializationScope scope(4, 16);
+		std::vector<CComplexTypesTestInternal::SChecked> values;
+		EXPECT_THROW(DonerSerializer::CDeserializationResolver::CDeserializationResolverType<std::vector<CComplexTypesTestInternal::SChecked>>::Apply(values, static_cast<const rapidjson::Value&>(document)), std::runtime_error);
+
+		const DonerSerializer::CParallelDeserializationScope::SSettings& settings = DonerSerializer::CParallelDeserializationScope::GetSettings();
+		EXPECT_TRUE(settings.m_enabled);
+		EXPECT_EQ(4U, settings.m_threadCount);
+		EXPECT_EQ(16U, settings.m_minElements);
+	}
+
+	TEST_F(CComplexTypesTest, serialize_complex_type_with_custom_allocators)
+	{
+		CComplexTypesTestInternal::CBar bar;
+		DonerSerializer::CJsonDeserializer::Deserialize(bar, CComplexTypesTestInternal::FOO_JSON_DATA);
+
+		// Values allocated one by one, freed with the document
+		rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::CrtAllocator> crtDocument;
+		DonerSerializer::CJsonSerializer::Serialize(bar, crtDocument);
+		EXPECT_STREQ(CComplexTypesTestInternal::FOO_JSON_DATA, DonerSerializer::CJsonSerializer::GetJsonString(crtDocument).c_str());
+
+		// Values allocated from a caller owned arena, released at once
+		char arena[16384];
+		rapidjson::MemoryPoolAllocator<> arenaAllocator(arena, sizeof(arena));
+		rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::MemoryPoolAllocator<>, rapidjson::CrtAllocator> arenaDocument(&arenaAllocator);
+		DonerSerializer::CJsonSerializer::Serialize(bar, arenaDocument);
+		EXPECT_STREQ(CComplexTypesTestInternal::FOO_JSON_DATA, DonerSerializer::CJsonSerializer::GetJsonString(arenaDocument).c_str());
+		EXPECT_GE(sizeof(arena), arenaAllocator.Size());
+
+		CComplexTypesTestInternal::CBar result;
+		DonerSerializer::CJsonDeserializer::Deserialize(result, crtDocument);
+		ASSERT_EQ(2U, result.m_vector.size());
+		EXPECT_EQ(2, result.m_vector[1].m_basic.m_int32t);
+		ASSERT_EQ(2U, result.m_map.size());
+		EXPECT_TRUE(result.m_map[1].m_basic.m_bool);
+	}
 }
\ No newline at end of file
@@ -0,0 +1,226 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#include <donerserializer/CCompression.h>
+#include <donerserializer/CLzCodec.h>
+#include <donerserializer/CZlibCodec.h>
+#include <donerserializer/DonerBinaryArchive.h>
+#include <donerserializer/DonerDeserialize.h>
+#include <donerserializer/DonerSerialize.h>
+#include <donerserializer/DonerStreamDeserialize.h>
+#include <donerserializer/DonerStreamSerialize.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace CCompressionTestInternal
+{
+	class CSnapshot
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CSnapshot)
+	public:
+		std::string m_name;
+		std::vector<std::int32_t> m_values;
+	};
+
+	CSnapshot CreateSnapshot()
+	{
+		CSnapshot snapshot;
+		snapshot.m_name = "snapshot";
+		// Big enough to span several LZ blocks once serialized
+		for (std::int32_t index = 0; index < 40000; ++index)
+		{
+			snapshot.m_values.push_back(index % 100);
+		}
+		return snapshot;
+	}
+
+	class CStringSink
+	{
+	public:
+		explicit CStringSink(std::string& output) : m_output(&output) {}
+
+		bool operator()(const char* data, std::size_t size) const
+		{
+			m_output->append(data, size);
+			return true;
+		}
+
+	private:
+		std::string* m_output;
+	};
+
+	template<class Compressor, class Decompressor>
+	void ExpectRoundtrip(Compressor& compressor, Decompressor& decompressor, const std::string& text)
+	{
+		std::string compressed;
+		ASSERT_TRUE(DonerSerializer::CCompression::Compress(compressor, text.data(), text.size(), CStringSink(compressed)));
+		std::vector<char> decompressed;
+		ASSERT_TRUE(DonerSerializer::CCompression::Decompress(decompressor, DonerSerializer::CMemorySource(compressed.data(), compressed.size()), decompressed));
+		EXPECT_EQ(text, std::string(decompressed.begin(), decompressed.end()));
+	}
+
+	template<class Compressor, class Decompressor>
+	void ExpectJsonRoundtrip(Compressor& compressor, Decompressor& decompressor)
+	{
+		const CSnapshot snapshot = CreateSnapshot();
+		const std::string json = DonerSerializer::CJsonStreamSerializer::GetJsonString(snapshot);
+
+		std::string compressed;
+		ASSERT_TRUE(DonerSerializer::CJsonStreamSerializer::SerializeCompressedToSink(snapshot, CStringSink(compressed), compressor, 1000));
+		EXPECT_LT(compressed.size() * 5, json.size());
+
+		DonerSerializer::CJsonSerializer serializer;
+		serializer.Serialize(snapshot);
+		std::string documentCompressed;
+		ASSERT_TRUE(serializer.WriteCompressed(CStringSink(documentCompressed), compressor));
+		EXPECT_EQ(compressed, documentCompressed);
+
+		CSnapshot streamResult;
+		ASSERT_TRUE(DonerSerializer::CJsonStreamDeserializer::DeserializeCompressed(streamResult, compressed.data(), compressed.size(), decompressor, 1000));
+		EXPECT_EQ(snapshot.m_name, streamResult.m_name);
+		EXPECT_EQ(snapshot.m_values, streamResult.m_values);
+
+		DonerSerializer::CJsonDeserializer deserializer;
+		ASSERT_TRUE(deserializer.ParseCompressed(compressed.data(), compressed.size(), decompressor));
+		CSnapshot documentResult;
+		deserializer.Deserialize(documentResult);
+		EXPECT_EQ(snapshot.m_values, documentResult.m_values);
+
+		// Truncated streams fail even if the JSON text is complete
+		CSnapshot truncatedResult;
+		EXPECT_FALSE(DonerSerializer::CJsonStreamDeserializer::DeserializeCompressed(truncatedResult, compressed.data(), compressed.size() - 1, decompressor));
+		EXPECT_FALSE(deserializer.ParseCompressed(compressed.data(), compressed.size() - 1, decompressor));
+	}
+}
+
+DONER_DEFINE_REFLECTION_DATA(CCompressionTestInternal::CSnapshot,
+							   DONER_ADD_NAMED_VAR_INFO(m_name, "name"),
+							   DONER_ADD_NAMED_VAR_INFO(m_values, "values")
+)
+
+namespace DonerSerializer
+{
+	class CCompressionTest : public ::testing::Test
+	{
+	public:
+		CCompressionTest() = default;
+		~CCompressionTest() = default;
+	};
+
+	TEST_F(CCompressionTest, lz_roundtrip)
+	{
+		DonerSerializer::CLzCompressor compressor;
+		DonerSerializer::CLzDecompressor decompressor;
+
+		std::string random;
+		std::uint32_t seed = 12345;
+		for (std::size_t index = 0; index < 70000; ++index)
+		{
+			seed = seed * 1103515245U + 12345U;
+			random.push_back(static_cast<char>(seed >> 24));
+		}
+		const std::string repeated(200000, 'a');
+		const std::string texts[] = { "", "a", "abcdabcdabcdabcdabcd", random, repeated, random + repeated + random };
+		for (const std::string& text : texts)
+		{
+			CCompressionTestInternal::ExpectRoundtrip(compressor, decompressor, text);
+		}
+
+		std::string compressed;
+		ASSERT_TRUE(DonerSerializer::CCompression::Compress(compressor, repeated.data(), repeated.size(), CCompressionTestInternal::CStringSink(compressed)));
+		EXPECT_LT(compressed.size(), repeated.size() / 100);
+
+		// Corrupt streams are rejected, never read or written out of bounds
+		std::vector<char> output;
+		std::string corrupt = compressed;
+		corrupt[0] = 'X';
+		EXPECT_FALSE(DonerSerializer::CCompression::Decompress(decompressor, DonerSerializer::CMemorySource(corrupt.data(), corrupt.size()), output));
+		for (std::size_t index = 4; index < compressed.size(); ++index)
+		{
+			corrupt = compressed;
+			corrupt[index] = static_cast<char>(corrupt[index] ^ 0x5a);
+			DonerSerializer::CCompression::Decompress(decompressor, DonerSerializer::CMemorySource(corrupt.data(), corrupt.size()), output);
+			EXPECT_TRUE(DonerSerializer::CCompression::Decompress(decompressor, DonerSerializer::CMemorySource(compressed.data(), compressed.size()), output));
+		}
+		EXPECT_EQ(repeated.size(), output.size());
+
+		CCompressionTestInternal::ExpectJsonRoundtrip(compressor, decompressor);
+	}
+
+	TEST_F(CCompressionTest, compressed_files)
+	{
+		const CCompressionTestInternal::CSnapshot snapshot = CCompressionTestInternal::CreateSnapshot();
+		const char* const path = "CCompressionTest.json.lz";
+		DonerSerializer::CLzCompressor compressor;
+		ASSERT_TRUE(DonerSerializer::CJsonStreamSerializer::SerializeCompressedToFile(snapshot, path, compressor));
+
+		DonerSerializer::CLzDecompressor decompressor;
+		CCompressionTestInternal::CSnapshot result;
+		EXPECT_TRUE(DonerSerializer::CJsonStreamDeserializer::DeserializeCompressedFromFile(result, path, decompressor));
+		EXPECT_EQ(snapshot.m_values, result.m_values);
+		std::remove(path);
+		EXPECT_FALSE(DonerSerializer::CJsonStreamDeserializer::DeserializeCompressedFromFile(result, path, decompressor));
+
+		// Binary archives are compressed as a whole buffer
+		const std::vector<std::uint8_t> archive = DonerSerializer::CBinaryArchive::GetBuffer(snapshot);
+		std::string compressed;
+		ASSERT_TRUE(DonerSerializer::CCompression::Compress(compressor, archive.data(), archive.size(), CCompressionTestInternal::CStringSink(compressed)));
+		std::vector<std::uint8_t> decompressed;
+		ASSERT_TRUE(DonerSerializer::CCompression::Decompress(decompressor, DonerSerializer::CMemorySource(compressed.data(), compressed.size()), decompressed));
+		CCompressionTestInternal::CSnapshot archiveResult;
+		ASSERT_TRUE(DonerSerializer::CBinaryArchive::Load(archiveResult, decompressed));
+		EXPECT_EQ(snapshot.m_values, archiveResult.m_values);
+	}
+
+#ifdef DONER_SERIALIZER_HAS_ZLIB
+	TEST_F(CCompressionTest, zlib_roundtrip)
+	{
+		DonerSerializer::CZlibCompressor gzipCompressor;
+		DonerSerializer::CZlibCompressor zlibCompressor(Z_BEST_SPEED, DonerSerializer::EZlibFormat::Zlib);
+		DonerSerializer::CZlibDecompressor decompressor;
+
+		const std::string text = "{\"values\":[1,2,3,1,2,3,1,2,3,1,2,3]}";
+		CCompressionTestInternal::ExpectRoundtrip(gzipCompressor, decompressor, text);
+		CCompressionTestInternal::ExpectRoundtrip(zlibCompressor, decompressor, text);
+		CCompressionTestInternal::ExpectRoundtrip(gzipCompressor, decompressor, std::string());
+
+		std::string compressed;
+		ASSERT_TRUE(DonerSerializer::CCompression::Compress(gzipCompressor, text.data(), text.size(), CCompressionTestInternal::CStringSink(compressed)));
+		ASSERT_LT(2U, compressed.size());
+		EXPECT_EQ('\x1f', compressed[0]);
+		EXPECT_EQ('\x8b', compressed[1]);
+
+		CCompressionTestInternal::ExpectJsonRoundtrip(gzipCompressor, decompressor);
+	}
+#endif
+}
\ No newline at end of file
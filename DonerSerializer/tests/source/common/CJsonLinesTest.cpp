@@ -0,0 +1,391 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#include <donerserializer/CJsonLinesReader.h>
+#include <donerserializer/CJsonLinesWriter.h>
+#include <donerserializer/CParallelJsonLinesReader.h>
+#include <donerserializer/DonerFileDeserialize.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace CJsonLinesTestInternal
+{
+	const char* const EVENTS_JSON_LINES = "{\"values\":[1,2],\"name\":\"start\",\"id\":1}\n{\"values\":[],\"name\":\"tick\",\"id\":2}\n{\"values\":[3],\"name\":\"stop\",\"id\":3}\n";
+
+	class CEvent : public DonerSerializer::ISerializable
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CEvent)
+	public:
+		CEvent()
+			: m_id(0)
+		{}
+
+		CEvent(std::int32_t id, const std::string& name, const std::vector<std::int32_t>& values)
+			: m_id(id)
+			, m_name(name)
+			, m_values(values)
+		{}
+
+		std::int32_t m_id;
+		std::string m_name;
+		std::vector<std::int32_t> m_values;
+	};
+
+	const char* const EVENTS_JSON_LINES_WITH_ERRORS = "{\"values\":[1,2],\"name\":\"start\",\"id\":1}\r\n\n{\"values\":[4,\n{\"values\":[],\"name\":\"tick\",\"id\":2}\n{\"values\":[3],\"name\":\"stop\",\"id\":3}";
+
+	// Parsing a delay sleeps for its milliseconds. Every record alive is counted.
+	struct SDelay
+	{
+		std::int32_t m_milliseconds;
+	};
+
+	class CSlowEvent
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CSlowEvent)
+	public:
+		CSlowEvent()
+			: m_id(0)
+			, m_delay{ 0 }
+		{
+			OnCreated();
+		}
+
+		CSlowEvent(const CSlowEvent& other)
+			: m_id(other.m_id)
+			, m_delay(other.m_delay)
+		{
+			OnCreated();
+		}
+
+		~CSlowEvent()
+		{
+			--GetAlive();
+		}
+
+		CSlowEvent& operator=(const CSlowEvent& other) = default;
+
+		static std::atomic<std::size_t>& GetAlive()
+		{
+			static std::atomic<std::size_t> alive(0);
+			return alive;
+		}
+
+		static std::atomic<std::size_t>& GetMaxAlive()
+		{
+			static std::atomic<std::size_t> maxAlive(0);
+			return maxAlive;
+		}
+
+		std::int32_t m_id;
+		SDelay m_delay;
+
+	private:
+		static void OnCreated()
+		{
+			const std::size_t alive = ++GetAlive();
+			std::size_t maxAlive = GetMaxAlive();
+			while (alive > maxAlive && !GetMaxAlive().compare_exchange_weak(maxAlive, alive))
+			{}
+		}
+	};
+
+	std::vector<CEvent> CreateEvents()
+	{
+		return { CEvent(1, "start", { 1, 2 }), CEvent(2, "tick", {}), CEvent(3, "stop", { 3 }) };
+	}
+}
+
+namespace DonerSerializer
+{
+	template <>
+	class CDeserializationResolver::CDeserializationResolverType<CJsonLinesTestInternal::SDelay>
+	{
+	public:
+		static void Apply(CJsonLinesTestInternal::SDelay& value, const rapidjson::Value& att)
+		{
+			if (att.IsInt())
+			{
+				value.m_milliseconds = att.GetInt();
+				std::this_thread::sleep_for(std::chrono::milliseconds(value.m_milliseconds));
+			}
+		}
+	};
+}
+
+DONER_DEFINE_REFLECTION_DATA(CJsonLinesTestInternal::CSlowEvent,
+							   DONER_ADD_NAMED_VAR_INFO(m_id, "id"),
+							   DONER_ADD_NAMED_VAR_INFO(m_delay, "delay")
+)
+
+DONER_DEFINE_REFLECTION_DATA(CJsonLinesTestInternal::CEvent,
+							   DONER_ADD_NAMED_VAR_INFO(m_id, "id"),
+							   DONER_ADD_NAMED_VAR_INFO(m_name, "name"),
+							   DONER_ADD_NAMED_VAR_INFO(m_values, "values")
+)
+
+namespace DonerSerializer
+{
+	class CJsonLinesTest : public ::testing::Test
+	{
+	public:
+		CJsonLinesTest() = default;
+		~CJsonLinesTest() = default;
+	};
+
+	TEST_F(CJsonLinesTest, write_records_to_buffer)
+	{
+		std::vector<CJsonLinesTestInternal::CEvent> events = CJsonLinesTestInternal::CreateEvents();
+
+		DonerSerializer::CJsonLinesWriter<CJsonLinesTestInternal::CEvent> writer;
+		EXPECT_TRUE(writer.Write(events.begin(), events.end()));
+
+		EXPECT_EQ(std::string(CJsonLinesTestInternal::EVENTS_JSON_LINES), std::string(writer.GetData(), writer.GetSize()));
+
+		writer.Clear();
+		EXPECT_TRUE(writer.Write(events[1]));
+		EXPECT_EQ(std::string("{\"values\":[],\"name\":\"tick\",\"id\":2}\n"), std::string(writer.GetData(), writer.GetSize()));
+	}
+
+	TEST_F(CJsonLinesTest, write_records_flushing_by_thresholds)
+	{
+		std::vector<CJsonLinesTestInternal::CEvent> events = CJsonLinesTestInternal::CreateEvents();
+
+		std::string output;
+		std::size_t flushes = 0;
+		auto sink = [&output, &flushes](const char* data, std::size_t size)
+		{
+			output.append(data, size);
+			++flushes;
+			return true;
+		};
+
+		{
+			DonerSerializer::CJsonLinesWriter<CJsonLinesTestInternal::CEvent> writer(sink, 0, 2);
+			EXPECT_TRUE(writer.Write(events.begin(), events.end()));
+			EXPECT_EQ(1U, flushes);
+		}
+		EXPECT_EQ(2U, flushes);
+		EXPECT_EQ(std::string(CJsonLinesTestInternal::EVENTS_JSON_LINES), output);
+
+		output.clear();
+		flushes = 0;
+		DonerSerializer::CJsonLinesWriter<CJsonLinesTestInternal::CEvent> writer(sink, 1);
+		EXPECT_TRUE(writer.Write(events.begin(), events.end()));
+		EXPECT_EQ(3U, flushes);
+		EXPECT_EQ(0U, writer.GetSize());
+		EXPECT_EQ(std::string(CJsonLinesTestInternal::EVENTS_JSON_LINES), output);
+
+		DonerSerializer::CJsonLinesWriter<CJsonLinesTestInternal::CEvent> failingWriter([](const char*, std::size_t) { return false; }, 1);
+		EXPECT_FALSE(failingWriter.Write(events[0]));
+		EXPECT_TRUE(failingWriter.HasFailed());
+	}
+
+	TEST_F(CJsonLinesTest, read_records_from_buffer)
+	{
+		DonerSerializer::CJsonLinesReader<CJsonLinesTestInternal::CEvent> reader;
+
+		std::vector<CJsonLinesTestInternal::CEvent> events;
+		auto callback = [&events](CJsonLinesTestInternal::CEvent& event)
+		{
+			events.push_back(event);
+			return true;
+		};
+
+		const char* const data = CJsonLinesTestInternal::EVENTS_JSON_LINES_WITH_ERRORS;
+		EXPECT_FALSE(reader.Read(data, std::strlen(data), callback));
+		EXPECT_EQ(1U, reader.GetFailedLines());
+
+		ASSERT_EQ(3U, events.size());
+		EXPECT_EQ(1, events[0].m_id);
+		EXPECT_EQ(std::vector<std::int32_t>({ 1, 2 }), events[0].m_values);
+		EXPECT_EQ(2, events[1].m_id);
+		EXPECT_EQ(std::string("tick"), events[1].m_name);
+		EXPECT_TRUE(events[1].m_values.empty());
+		EXPECT_EQ(3, events[2].m_id);
+		EXPECT_EQ(std::vector<std::int32_t>({ 3 }), events[2].m_values);
+
+		std::size_t count = 0;
+		EXPECT_TRUE(reader.Read(CJsonLinesTestInternal::EVENTS_JSON_LINES, std::strlen(CJsonLinesTestInternal::EVENTS_JSON_LINES), [&count](CJsonLinesTestInternal::CEvent&)
+		{
+			return ++count < 2;
+		}));
+		EXPECT_EQ(2U, count);
+	}
+
+	TEST_F(CJsonLinesTest, read_records_keeping_member_capacity)
+	{
+		const char* const data = "{\"values\":[1,2,3,4],\"name\":\"a name too long for the small string buffer\",\"id\":1}\n"
+			"{\"values\":[5],\"name\":\"short\",\"id\":2}\n"
+			"{\"id\":3}\n";
+
+		DonerSerializer::CJsonLinesReader<CJsonLinesTestInternal::CEvent> reader;
+		std::vector<const void*> nameBuffers;
+		std::vector<const void*> valueBuffers;
+		std::vector<CJsonLinesTestInternal::CEvent> events;
+		EXPECT_TRUE(reader.Read(data, std::strlen(data), [&](CJsonLinesTestInternal::CEvent& event)
+		{
+			nameBuffers.push_back(event.m_name.data());
+			valueBuffers.push_back(event.m_values.data());
+			events.push_back(event);
+			return true;
+		}));
+
+		// Members missing from a line are reset too
+		ASSERT_EQ(3U, events.size());
+		EXPECT_EQ(std::string("short"), events[1].m_name);
+		EXPECT_EQ(std::vector<std::int32_t>({ 5 }), events[1].m_values);
+		EXPECT_TRUE(events[2].m_name.empty());
+		EXPECT_TRUE(events[2].m_values.empty());
+		EXPECT_EQ(3, events[2].m_id);
+
+		EXPECT_EQ(nameBuffers[0], nameBuffers[1]);
+		EXPECT_EQ(valueBuffers[0], valueBuffers[1]);
+	}
+
+	TEST_F(CJsonLinesTest, read_records_from_files)
+	{
+		const char* const path = "CJsonLinesTest.jsonl";
+		std::FILE* file = std::fopen(path, "wb");
+		ASSERT_TRUE(file != nullptr);
+		{
+			std::vector<CJsonLinesTestInternal::CEvent> events = CJsonLinesTestInternal::CreateEvents();
+			DonerSerializer::CFileSink sink(file);
+			DonerSerializer::CJsonLinesWriter<CJsonLinesTestInternal::CEvent> writer(sink);
+			EXPECT_TRUE(writer.Write(events.begin(), events.end()));
+		}
+		std::fclose(file);
+
+		DonerSerializer::CJsonLinesReader<CJsonLinesTestInternal::CEvent> reader(1024, 1024);
+
+		std::vector<std::int32_t> ids;
+		auto callback = [&ids](CJsonLinesTestInternal::CEvent& event)
+		{
+			ids.push_back(event.m_id);
+			return true;
+		};
+
+		EXPECT_TRUE(DonerSerializer::CJsonFileDeserializer::Read(reader, path, callback));
+		EXPECT_EQ(std::vector<std::int32_t>({ 1, 2, 3 }), ids);
+
+		// A buffer smaller than a line forces it to grow
+		ids.clear();
+		file = std::fopen(path, "rb");
+		ASSERT_TRUE(file != nullptr);
+		EXPECT_TRUE(reader.Read(file, callback, 8));
+		std::fclose(file);
+		std::remove(path);
+		EXPECT_EQ(std::vector<std::int32_t>({ 1, 2, 3 }), ids);
+
+		EXPECT_FALSE(DonerSerializer::CJsonFileDeserializer::Read(reader, path, callback));
+	}
+
+	TEST_F(CJsonLinesTest, read_records_in_parallel)
+	{
+		DonerSerializer::CJsonLinesWriter<CJsonLinesTestInternal::CEvent> writer;
+		std::vector<std::int32_t> expectedIds;
+		for (std::int32_t id = 0; id < 1000; ++id)
+		{
+			writer.Write(CJsonLinesTestInternal::CEvent(id, "event", { id, id + 1 }));
+			expectedIds.push_back(id);
+		}
+		std::string data(writer.GetData(), writer.GetSize());
+		data += "{\"id\":\n";
+
+		using TReader = DonerSerializer::CParallelJsonLinesReader<CJsonLinesTestInternal::CEvent>;
+		TReader reader(4, 256);
+
+		std::vector<std::int32_t> ids;
+		bool valuesMatch = true;
+		EXPECT_FALSE(reader.Read(data.data(), data.size(), [&ids, &valuesMatch](CJsonLinesTestInternal::CEvent& event)
+		{
+			ids.push_back(event.m_id);
+			valuesMatch = valuesMatch && event.m_values == std::vector<std::int32_t>({ event.m_id, event.m_id + 1 });
+			return true;
+		}));
+		EXPECT_EQ(1U, reader.GetFailedLines());
+		EXPECT_TRUE(valuesMatch);
+		EXPECT_EQ(expectedIds, ids);
+
+		ids.clear();
+		std::mutex idsMutex;
+		EXPECT_TRUE(reader.Read(data.data(), data.size() - 8, [&ids, &idsMutex](CJsonLinesTestInternal::CEvent& event)
+		{
+			std::lock_guard<std::mutex> lock(idsMutex);
+			ids.push_back(event.m_id);
+			return true;
+		}, TReader::EOrder::Unordered));
+		std::sort(ids.begin(), ids.end());
+		EXPECT_EQ(expectedIds, ids);
+
+		ids.clear();
+		EXPECT_TRUE(reader.Read(data.data(), data.size() - 8, [&ids](CJsonLinesTestInternal::CEvent& event)
+		{
+			ids.push_back(event.m_id);
+			return ids.size() < 10;
+		}));
+		EXPECT_EQ(std::vector<std::int32_t>(expectedIds.begin(), expectedIds.begin() + 10), ids);
+	}
+
+	TEST_F(CJsonLinesTest, read_records_in_order_bounds_the_reorder_buffer)
+	{
+		// One record per chunk, and the first one takes long enough for the others to run ahead
+		std::string data = "{\"delay\":200,\"id\":0}\n";
+		for (std::int32_t id = 1; id < 400; ++id)
+		{
+			data += "{\"id\":" + std::to_string(id) + "}\n";
+		}
+
+		using TReader = DonerSerializer::CParallelJsonLinesReader<CJsonLinesTestInternal::CSlowEvent>;
+		const std::size_t threadCount = 4;
+		TReader reader(threadCount, 1);
+
+		std::int32_t nextId = 0;
+		CJsonLinesTestInternal::CSlowEvent::GetMaxAlive() = CJsonLinesTestInternal::CSlowEvent::GetAlive().load();
+		EXPECT_TRUE(reader.Read(data.data(), data.size(), [&nextId](CJsonLinesTestInternal::CSlowEvent& event)
+		{
+			return event.m_id == nextId++;
+		}));
+		EXPECT_EQ(400, nextId);
+
+		// The reused records of every worker, plus a window of chunks waiting to be delivered
+		const std::size_t bound = threadCount + threadCount * TReader::REORDER_CHUNKS_PER_THREAD;
+		EXPECT_LE(CJsonLinesTestInternal::CSlowEvent::GetMaxAlive().load(), bound);
+	}
+}
\ No newline at end of file
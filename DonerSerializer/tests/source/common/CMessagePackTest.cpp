@@ -0,0 +1,238 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#include <donerserializer/DonerMessagePackSerialize.h>
+#include <donerserializer/DonerMessagePackDeserialize.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace CMessagePackTestInternal
+{
+	class CBasic : public DonerSerializer::ISerializable
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CBasic)
+	public:
+		CBasic()
+			: m_int32t(0)
+			, m_bool(false)
+		{}
+
+		CBasic(std::int32_t int32t, bool _bool)
+			: m_int32t(int32t)
+			, m_bool(_bool)
+		{}
+
+		std::int32_t m_int32t;
+		bool m_bool;
+	};
+
+	class CFoo
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CFoo)
+	public:
+		enum class EEnumTest { Test1, Test2 };
+
+		CFoo()
+			: m_int32t(0)
+			, m_uint32t(0)
+			, m_int64t(0)
+			, m_uint64t(0)
+			, m_float(0.f)
+			, m_double(0.0)
+			, m_bool(false)
+			, m_enum(EEnumTest::Test1)
+		{}
+
+		std::int32_t m_int32t;
+		std::uint32_t m_uint32t;
+		std::int64_t m_int64t;
+		std::uint64_t m_uint64t;
+		float m_float;
+		double m_double;
+		bool m_bool;
+		EEnumTest m_enum;
+		std::string m_string;
+		std::vector<std::string> m_vString;
+		std::vector<bool> m_vBool;
+		std::vector<std::vector<std::int32_t>> m_vVector;
+		std::map<std::int32_t, std::string> m_map;
+		std::unordered_map<std::string, std::int32_t> m_unorderedMap;
+		CBasic m_basic;
+		std::vector<CBasic> m_vBasic;
+	};
+
+	CFoo CreateFoo()
+	{
+		CFoo foo;
+		foo.m_int32t = -100000;
+		foo.m_uint32t = 4000000000U;
+		foo.m_int64t = -5000000000LL;
+		foo.m_uint64t = 18000000000000000000ULL;
+		foo.m_float = 5.5f;
+		foo.m_double = 0.1;
+		foo.m_bool = true;
+		foo.m_enum = CFoo::EEnumTest::Test2;
+		foo.m_string = std::string(40, 'x');
+		foo.m_vString = { "a", "" };
+		foo.m_vBool = { true, false, true };
+		foo.m_vVector = { { 0, -1 }, {}, { 300 } };
+		foo.m_map[-7] = "minus seven";
+		foo.m_map[70000] = "big";
+		foo.m_unorderedMap["two"] = 2;
+		foo.m_basic = CBasic(-33, true);
+		foo.m_vBasic = { CBasic(1, false), CBasic(127, true) };
+		return foo;
+	}
+}
+
+DONER_DEFINE_REFLECTION_DATA(CMessagePackTestInternal::CBasic,
+							   DONER_ADD_NAMED_VAR_INFO(m_int32t, "int32t"),
+							   DONER_ADD_NAMED_VAR_INFO(m_bool, "bool")
+)
+
+DONER_DEFINE_REFLECTION_DATA(CMessagePackTestInternal::CFoo,
+							   DONER_ADD_NAMED_VAR_INFO(m_int32t, "int32t"),
+							   DONER_ADD_NAMED_VAR_INFO(m_uint32t, "uint32t"),
+							   DONER_ADD_NAMED_VAR_INFO(m_int64t, "int64t"),
+							   DONER_ADD_NAMED_VAR_INFO(m_uint64t, "uint64t"),
+							   DONER_ADD_NAMED_VAR_INFO(m_float, "float"),
+							   DONER_ADD_NAMED_VAR_INFO(m_double, "double"),
+							   DONER_ADD_NAMED_VAR_INFO(m_bool, "bool"),
+							   DONER_ADD_NAMED_VAR_INFO(m_enum, "enum"),
+							   DONER_ADD_NAMED_VAR_INFO(m_string, "string"),
+							   DONER_ADD_NAMED_VAR_INFO(m_vString, "v_string"),
+							   DONER_ADD_NAMED_VAR_INFO(m_vBool, "v_bool"),
+							   DONER_ADD_NAMED_VAR_INFO(m_vVector, "v_vector"),
+							   DONER_ADD_NAMED_VAR_INFO(m_map, "map"),
+							   DONER_ADD_NAMED_VAR_INFO(m_unorderedMap, "u_map"),
+							   DONER_ADD_NAMED_VAR_INFO(m_basic, "basic"),
+							   DONER_ADD_NAMED_VAR_INFO(m_vBasic, "v_basic")
+)
+
+namespace DonerSerializer
+{
+	class CMessagePackTest : public ::testing::Test
+	{
+	public:
+		CMessagePackTest() = default;
+		~CMessagePackTest() = default;
+	};
+
+	TEST_F(CMessagePackTest, serialize_uses_smallest_encodings)
+	{
+		CMessagePackTestInternal::CBasic basic(300, true);
+
+		std::vector<std::uint8_t> expected = { 0x82, 0xa4, 'b', 'o', 'o', 'l', 0xc3, 0xa6, 'i', 'n', 't', '3', '2', 't', 0xcd, 0x01, 0x2c };
+		EXPECT_EQ(expected, DonerSerializer::CMessagePackSerializer::GetBuffer(basic));
+
+		basic.m_int32t = -1;
+		expected = { 0x82, 0xa4, 'b', 'o', 'o', 'l', 0xc3, 0xa6, 'i', 'n', 't', '3', '2', 't', 0xff };
+		EXPECT_EQ(expected, DonerSerializer::CMessagePackSerializer::GetBuffer(basic));
+
+		basic.m_int32t = -200;
+		expected = { 0x82, 0xa4, 'b', 'o', 'o', 'l', 0xc3, 0xa6, 'i', 'n', 't', '3', '2', 't', 0xd1, 0xff, 0x38 };
+		EXPECT_EQ(expected, DonerSerializer::CMessagePackSerializer::GetBuffer(basic));
+	}
+
+	TEST_F(CMessagePackTest, roundtrip_all_supported_types)
+	{
+		const CMessagePackTestInternal::CFoo foo = CMessagePackTestInternal::CreateFoo();
+		const std::vector<std::uint8_t> buffer = DonerSerializer::CMessagePackSerializer::GetBuffer(foo);
+
+		CMessagePackTestInternal::CFoo result;
+		ASSERT_TRUE(DonerSerializer::CMessagePackDeserializer::Deserialize(result, buffer));
+
+		EXPECT_EQ(foo.m_int32t, result.m_int32t);
+		EXPECT_EQ(foo.m_uint32t, result.m_uint32t);
+		EXPECT_EQ(foo.m_int64t, result.m_int64t);
+		EXPECT_EQ(foo.m_uint64t, result.m_uint64t);
+		EXPECT_EQ(foo.m_float, result.m_float);
+		EXPECT_EQ(foo.m_double, result.m_double);
+		EXPECT_EQ(foo.m_bool, result.m_bool);
+		EXPECT_TRUE(foo.m_enum == result.m_enum);
+		EXPECT_EQ(foo.m_string, result.m_string);
+		EXPECT_EQ(foo.m_vString, result.m_vString);
+		EXPECT_EQ(foo.m_vBool, result.m_vBool);
+		EXPECT_EQ(foo.m_vVector, result.m_vVector);
+		EXPECT_EQ(foo.m_map, result.m_map);
+		EXPECT_EQ(foo.m_unorderedMap, result.m_unorderedMap);
+		EXPECT_EQ(foo.m_basic.m_int32t, result.m_basic.m_int32t);
+		EXPECT_EQ(foo.m_basic.m_bool, result.m_basic.m_bool);
+		ASSERT_EQ(2U, result.m_vBasic.size());
+		EXPECT_EQ(127, result.m_vBasic[1].m_int32t);
+		EXPECT_TRUE(result.m_vBasic[1].m_bool);
+	}
+
+	TEST_F(CMessagePackTest, deserialize_skips_unknown_and_mismatched_members)
+	{
+		// {"unknown": [1, {"a": nil}], "int32t": "text", "bool": true}
+		const std::vector<std::uint8_t> buffer = { 0x83,
+			0xa7, 'u', 'n', 'k', 'n', 'o', 'w', 'n', 0x92, 0x01, 0x81, 0xa1, 'a', 0xc0,
+			0xa6, 'i', 'n', 't', '3', '2', 't', 0xa4, 't', 'e', 'x', 't',
+			0xa4, 'b', 'o', 'o', 'l', 0xc3 };
+
+		CMessagePackTestInternal::CBasic basic(5, false);
+		EXPECT_TRUE(DonerSerializer::CMessagePackDeserializer::Deserialize(basic, buffer));
+		EXPECT_EQ(5, basic.m_int32t);
+		EXPECT_TRUE(basic.m_bool);
+
+		// 5000000000 doesn't fit in an int32_t
+		const std::vector<std::uint8_t> bigInteger = { 0x81, 0xa6, 'i', 'n', 't', '3', '2', 't', 0xcf, 0, 0, 0, 0x01, 0x2a, 0x05, 0xf2, 0x00 };
+		EXPECT_TRUE(DonerSerializer::CMessagePackDeserializer::Deserialize(basic, bigInteger));
+		EXPECT_EQ(5, basic.m_int32t);
+
+		const std::vector<std::uint8_t> truncated(buffer.begin(), buffer.end() - 3);
+		EXPECT_FALSE(DonerSerializer::CMessagePackDeserializer::Deserialize(basic, truncated));
+	}
+
+	TEST_F(CMessagePackTest, deserialize_rejects_counts_bigger_than_the_input)
+	{
+		// {"v_string": array32 with 4294967295 elements}, and the same with a map32
+		const std::vector<std::uint8_t> hugeArray = { 0x81, 0xa8, 'v', '_', 's', 't', 'r', 'i', 'n', 'g', 0xdd, 0xff, 0xff, 0xff, 0xff };
+		const std::vector<std::uint8_t> hugeMap = { 0x81, 0xa3, 'm', 'a', 'p', 0xdf, 0xff, 0xff, 0xff, 0xff };
+		CMessagePackTestInternal::CFoo foo;
+		EXPECT_FALSE(DonerSerializer::CMessagePackDeserializer::Deserialize(foo, hugeArray));
+		EXPECT_TRUE(foo.m_vString.empty());
+		EXPECT_FALSE(DonerSerializer::CMessagePackDeserializer::Deserialize(foo, hugeMap));
+		EXPECT_TRUE(foo.m_map.empty());
+
+		// A map entry takes at least two bytes: {"map": {1: <missing>}}
+		const std::vector<std::uint8_t> shortMap = { 0x81, 0xa3, 'm', 'a', 'p', 0x81, 0x01 };
+		EXPECT_FALSE(DonerSerializer::CMessagePackDeserializer::Deserialize(foo, shortMap));
+
+		// Fixed size arrays are checked too: {"v_string": ["a", <missing>]}
+		const std::vector<std::uint8_t> shortArray = { 0x81, 0xa8, 'v', '_', 's', 't', 'r', 'i', 'n', 'g', 0x92, 0xa1, 'a' };
+		EXPECT_FALSE(DonerSerializer::CMessagePackDeserializer::Deserialize(foo, shortArray));
+	}
+}
\ No newline at end of file
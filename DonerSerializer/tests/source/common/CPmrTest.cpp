@@ -0,0 +1,241 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#include <donerserializer/DonerDeserialize.h>
+#include <donerserializer/DonerSerialize.h>
+#include <donerserializer/DonerStreamDeserialize.h>
+#include <donerserializer/DonerStreamSerialize.h>
+
+#include <gtest/gtest.h>
+
+#ifdef DONER_SERIALIZER_HAS_PMR
+
+#include <cstdint>
+#include <map>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace CPmrTestInternal
+{
+	class CItem : public DonerSerializer::ISerializable
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CItem)
+	public:
+		std::pmr::string m_name;
+		std::pmr::vector<std::int32_t> m_values;
+	};
+
+	class CArena
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CArena)
+	public:
+		CArena() = default;
+
+		explicit CArena(std::pmr::memory_resource* resource)
+			: m_title(resource)
+			, m_tags(resource)
+			, m_items(resource)
+			, m_attributes(resource)
+		{}
+
+		std::pmr::string m_title;
+		std::pmr::vector<std::pmr::string> m_tags;
+		std::pmr::vector<CItem> m_items;
+		std::pmr::map<std::pmr::string, std::pmr::string> m_attributes;
+	};
+
+	// Strings are longer than the small string buffer, so they allocate
+	const char* const ARENA_JSON_DATA = "{\"attributes\":[[\"a long enough attribute key\",\"a long enough attribute value\"]],"
+		"\"items\":[{\"values\":[1,2,3],\"name\":\"a long enough item name\"},{\"values\":[4],\"name\":\"another long item name\"}],"
+		"\"tags\":[\"a long enough first tag\",\"a long enough second tag\"],"
+		"\"title\":\"a long enough arena title\"}";
+
+	void ExpectContent(const CArena& arena)
+	{
+		EXPECT_EQ("a long enough arena title", arena.m_title);
+		ASSERT_EQ(2U, arena.m_tags.size());
+		EXPECT_EQ("a long enough second tag", arena.m_tags[1]);
+		ASSERT_EQ(2U, arena.m_items.size());
+		EXPECT_EQ("another long item name", arena.m_items[1].m_name);
+		ASSERT_EQ(3U, arena.m_items[0].m_values.size());
+		EXPECT_EQ(3, arena.m_items[0].m_values[2]);
+		ASSERT_EQ(1U, arena.m_attributes.size());
+		EXPECT_EQ("a long enough attribute value", arena.m_attributes.begin()->second);
+	}
+
+	void ExpectResource(const CArena& arena, std::pmr::memory_resource* resource)
+	{
+		EXPECT_EQ(resource, arena.m_title.get_allocator().resource());
+		EXPECT_EQ(resource, arena.m_tags.get_allocator().resource());
+		for (const std::pmr::string& tag : arena.m_tags)
+		{
+			EXPECT_EQ(resource, tag.get_allocator().resource());
+		}
+		EXPECT_EQ(resource, arena.m_items.get_allocator().resource());
+		for (const CItem& item : arena.m_items)
+		{
+			EXPECT_EQ(resource, item.m_name.get_allocator().resource());
+			EXPECT_EQ(resource, item.m_values.get_allocator().resource());
+		}
+		EXPECT_EQ(resource, arena.m_attributes.get_allocator().resource());
+		for (const auto& attribute : arena.m_attributes)
+		{
+			EXPECT_EQ(resource, attribute.first.get_allocator().resource());
+			EXPECT_EQ(resource, attribute.second.get_allocator().resource());
+		}
+	}
+
+	// Any allocation outside the arena throws while alive
+	class CNullDefaultResource
+	{
+	public:
+		CNullDefaultResource()
+			: m_previous(std::pmr::set_default_resource(std::pmr::null_memory_resource()))
+		{}
+
+		~CNullDefaultResource()
+		{
+			std::pmr::set_default_resource(m_previous);
+		}
+
+	private:
+		std::pmr::memory_resource* m_previous;
+	};
+}
+
+DONER_DEFINE_REFLECTION_DATA(CPmrTestInternal::CItem,
+							   DONER_ADD_NAMED_VAR_INFO(m_name, "name"),
+							   DONER_ADD_NAMED_VAR_INFO(m_values, "values")
+)
+
+DONER_DEFINE_REFLECTION_DATA(CPmrTestInternal::CArena,
+							   DONER_ADD_NAMED_VAR_INFO(m_title, "title"),
+							   DONER_ADD_NAMED_VAR_INFO(m_tags, "tags"),
+							   DONER_ADD_NAMED_VAR_INFO(m_items, "items"),
+							   DONER_ADD_NAMED_VAR_INFO(m_attributes, "attributes")
+)
+
+namespace DonerSerializer
+{
+	class CPmrTest : public ::testing::Test
+	{
+	public:
+		CPmrTest() = default;
+		~CPmrTest() = default;
+	};
+
+	TEST_F(CPmrTest, pmr_members_roundtrip)
+	{
+		CPmrTestInternal::CArena arena;
+		DonerSerializer::CJsonDeserializer::Deserialize(arena, CPmrTestInternal::ARENA_JSON_DATA);
+		CPmrTestInternal::ExpectContent(arena);
+
+		DonerSerializer::CJsonSerializer serializer;
+		serializer.Serialize(arena);
+		EXPECT_EQ(CPmrTestInternal::ARENA_JSON_DATA, serializer.GetJsonString());
+		EXPECT_EQ(CPmrTestInternal::ARENA_JSON_DATA, DonerSerializer::CJsonStreamSerializer::GetJsonString(arena));
+
+		CPmrTestInternal::CArena streamArena;
+		EXPECT_TRUE(DonerSerializer::CJsonStreamDeserializer::Deserialize(streamArena, CPmrTestInternal::ARENA_JSON_DATA));
+		CPmrTestInternal::ExpectContent(streamArena);
+	}
+
+	TEST_F(CPmrTest, elements_use_the_container_allocator)
+	{
+		// Reflected classes don't take an allocator, so only the members holding plain elements are read
+		const char* const json = "{\"attributes\":[[\"a long enough attribute key\",\"a long enough attribute value\"]],"
+			"\"tags\":[\"a long enough first tag\",\"a long enough second tag\"]}";
+
+		std::pmr::monotonic_buffer_resource resource;
+		CPmrTestInternal::CArena arena(&resource);
+		CPmrTestInternal::CArena streamArena(&resource);
+		{
+			CPmrTestInternal::CNullDefaultResource nullDefaultResource;
+			DonerSerializer::CJsonDeserializer::Deserialize(arena, json);
+			EXPECT_TRUE(DonerSerializer::CJsonStreamDeserializer::Deserialize(streamArena, json));
+			DonerSerializer::CJsonDeserializer::Deserialize(arena, json);
+		}
+		ASSERT_EQ(4U, arena.m_tags.size());
+		EXPECT_EQ("a long enough second tag", arena.m_tags[3]);
+		ASSERT_EQ(1U, arena.m_attributes.size());
+		EXPECT_EQ("a long enough attribute value", arena.m_attributes.begin()->second);
+		CPmrTestInternal::ExpectResource(arena, &resource);
+		ASSERT_EQ(2U, streamArena.m_tags.size());
+		CPmrTestInternal::ExpectResource(streamArena, &resource);
+	}
+
+	TEST_F(CPmrTest, scope_moves_the_whole_tree_to_its_resource)
+	{
+		std::pmr::monotonic_buffer_resource resource;
+		CPmrTestInternal::CArena arena;
+		CPmrTestInternal::CArena streamArena;
+		arena.m_tags.push_back("a tag added before deserializing");
+		{
+			CPmrTestInternal::CNullDefaultResource nullDefaultResource;
+			DonerSerializer::CPmrDeserializationScope scope(&resource);
+			DonerSerializer::CJsonDeserializer::Deserialize(arena, CPmrTestInternal::ARENA_JSON_DATA);
+			EXPECT_TRUE(DonerSerializer::CJsonStreamDeserializer::Deserialize(streamArena, CPmrTestInternal::ARENA_JSON_DATA));
+		}
+		EXPECT_EQ(nullptr, DonerSerializer::CPmrDeserializationScope::GetResource());
+
+		// Containers keep their elements when moved
+		ASSERT_EQ(3U, arena.m_tags.size());
+		EXPECT_EQ("a tag added before deserializing", arena.m_tags[0]);
+		arena.m_tags.erase(arena.m_tags.begin());
+		CPmrTestInternal::ExpectContent(arena);
+		CPmrTestInternal::ExpectResource(arena, &resource);
+		CPmrTestInternal::ExpectContent(streamArena);
+		CPmrTestInternal::ExpectResource(streamArena, &resource);
+	}
+
+	TEST_F(CPmrTest, scope_disables_parallel_deserialization)
+	{
+		std::pmr::monotonic_buffer_resource resource;
+		std::string json = "{\"tags\":[";
+		for (std::size_t index = 0; index < 64; ++index)
+		{
+			json += index == 0 ? "\"" : ",\"";
+			json += "a long enough tag number " + std::to_string(index) + "\"";
+		}
+		json += "]}";
+
+		CPmrTestInternal::CArena arena;
+		{
+			DonerSerializer::CParallelDeserializationScope parallelScope(4, 8);
+			DonerSerializer::CPmrDeserializationScope scope(&resource);
+			DonerSerializer::CJsonDeserializer::Deserialize(arena, json.c_str());
+		}
+		ASSERT_EQ(64U, arena.m_tags.size());
+		EXPECT_EQ("a long enough tag number 63", arena.m_tags[63]);
+		EXPECT_EQ(&resource, arena.m_tags.get_allocator().resource());
+		EXPECT_EQ(&resource, arena.m_tags[63].get_allocator().resource());
+	}
+}
+
+#endif
\ No newline at end of file
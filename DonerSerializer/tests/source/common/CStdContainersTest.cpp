@@ -41,6 +41,7 @@ namespace CStdContainersTestInternal
 {
 	const char* const FOO_JSON_DATA = "{\"v_map\":[[0,false],[1,true],[2,false]],\"v_vector\":[[0,1,2],[3,4,5],[6,7,8]],\"v_bool\":[true,false,true],\"v_string\":[\"zero\",\"one\",\"two\"],\"v_double\":[0.0,1.0,2.0],\"v_float\":[0.0,1.0,2.0],\"v_uint64t\":[0,1,2],\"v_int64t\":[0,1,2],\"v_uint32t\":[0,1,2],\"v_int32t\":[0,1,2]}";
 	const char* const FOO_JSON_DATA_INHERIT = "{\"v_int32t_2\":[3,4,5],\"v_int32t\":[0,1,2]}";
+	const char* const UNORDERED_JSON_DATA = "{\"u_map\":[[1,[\"one\"]],[2,[\"two\",\"dos\"]],[1,[\"uno\"]]]}";
 
 	class CFoo : public DonerSerializer::ISerializable
 	{
@@ -66,6 +67,13 @@ namespace CStdContainersTestInternal
 	public:
 		std::vector<std::int32_t> m_vInt32t_2;
 	};
+
+	class CUnordered : public DonerSerializer::ISerializable
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CUnordered)
+	public:
+		std::unordered_map<std::int32_t, std::vector<std::string>> m_map;
+	};
 }
 
 DONER_DEFINE_REFLECTION_DATA(CStdContainersTestInternal::CBar,
@@ -86,6 +94,10 @@ DONER_DEFINE_REFLECTION_DATA(CStdContainersTestInternal::CFoo,
 							   DONER_ADD_NAMED_VAR_INFO(m_map, "v_map")
 )
 
+DONER_DEFINE_REFLECTION_DATA(CStdContainersTestInternal::CUnordered,
+							   DONER_ADD_NAMED_VAR_INFO(m_map, "u_map")
+)
+
 namespace DonerSerializer
 {
 	class CStdContainersTest : public ::testing::Test
@@ -182,6 +194,23 @@ namespace DonerSerializer
 		EXPECT_EQ(5, bar.m_vInt32t_2[2]);
 	}
 
+	TEST_F(CStdContainersTest, deserialize_unordered_map_overwrites_repeated_keys)
+	{
+		CStdContainersTestInternal::CUnordered unordered;
+		unordered.m_map[1].push_back("stale");
+
+		DonerSerializer::CJsonDeserializer::Deserialize(unordered, CStdContainersTestInternal::UNORDERED_JSON_DATA);
+
+		EXPECT_EQ(2U, unordered.m_map.size());
+
+		ASSERT_EQ(1U, unordered.m_map[1].size());
+		ASSERT_STREQ("uno", unordered.m_map[1][0].c_str());
+
+		ASSERT_EQ(2U, unordered.m_map[2].size());
+		ASSERT_STREQ("two", unordered.m_map[2][0].c_str());
+		ASSERT_STREQ("dos", unordered.m_map[2][1].c_str());
+	}
+
 	TEST_F(CStdContainersTest, serialize_vector_from_main_class)
 	{
 		CStdContainersTestInternal::CFoo foo;
@@ -0,0 +1,339 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#include <donerserializer/DonerDeserialize.h>
+#include <donerserializer/DonerFileDeserialize.h>
+#include <donerserializer/DonerStreamDeserialize.h>
+
+#include <rapidjson/document.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <list>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace CStreamDeserializerTestInternal
+{
+	const char* const FOO_JSON_DATA = "{\"enum\":1,\"bool\":true,\"double\":6.0,\"float\":5.0,\"uint64t\":4,\"int64t\":-3,\"uint32t\":2,\"int32t\":-1,\"string\":\"foo\",\"v_string\":[\"a\",\"b\"],\"v_bool\":[true,false,true],\"v_vector\":[[0,1],[2]],\"l_int32t\":[7,8],\"v_map\":[[0,\"zero\"],[1,\"one\"]],\"u_map\":[[\"two\",2]],\"vector2\":[1.5,2.5]}";
+	const char* const BAR_JSON_DATA = "{\"foos\":[{\"basic\":{\"bool\":false,\"int32t\":1}},{\"basic\":{\"bool\":true,\"int32t\":2}}],\"foo\":{\"basic\":{\"bool\":true,\"int32t\":3}},\"map\":[[5,{\"basic\":{\"bool\":true,\"int32t\":4}}]]}";
+	const char* const BAR_JSON_DATA_UNKNOWN_KEYS = "{\"unknown\":{\"a\":[1,{\"b\":2}],\"foo\":{\"basic\":{\"int32t\":9}}},\"foo\":{\"other\":[[]],\"basic\":{\"bool\":true,\"int32t\":3,\"extra\":{}}},\"int32t\":7}";
+
+	struct SVector2
+	{
+		float x = 0.f;
+		float y = 0.f;
+	};
+
+	class CFoo
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CFoo)
+	public:
+		enum class EEnumTest { Test1, Test2 };
+
+		CFoo()
+			: m_int32t(0)
+			, m_uint32t(0)
+			, m_int64t(0)
+			, m_uint64t(0)
+			, m_float(0.f)
+			, m_double(0.0)
+			, m_bool(false)
+			, m_enum(EEnumTest::Test1)
+		{}
+
+		std::int32_t m_int32t;
+		std::uint32_t m_uint32t;
+		std::int64_t m_int64t;
+		std::uint64_t m_uint64t;
+		float m_float;
+		double m_double;
+		bool m_bool;
+		EEnumTest m_enum;
+		std::string m_string;
+		std::vector<std::string> m_vString;
+		std::vector<bool> m_vBool;
+		std::vector<std::vector<std::int32_t>> m_vVector;
+		std::list<std::int32_t> m_lInt32t;
+		std::map<std::int32_t, std::string> m_map;
+		std::unordered_map<std::string, std::int32_t> m_unorderedMap;
+		SVector2 m_vector2;
+	};
+
+	class CBasic : public DonerSerializer::ISerializable
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CBasic)
+	public:
+		CBasic()
+			: m_int32t(0)
+			, m_bool(false)
+		{}
+
+		std::int32_t m_int32t;
+		bool m_bool;
+	};
+
+	class CNested : public DonerSerializer::ISerializable
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CNested)
+	public:
+		CBasic m_basic;
+	};
+
+	class CBar
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CBar)
+	public:
+		CNested m_foo;
+		std::vector<CNested> m_foos;
+		std::map<std::int32_t, CNested> m_map;
+	};
+}
+
+namespace DonerSerializer
+{
+	template <>
+	class CDeserializationResolver::CDeserializationResolverType<CStreamDeserializerTestInternal::SVector2>
+	{
+	public:
+		static void Apply(CStreamDeserializerTestInternal::SVector2& value, const rapidjson::Value& att)
+		{
+			if (att.IsArray() && att.Size() == 2)
+			{
+				value.x = att[0].GetFloat();
+				value.y = att[1].GetFloat();
+			}
+		}
+	};
+}
+
+DONER_DEFINE_REFLECTION_DATA(CStreamDeserializerTestInternal::CFoo,
+							   DONER_ADD_NAMED_VAR_INFO(m_int32t, "int32t"),
+							   DONER_ADD_NAMED_VAR_INFO(m_uint32t, "uint32t"),
+							   DONER_ADD_NAMED_VAR_INFO(m_int64t, "int64t"),
+							   DONER_ADD_NAMED_VAR_INFO(m_uint64t, "uint64t"),
+							   DONER_ADD_NAMED_VAR_INFO(m_float, "float"),
+							   DONER_ADD_NAMED_VAR_INFO(m_double, "double"),
+							   DONER_ADD_NAMED_VAR_INFO(m_bool, "bool"),
+							   DONER_ADD_NAMED_VAR_INFO(m_enum, "enum"),
+							   DONER_ADD_NAMED_VAR_INFO(m_string, "string"),
+							   DONER_ADD_NAMED_VAR_INFO(m_vString, "v_string"),
+							   DONER_ADD_NAMED_VAR_INFO(m_vBool, "v_bool"),
+							   DONER_ADD_NAMED_VAR_INFO(m_vVector, "v_vector"),
+							   DONER_ADD_NAMED_VAR_INFO(m_lInt32t, "l_int32t"),
+							   DONER_ADD_NAMED_VAR_INFO(m_map, "v_map"),
+							   DONER_ADD_NAMED_VAR_INFO(m_unorderedMap, "u_map"),
+							   DONER_ADD_NAMED_VAR_INFO(m_vector2, "vector2")
+)
+
+DONER_DEFINE_REFLECTION_DATA(CStreamDeserializerTestInternal::CBasic,
+							   DONER_ADD_NAMED_VAR_INFO(m_int32t, "int32t"),
+							   DONER_ADD_NAMED_VAR_INFO(m_bool, "bool")
+)
+
+DONER_DEFINE_REFLECTION_DATA(CStreamDeserializerTestInternal::CNested,
+							   DONER_ADD_NAMED_VAR_INFO(m_basic, "basic")
+)
+
+DONER_DEFINE_REFLECTION_DATA(CStreamDeserializerTestInternal::CBar,
+							   DONER_ADD_NAMED_VAR_INFO(m_foo, "foo"),
+							   DONER_ADD_NAMED_VAR_INFO(m_foos, "foos"),
+							   DONER_ADD_NAMED_VAR_INFO(m_map, "map")
+)
+
+namespace DonerSerializer
+{
+	class CStreamDeserializerTest : public ::testing::Test
+	{
+	public:
+		CStreamDeserializerTest() = default;
+		~CStreamDeserializerTest() = default;
+	};
+
+	TEST_F(CStreamDeserializerTest, deserialize_basic_types_and_containers)
+	{
+		CStreamDeserializerTestInternal::CFoo foo;
+
+		EXPECT_TRUE(DonerSerializer::CJsonStreamDeserializer::Deserialize(foo, CStreamDeserializerTestInternal::FOO_JSON_DATA));
+
+		EXPECT_EQ(-1, foo.m_int32t);
+		EXPECT_EQ(2U, foo.m_uint32t);
+		EXPECT_EQ(-3L, foo.m_int64t);
+		EXPECT_EQ(4UL, foo.m_uint64t);
+		EXPECT_EQ(5.f, foo.m_float);
+		EXPECT_EQ(6.0, foo.m_double);
+		EXPECT_TRUE(foo.m_bool);
+		EXPECT_TRUE(foo.m_enum == CStreamDeserializerTestInternal::CFoo::EEnumTest::Test2);
+		ASSERT_STREQ("foo", foo.m_string.c_str());
+
+		ASSERT_EQ(2U, foo.m_vString.size());
+		ASSERT_STREQ("a", foo.m_vString[0].c_str());
+		ASSERT_STREQ("b", foo.m_vString[1].c_str());
+
+		ASSERT_EQ(3U, foo.m_vBool.size());
+		EXPECT_TRUE(foo.m_vBool[0]);
+		EXPECT_FALSE(foo.m_vBool[1]);
+		EXPECT_TRUE(foo.m_vBool[2]);
+
+		ASSERT_EQ(2U, foo.m_vVector.size());
+		ASSERT_EQ(2U, foo.m_vVector[0].size());
+		EXPECT_EQ(0, foo.m_vVector[0][0]);
+		EXPECT_EQ(1, foo.m_vVector[0][1]);
+		ASSERT_EQ(1U, foo.m_vVector[1].size());
+		EXPECT_EQ(2, foo.m_vVector[1][0]);
+
+		ASSERT_EQ(2U, foo.m_lInt32t.size());
+		EXPECT_EQ(7, foo.m_lInt32t.front());
+		EXPECT_EQ(8, foo.m_lInt32t.back());
+
+		ASSERT_EQ(2U, foo.m_map.size());
+		ASSERT_STREQ("zero", foo.m_map[0].c_str());
+		ASSERT_STREQ("one", foo.m_map[1].c_str());
+
+		ASSERT_EQ(1U, foo.m_unorderedMap.size());
+		EXPECT_EQ(2, foo.m_unorderedMap["two"]);
+
+		EXPECT_EQ(1.5f, foo.m_vector2.x);
+		EXPECT_EQ(2.5f, foo.m_vector2.y);
+	}
+
+	TEST_F(CStreamDeserializerTest, deserialize_complex_types)
+	{
+		CStreamDeserializerTestInternal::CBar bar;
+
+		EXPECT_TRUE(DonerSerializer::CJsonStreamDeserializer::Deserialize(bar, CStreamDeserializerTestInternal::BAR_JSON_DATA));
+
+		EXPECT_EQ(3, bar.m_foo.m_basic.m_int32t);
+		EXPECT_TRUE(bar.m_foo.m_basic.m_bool);
+
+		ASSERT_EQ(2U, bar.m_foos.size());
+		EXPECT_EQ(1, bar.m_foos[0].m_basic.m_int32t);
+		EXPECT_FALSE(bar.m_foos[0].m_basic.m_bool);
+		EXPECT_EQ(2, bar.m_foos[1].m_basic.m_int32t);
+		EXPECT_TRUE(bar.m_foos[1].m_basic.m_bool);
+
+		ASSERT_EQ(1U, bar.m_map.size());
+		EXPECT_EQ(4, bar.m_map[5].m_basic.m_int32t);
+		EXPECT_TRUE(bar.m_map[5].m_basic.m_bool);
+	}
+
+	TEST_F(CStreamDeserializerTest, unknown_keys_are_skipped)
+	{
+		CStreamDeserializerTestInternal::CBar bar;
+
+		EXPECT_TRUE(DonerSerializer::CJsonStreamDeserializer::Deserialize(bar, CStreamDeserializerTestInternal::BAR_JSON_DATA_UNKNOWN_KEYS));
+
+		EXPECT_EQ(3, bar.m_foo.m_basic.m_int32t);
+		EXPECT_TRUE(bar.m_foo.m_basic.m_bool);
+		EXPECT_EQ(0U, bar.m_foos.size());
+	}
+
+	TEST_F(CStreamDeserializerTest, result_matches_document_deserializer)
+	{
+		CStreamDeserializerTestInternal::CFoo streamFoo;
+		CStreamDeserializerTestInternal::CFoo documentFoo;
+
+		DonerSerializer::CJsonStreamDeserializer::Deserialize(streamFoo, CStreamDeserializerTestInternal::FOO_JSON_DATA);
+		DonerSerializer::CJsonDeserializer::Deserialize(documentFoo, CStreamDeserializerTestInternal::FOO_JSON_DATA);
+
+		EXPECT_EQ(documentFoo.m_int64t, streamFoo.m_int64t);
+		EXPECT_EQ(documentFoo.m_float, streamFoo.m_float);
+		EXPECT_EQ(documentFoo.m_string, streamFoo.m_string);
+		EXPECT_EQ(documentFoo.m_vString, streamFoo.m_vString);
+		EXPECT_EQ(documentFoo.m_vBool, streamFoo.m_vBool);
+		EXPECT_EQ(documentFoo.m_vVector, streamFoo.m_vVector);
+		EXPECT_EQ(documentFoo.m_lInt32t, streamFoo.m_lInt32t);
+		EXPECT_EQ(documentFoo.m_map, streamFoo.m_map);
+		EXPECT_EQ(documentFoo.m_unorderedMap, streamFoo.m_unorderedMap);
+		EXPECT_EQ(documentFoo.m_vector2.x, streamFoo.m_vector2.x);
+		EXPECT_EQ(documentFoo.m_vector2.y, streamFoo.m_vector2.y);
+	}
+
+	TEST_F(CStreamDeserializerTest, invalid_json_returns_false)
+	{
+		CStreamDeserializerTestInternal::CBar bar;
+
+		EXPECT_FALSE(DonerSerializer::CJsonStreamDeserializer::Deserialize(bar, "{\"foo\":{\"basic\":{\"int32t\":3,}"));
+		EXPECT_EQ(3, bar.m_foo.m_basic.m_int32t);
+	}
+
+	TEST_F(CStreamDeserializerTest, deserialize_insitu)
+	{
+		CStreamDeserializerTestInternal::CFoo foo;
+		std::string json(CStreamDeserializerTestInternal::FOO_JSON_DATA);
+		json.replace(json.find("\"foo\""), 5, "\"f\\\"o\"");
+
+		EXPECT_TRUE(DonerSerializer::CJsonStreamDeserializer::DeserializeInsitu(foo, &json[0]));
+
+		EXPECT_EQ(-3L, foo.m_int64t);
+		EXPECT_EQ(std::string("f\"o"), foo.m_string);
+		ASSERT_EQ(2U, foo.m_vString.size());
+		EXPECT_EQ(std::string("b"), foo.m_vString[1]);
+		ASSERT_EQ(1U, foo.m_unorderedMap.size());
+		EXPECT_EQ(2, foo.m_unorderedMap["two"]);
+	}
+
+	TEST_F(CStreamDeserializerTest, deserialize_from_sized_buffer_and_file)
+	{
+		const std::size_t length = std::strlen(CStreamDeserializerTestInternal::BAR_JSON_DATA);
+		const std::string data = std::string(CStreamDeserializerTestInternal::BAR_JSON_DATA) + "trailing garbage";
+
+		CStreamDeserializerTestInternal::CBar streamBar;
+		EXPECT_TRUE(DonerSerializer::CJsonStreamDeserializer::Deserialize(streamBar, data.data(), length));
+		EXPECT_EQ(3, streamBar.m_foo.m_basic.m_int32t);
+		EXPECT_FALSE(DonerSerializer::CJsonStreamDeserializer::Deserialize(streamBar, data.data(), data.size()));
+
+		CStreamDeserializerTestInternal::CBar documentBar;
+		EXPECT_TRUE(DonerSerializer::CJsonDeserializer::Deserialize(documentBar, data.data(), length));
+		EXPECT_EQ(3, documentBar.m_foo.m_basic.m_int32t);
+
+		const char* const path = "CStreamDeserializerTest.json";
+		std::FILE* file = std::fopen(path, "wb");
+		ASSERT_TRUE(file != nullptr);
+		std::fwrite(data.data(), 1, length, file);
+		std::fclose(file);
+
+		CStreamDeserializerTestInternal::CBar streamFileBar;
+		EXPECT_TRUE(DonerSerializer::CJsonFileDeserializer::DeserializeStream(streamFileBar, path));
+		CStreamDeserializerTestInternal::CBar documentFileBar;
+		EXPECT_TRUE(DonerSerializer::CJsonFileDeserializer::Deserialize(documentFileBar, path));
+		std::remove(path);
+
+		ASSERT_EQ(2U, streamFileBar.m_foos.size());
+		EXPECT_EQ(2, streamFileBar.m_foos[1].m_basic.m_int32t);
+		ASSERT_EQ(2U, documentFileBar.m_foos.size());
+		EXPECT_EQ(2, documentFileBar.m_foos[1].m_basic.m_int32t);
+
+		EXPECT_FALSE(DonerSerializer::CJsonFileDeserializer::DeserializeStream(streamFileBar, path));
+		EXPECT_FALSE(DonerSerializer::CJsonFileDeserializer::Deserialize(documentFileBar, path));
+	}
+}
\ No newline at end of file
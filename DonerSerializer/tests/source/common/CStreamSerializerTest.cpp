@@ -0,0 +1,387 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerSerializer
+// Copyright(c) 2018 Donerkebap13
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+
+#include <donerserializer/DonerSerialize.h>
+#include <donerserializer/DonerStreamSerialize.h>
+
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace CStreamSerializerTestInternal
+{
+	const char* const FOO_JSON_DATA = "{\"v_map\":[[0,\"zero\"],[1,\"one\"]],\"v_vector\":[[0,1],[2]],\"v_string\":[\"a\",\"b\"],\"string\":\"foo\",\"enum\":1,\"bool\":true,\"double\":6.0,\"float\":5.0,\"uint64t\":4,\"int64t\":-3,\"uint32t\":2,\"int32t\":-1}";
+	const char* const BAR_JSON_DATA = "{\"foos\":[{\"basic\":{\"bool\":false,\"int32t\":1}},{\"basic\":{\"bool\":true,\"int32t\":2}}],\"foo\":{\"basic\":{\"bool\":true,\"int32t\":3}}}";
+
+	class CFoo
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CFoo)
+	public:
+		enum class EEnumTest { Test1, Test2 };
+
+		CFoo()
+			: m_int32t(0)
+			, m_uint32t(0)
+			, m_int64t(0)
+			, m_uint64t(0)
+			, m_float(0.f)
+			, m_double(0.0)
+			, m_bool(false)
+			, m_enum(EEnumTest::Test1)
+		{}
+
+		std::int32_t m_int32t;
+		std::uint32_t m_uint32t;
+		std::int64_t m_int64t;
+		std::uint64_t m_uint64t;
+		float m_float;
+		double m_double;
+		bool m_bool;
+		EEnumTest m_enum;
+		std::string m_string;
+		std::vector<std::string> m_vString;
+		std::vector<std::vector<std::int32_t>> m_vVector;
+		std::map<std::int32_t, std::string> m_map;
+	};
+
+	class CBasic : public DonerSerializer::ISerializable
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CBasic)
+	public:
+		CBasic()
+			: m_int32t(0)
+			, m_bool(false)
+		{}
+
+		CBasic(std::int32_t int32t, bool _bool)
+			: m_int32t(int32t)
+			, m_bool(_bool)
+		{}
+
+		std::int32_t m_int32t;
+		bool m_bool;
+	};
+
+	class CNested : public DonerSerializer::ISerializable
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CNested)
+	public:
+		CBasic m_basic;
+	};
+
+	class CBar
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CBar)
+	public:
+		CNested m_foo;
+		std::vector<CNested> m_foos;
+	};
+
+	CFoo CreateFoo()
+	{
+		CFoo foo;
+		foo.m_int32t = -1;
+		foo.m_uint32t = 2;
+		foo.m_int64t = -3;
+		foo.m_uint64t = 4;
+		foo.m_float = 5.f;
+		foo.m_double = 6.0;
+		foo.m_bool = true;
+		foo.m_enum = CFoo::EEnumTest::Test2;
+		foo.m_string = "foo";
+		foo.m_vString = { "a", "b" };
+		foo.m_vVector = { { 0, 1 }, { 2 } };
+		foo.m_map[0] = "zero";
+		foo.m_map[1] = "one";
+		return foo;
+	}
+
+	struct SDelay
+	{
+		std::int32_t m_milliseconds;
+	};
+
+	class CSlowItem
+	{
+		DONER_DECLARE_OBJECT_AS_REFLECTABLE(CSlowItem)
+	public:
+		CSlowItem()
+			: m_delay{ 0 }
+		{}
+
+		static std::atomic<std::size_t>& GetSerialized()
+		{
+			static std::atomic<std::size_t> serialized(0);
+			return serialized;
+		}
+
+		SDelay m_delay;
+	};
+
+	CBar CreateBar()
+	{
+		CBar bar;
+		bar.m_foo.m_basic = CBasic(3, true);
+		bar.m_foos.resize(2);
+		bar.m_foos[0].m_basic = CBasic(1, false);
+		bar.m_foos[1].m_basic = CBasic(2, true);
+		return bar;
+	}
+}
+
+DONER_DEFINE_REFLECTION_DATA(CStreamSerializerTestInternal::CFoo,
+							   DONER_ADD_NAMED_VAR_INFO(m_int32t, "int32t"),
+							   DONER_ADD_NAMED_VAR_INFO(m_uint32t, "uint32t"),
+							   DONER_ADD_NAMED_VAR_INFO(m_int64t, "int64t"),
+							   DONER_ADD_NAMED_VAR_INFO(m_uint64t, "uint64t"),
+							   DONER_ADD_NAMED_VAR_INFO(m_float, "float"),
+							   DONER_ADD_NAMED_VAR_INFO(m_double, "double"),
+							   DONER_ADD_NAMED_VAR_INFO(m_bool, "bool"),
+							   DONER_ADD_NAMED_VAR_INFO(m_enum, "enum"),
+							   DONER_ADD_NAMED_VAR_INFO(m_string, "string"),
+							   DONER_ADD_NAMED_VAR_INFO(m_vString, "v_string"),
+							   DONER_ADD_NAMED_VAR_INFO(m_vVector, "v_vector"),
+							   DONER_ADD_NAMED_VAR_INFO(m_map, "v_map")
+)
+
+DONER_DEFINE_REFLECTION_DATA(CStreamSerializerTestInternal::CBasic,
+							   DONER_ADD_NAMED_VAR_INFO(m_int32t, "int32t"),
+							   DONER_ADD_NAMED_VAR_INFO(m_bool, "bool")
+)
+
+DONER_DEFINE_REFLECTION_DATA(CStreamSerializerTestInternal::CNested,
+							   DONER_ADD_NAMED_VAR_INFO(m_basic, "basic")
+)
+
+DONER_DEFINE_REFLECTION_DATA(CStreamSerializerTestInternal::CBar,
+							   DONER_ADD_NAMED_VAR_INFO(m_foo, "foo"),
+							   DONER_ADD_NAMED_VAR_INFO(m_foos, "foos")
+)
+
+DONER_DEFINE_REFLECTION_DATA(CStreamSerializerTestInternal::CSlowItem,
+							   DONER_ADD_NAMED_VAR_INFO(m_delay, "delay")
+)
+
+namespace DonerSerializer
+{
+	template <>
+	class CStreamSerializationResolver::CStreamSerializationResolverType<CStreamSerializerTestInternal::SDelay>
+	{
+	public:
+		template <class Handler>
+		static void SerializeToHandler(const CStreamSerializerTestInternal::SDelay& value, Handler& handler)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(value.m_milliseconds));
+			++CStreamSerializerTestInternal::CSlowItem::GetSerialized();
+			handler.Int(value.m_milliseconds);
+		}
+	};
+
+	class CStreamSerializerTest : public ::testing::Test
+	{
+	public:
+		CStreamSerializerTest() = default;
+		~CStreamSerializerTest() = default;
+	};
+
+	TEST_F(CStreamSerializerTest, serialize_basic_types_and_containers)
+	{
+		CStreamSerializerTestInternal::CFoo foo = CStreamSerializerTestInternal::CreateFoo();
+
+		std::string result = DonerSerializer::CJsonStreamSerializer::GetJsonString(foo);
+
+		ASSERT_STREQ(CStreamSerializerTestInternal::FOO_JSON_DATA, result.c_str());
+	}
+
+	TEST_F(CStreamSerializerTest, serialize_complex_types)
+	{
+		CStreamSerializerTestInternal::CBar bar = CStreamSerializerTestInternal::CreateBar();
+
+		std::string result = DonerSerializer::CJsonStreamSerializer::GetJsonString(bar);
+
+		ASSERT_STREQ(CStreamSerializerTestInternal::BAR_JSON_DATA, result.c_str());
+	}
+
+	TEST_F(CStreamSerializerTest, output_matches_document_serializer)
+	{
+		CStreamSerializerTestInternal::CFoo foo = CStreamSerializerTestInternal::CreateFoo();
+		CStreamSerializerTestInternal::CBar bar = CStreamSerializerTestInternal::CreateBar();
+
+		DonerSerializer::CJsonSerializer fooSerializer;
+		fooSerializer.Serialize(foo);
+		DonerSerializer::CJsonSerializer barSerializer;
+		barSerializer.Serialize(bar);
+
+		EXPECT_EQ(fooSerializer.GetJsonString(), DonerSerializer::CJsonStreamSerializer::GetJsonString(foo));
+		EXPECT_EQ(barSerializer.GetJsonString(), DonerSerializer::CJsonStreamSerializer::GetJsonString(bar));
+	}
+
+	TEST_F(CStreamSerializerTest, serialize_to_document_handler)
+	{
+		CStreamSerializerTestInternal::CBar bar = CStreamSerializerTestInternal::CreateBar();
+
+		auto generator = [&bar](rapidjson::Document& handler)
+		{
+			DonerSerializer::CJsonStreamSerializer::Serialize(bar, handler);
+			return true;
+		};
+
+		rapidjson::Document document;
+		document.Populate(generator);
+
+		ASSERT_TRUE(document.IsObject());
+		EXPECT_EQ(2U, document.MemberCount());
+		EXPECT_EQ(2U, document["foos"].Size());
+		EXPECT_EQ(3, document["foo"]["basic"]["int32t"].GetInt());
+
+		rapidjson::StringBuffer strbuf;
+		rapidjson::Writer<rapidjson::StringBuffer> writer(strbuf);
+		document.Accept(writer);
+
+		ASSERT_STREQ(CStreamSerializerTestInternal::BAR_JSON_DATA, strbuf.GetString());
+	}
+
+
+	TEST_F(CStreamSerializerTest, serialize_to_ostream_and_files)
+	{
+		CStreamSerializerTestInternal::CBar bar = CStreamSerializerTestInternal::CreateBar();
+
+		// A buffer smaller than the output forces several flushes
+		std::ostringstream stream;
+		EXPECT_TRUE(DonerSerializer::CJsonStreamSerializer::SerializeToStream(bar, stream, 7));
+		ASSERT_STREQ(CStreamSerializerTestInternal::BAR_JSON_DATA, stream.str().c_str());
+
+		const char* const path = "CStreamSerializerTest.json";
+		ASSERT_TRUE(DonerSerializer::CJsonStreamSerializer::SerializeToFile(bar, path, 16));
+
+		std::FILE* file = std::fopen(path, "rb");
+		ASSERT_TRUE(file != nullptr);
+		char buffer[512] = {};
+		const std::size_t read = std::fread(buffer, 1, sizeof(buffer) - 1, file);
+		std::fclose(file);
+		std::remove(path);
+
+		EXPECT_EQ(std::strlen(CStreamSerializerTestInternal::BAR_JSON_DATA), read);
+		ASSERT_STREQ(CStreamSerializerTestInternal::BAR_JSON_DATA, buffer);
+
+		EXPECT_FALSE(DonerSerializer::CJsonStreamSerializer::SerializeToFile(bar, "missing_directory/CStreamSerializerTest.json"));
+	}
+
+	TEST_F(CStreamSerializerTest, document_serializer_writes_to_ostream_and_files)
+	{
+		CStreamSerializerTestInternal::CBar bar = CStreamSerializerTestInternal::CreateBar();
+
+		std::ostringstream stream;
+		EXPECT_TRUE(DonerSerializer::CJsonSerializer::SerializeToStream(bar, stream, 7));
+		ASSERT_STREQ(CStreamSerializerTestInternal::BAR_JSON_DATA, stream.str().c_str());
+
+		const char* const path = "CStreamSerializerTest_document.json";
+		ASSERT_TRUE(DonerSerializer::CJsonSerializer::SerializeToFile(bar, path, 16));
+
+		std::FILE* file = std::fopen(path, "rb");
+		ASSERT_TRUE(file != nullptr);
+		char buffer[512] = {};
+		const std::size_t read = std::fread(buffer, 1, sizeof(buffer) - 1, file);
+		std::fclose(file);
+		std::remove(path);
+
+		EXPECT_EQ(std::strlen(CStreamSerializerTestInternal::BAR_JSON_DATA), read);
+		ASSERT_STREQ(CStreamSerializerTestInternal::BAR_JSON_DATA, buffer);
+
+		EXPECT_FALSE(DonerSerializer::CJsonSerializer::SerializeToFile(bar, "missing_directory/CStreamSerializerTest.json"));
+	}
+
+	TEST_F(CStreamSerializerTest, parallel_array_matches_sequential_array)
+	{
+		std::vector<CStreamSerializerTestInternal::CBar> bars;
+		for (std::int32_t index = 0; index < 1000; ++index)
+		{
+			CStreamSerializerTestInternal::CBar bar = CStreamSerializerTestInternal::CreateBar();
+			bar.m_foo.m_basic = CStreamSerializerTestInternal::CBasic(index, index % 3 == 0);
+			bar.m_foos.resize(static_cast<std::size_t>(index % 4));
+			bars.push_back(bar);
+		}
+
+		const std::string sequential = DonerSerializer::CJsonStreamSerializer::GetJsonArrayString(bars);
+		ASSERT_EQ(0U, sequential.find("[{\"foos\":[],\"foo\":{\"basic\":{\"bool\":true,\"int32t\":0}}},{"));
+
+		EXPECT_EQ(sequential, DonerSerializer::CJsonStreamSerializer::GetJsonArrayString(bars, 4, 7));
+		EXPECT_EQ(sequential, DonerSerializer::CJsonStreamSerializer::GetJsonArrayString(bars, 0));
+		EXPECT_EQ(sequential, DonerSerializer::CJsonStreamSerializer::GetJsonArrayString(bars, 3, 5000));
+
+		const std::vector<CStreamSerializerTestInternal::CBar> empty;
+		EXPECT_EQ(std::string("[]"), DonerSerializer::CJsonStreamSerializer::GetJsonArrayString(empty, 4));
+	}
+
+	TEST_F(CStreamSerializerTest, parallel_array_bounds_the_ranges_in_flight)
+	{
+		// The first range is slow, so without a bound the other threads would serialize the whole
+		// array before anything could be written
+		std::vector<CStreamSerializerTestInternal::CSlowItem> items(400);
+		items[0].m_delay.m_milliseconds = 200;
+		CStreamSerializerTestInternal::CSlowItem::GetSerialized() = 0;
+
+		std::size_t serializedWhenFirstWritten = 0;
+		std::string result;
+		EXPECT_TRUE(DonerSerializer::CJsonStreamSerializer::SerializeArrayParallel(items, [&](const char* data, std::size_t size)
+		{
+			if (result.size() == 1)
+			{
+				serializedWhenFirstWritten = CStreamSerializerTestInternal::CSlowItem::GetSerialized();
+			}
+			result.append(data, size);
+			return true;
+		}, 4, 1));
+
+		EXPECT_EQ(DonerSerializer::CJsonStreamSerializer::GetJsonArrayString(items), result);
+		EXPECT_GE(4 * DonerSerializer::CJsonStreamSerializer::IN_FLIGHT_RANGES_PER_THREAD, serializedWhenFirstWritten);
+	}
+
+	TEST_F(CStreamSerializerTest, parallel_array_stops_when_the_sink_fails)
+	{
+		std::vector<CStreamSerializerTestInternal::CBar> bars(100, CStreamSerializerTestInternal::CreateBar());
+		std::size_t writes = 0;
+		EXPECT_FALSE(DonerSerializer::CJsonStreamSerializer::SerializeArrayParallel(bars, [&writes](const char*, std::size_t)
+		{
+			return ++writes < 3;
+		}, 4, 1));
+		EXPECT_GT(20U, writes);
+	}
+}
\ No newline at end of file